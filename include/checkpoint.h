@@ -0,0 +1,104 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Background checkpoint writer. Opaque: owns a writer thread and two
+ * snapshot buffers (one being written, one being filled).
+ */
+typedef struct Checkpointer Checkpointer;
+
+/**
+ * Counters describing the cost seen by the training thread.
+ *
+ * - 'submitted':      Snapshots handed to checkpoint_submit().
+ * - 'written':        Snapshots that reached disk.
+ * - 'superseded':     Snapshots replaced by a newer one before the writer
+ *                     picked them up (the writer was still busy).
+ * - 'stall_total_ns': Total time spent inside checkpoint_submit().
+ * - 'stall_max_ns':   Longest single checkpoint_submit() call.
+ */
+typedef struct {
+    long   submitted;
+    long   written;
+    long   superseded;
+    double stall_total_ns;
+    double stall_max_ns;
+} CheckpointStats;
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Create a checkpointer writing to 'path' and start its writer thread.
+ * Each snapshot is written to "<path>.tmp" and renamed over 'path', so a
+ * crash mid-write leaves the previous checkpoint intact.
+ *
+ * @return New checkpointer, or NULL on failure
+ */
+Checkpointer* checkpoint_create(const char *path);
+
+/**
+ * Write any pending snapshot, stop the writer thread and free everything.
+ */
+void checkpoint_free(Checkpointer *c);
+
+/* ------------------------------------------------------------------------- */
+/*                           SAVE / RESTORE                                  */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Snapshot 'count' contiguous tensors into the back buffer and hand it to
+ * the writer thread. Only memory copies happen on the caller's thread; if
+ * the writer is still busy, a not-yet-written older snapshot is replaced.
+ *
+ * @param c        The checkpointer
+ * @param epoch    Training progress to record (e.g. epochs completed)
+ * @param tensors  Tensors to save, in the order checkpoint_load() expects
+ * @param count    Number of tensors
+ * @return         0 on success, -1 on failure
+ */
+int checkpoint_submit(Checkpointer *c, long epoch, Tensor *const *tensors, size_t count);
+
+/**
+ * Block until every submitted snapshot has been written.
+ */
+void checkpoint_flush(Checkpointer *c);
+
+/**
+ * Copy the current counters.
+ */
+void checkpoint_get_stats(Checkpointer *c, CheckpointStats *stats);
+
+/**
+ * Restore a checkpoint into preallocated tensors. The file must hold
+ * exactly 'count' tensors whose dtypes and shapes match.
+ *
+ * Binary format (native byte order):
+ *   "MLCK" | u32 version | i64 epoch | u64 count |
+ *   count x ( u32 dtype | u32 ndim | u64 shape[ndim] | raw data )
+ *
+ * @param path     File written by a Checkpointer
+ * @param epoch    Receives the recorded epoch (may be NULL)
+ * @param tensors  Destination tensors (contiguous)
+ * @param count    Number of tensors
+ * @return         0 on success, -1 if missing, corrupt (including bytes
+ *                 after the last tensor) or mismatched
+ */
+int checkpoint_load(const char *path, long *epoch, Tensor *const *tensors, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHECKPOINT_H */
@@ -0,0 +1,121 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/** Rows per independently decodable block of a column. */
+#define COMPRESS_BLOCK_ROWS 1024
+
+/**
+ * Lossless XOR-compressed columnar storage behind a
+ * TENSOR_LAYOUT_COMPRESSED tensor of shape [rows] or [rows, cols].
+ * Values are float64.
+ *
+ * Each column is cut into blocks of 'block_rows' values. A block stores
+ * its first value raw (8 bytes); every later value is XORed with its
+ * predecessor's bit pattern and stored as one control byte
+ * (trailing zero bytes << 4 | payload bytes) plus the nonzero middle
+ * bytes of the XOR. Neighbouring values of a smooth series share sign,
+ * exponent and high mantissa bits, and prices on a binary tick grid end
+ * in zero bits, so most values shrink to a few bytes; a repeated value
+ * costs one byte. Kernels decode four blocks at a time to overlap their
+ * serial chains, but when the dense data would sit in cache a dense scan
+ * is still faster; the gain is the memory footprint.
+ *
+ * - 'rows', 'cols':  Logical shape (cols = 1 for 1D tensors).
+ * - 'block_rows':    Rows per block.
+ * - 'num_blocks':    Blocks per column.
+ * - 'offsets':       Byte offset of block b of column j at
+ *                    [j * num_blocks + b]; one extra entry holds the total.
+ * - 'bytes':         Encoded stream (padded so decoders may over-read).
+ * - 'num_bytes':     Encoded size, excluding padding.
+ */
+typedef struct {
+    size_t         rows;
+    size_t         cols;
+    size_t         block_rows;
+    size_t         num_blocks;
+    size_t        *offsets;
+    unsigned char *bytes;
+    size_t         num_bytes;
+} CompressedStorage;
+
+/* ------------------------------------------------------------------------- */
+/*                              CONSTRUCTION                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Compress a 1D or 2D strided tensor (any dtype, read as float64).
+ *
+ * @return New compressed tensor (free with tensor_free), or NULL on failure
+ */
+Tensor* tensor_compress(const Tensor *dense);
+
+/**
+ * Expand a compressed tensor into a new contiguous float64 tensor.
+ */
+Tensor* tensor_decompress(const Tensor *c);
+
+/**
+ * Access the storage of a TENSOR_LAYOUT_COMPRESSED tensor (NULL otherwise).
+ */
+const CompressedStorage* tensor_compressed(const Tensor *c);
+
+/**
+ * Decode block 'block' of column 'col' into 'out'.
+ *
+ * @return Number of values written (block_rows, or fewer for the last block)
+ */
+size_t tensor_compressed_decode(const Tensor *c, size_t col, size_t block, double *out);
+
+/**
+ * Decode row block 'block' of every column into 'out', row-major
+ * ([count, cols], leading dimension cols), ready for the kernels in gemv.h.
+ *
+ * @return Number of rows written
+ */
+size_t tensor_compressed_decode_rows(const Tensor *c, size_t block, double *out);
+
+/* ------------------------------------------------------------------------- */
+/*                               KERNELS                                     */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Kernels decode one block at a time into a buffer that stays in L1/L2
+ * and consume it immediately, so the full float64 matrix never exists in
+ * memory. Large inputs are processed block-parallel on the pool from
+ * parallel.h.
+ */
+
+/**
+ * Sum of all elements. Deterministic: blocks are summed in a fixed order
+ * whatever the thread count.
+ */
+double tensor_compressed_sum(const Tensor *c);
+
+/**
+ * Compressed matrix x dense vector: out = A x + bias.
+ * - A: compressed, shape=[M, K]
+ * - x: strided, shape=[K] or [K, 1]
+ * - out: contiguous float64, shape=[M, 1], overwritten
+ *
+ * Each out[i] is 'bias' plus the products in order of k, as in
+ * tensor_gemv(), so results match the uncompressed matrix bit for bit.
+ *
+ * @return 0 on success, -1 on shape mismatch
+ */
+int tensor_compressed_gemv(const Tensor *A, const Tensor *x, double bias, Tensor *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMPRESS_H */
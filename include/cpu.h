@@ -0,0 +1,122 @@
+#ifndef CPU_H
+#define CPU_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Instruction-set levels with their own kernel variants, lowest first.
+ * On non-x86 targets only CPU_LEVEL_SCALAR exists.
+ */
+typedef enum {
+    CPU_LEVEL_SCALAR = 0,
+    CPU_LEVEL_SSE42,      // 128-bit (2 doubles)
+    CPU_LEVEL_AVX2,       // 256-bit (4 doubles)
+    CPU_LEVEL_AVX512,     // 512-bit (8 doubles), AVX-512F
+    CPU_LEVEL_COUNT
+} CpuLevel;
+
+/** Dispatched kernels, for cpu_kernel_ran(). */
+typedef enum {
+    CPU_KERNEL_BINARY = 0,
+    CPU_KERNEL_SUM,
+    CPU_KERNEL_DOT,
+    CPU_KERNEL_GEMM,
+    CPU_KERNEL_CONVERT,
+    CPU_KERNEL_COUNT
+} CpuKernel;
+
+/** Elementwise operation of the binary kernel. */
+typedef enum {
+    CPU_OP_ADD = 0,
+    CPU_OP_SUB,
+    CPU_OP_MUL,
+    CPU_OP_DIV
+} CpuBinaryOp;
+
+/**
+ * One row of the dispatch table: every kernel compiled for 'level'.
+ * All pointers are non-NULL.
+ *
+ * - 'binary_f64':  y[i] = a[i] op b[i], or a[i] op b[0] if 'b_scalar'.
+ * - 'sum_f64':     Sum of x[0..n).
+ * - 'dot_f64':     Sum of x[i] * y[i].
+ * - 'gemm_f64':    C[M, N] = A[M, K] B[K, N], row-major with leading
+ *                  dimensions lda, ldb, ldc (C is overwritten).
+ * - 'f32_to_f64', 'f64_to_f32':  Element conversions.
+ *
+ * Every level returns bit-identical results: reductions keep eight
+ * partial sums in the same lane order whatever the vector width, GEMM
+ * adds the products of each output in order of k as the naive loop does,
+ * and no level contracts a * b + c into a fused multiply-add.
+ */
+typedef struct {
+    CpuLevel level;
+    void   (*binary_f64)(CpuBinaryOp op, const double *a, const double *b, int b_scalar,
+                         double *y, size_t n);
+    double (*sum_f64)(const double *x, size_t n);
+    double (*dot_f64)(const double *x, const double *y, size_t n);
+    void   (*gemm_f64)(size_t M, size_t N, size_t K, const double *A, size_t lda,
+                       const double *B, size_t ldb, double *C, size_t ldc);
+    void   (*f32_to_f64)(const float *x, double *y, size_t n);
+    void   (*f64_to_f32)(const double *x, float *y, size_t n);
+} CpuKernels;
+
+/* ------------------------------------------------------------------------- */
+/*                                DISPATCH                                   */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * On first use the highest level supported by both the CPU and the OS
+ * (cpuid, plus XSAVE state for AVX/AVX-512) is detected and its table
+ * row becomes active. ML_CPU_LEVEL (scalar, sse4.2, avx2 or avx512)
+ * forces a lower level, e.g. to test the fallbacks on a newer machine;
+ * a level the machine lacks is clamped to the detected one.
+ */
+
+/**
+ * Active kernel table.
+ */
+const CpuKernels* cpu_kernels(void);
+
+/**
+ * Highest level the machine supports, ignoring ML_CPU_LEVEL.
+ */
+CpuLevel cpu_detected_level(void);
+
+/**
+ * Level of the active table.
+ */
+CpuLevel cpu_active_level(void);
+
+/**
+ * Switch the active table (for tests and benchmarks). Must not be called
+ * while other threads run tensor kernels.
+ *
+ * @return 0 on success, -1 if the machine does not support 'level'
+ */
+int cpu_set_level(CpuLevel level);
+
+/**
+ * Name of a level as accepted by ML_CPU_LEVEL ("scalar", "sse4.2", ...).
+ */
+const char* cpu_level_name(CpuLevel level);
+
+/**
+ * Level of the variant that most recently ran kernel 'k' on any thread,
+ * or -1 if it has not run yet.
+ */
+int cpu_kernel_ran(CpuKernel k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU_H */
@@ -0,0 +1,104 @@
+#ifndef CV_H
+#define CV_H
+
+#include "tensor.h"
+#include "lr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * How rows are split into folds. Folds are contiguous row ranges, so each
+ * split is a set of slice views over X/y rather than copies.
+ *
+ * - CV_KFOLD:            'folds' equal blocks; fold f tests on block f and
+ *                        trains on the rest. Rows are not shuffled, so
+ *                        shuffle beforehand for i.i.d. data.
+ * - CV_FORWARD_CHAINING: Time-series splits. Rows are cut into folds + 1
+ *                        blocks; fold f trains on blocks 0..f and tests on
+ *                        block f + 1, so training never sees the future.
+ */
+typedef enum {
+    CV_KFOLD,
+    CV_FORWARD_CHAINING
+} CVScheme;
+
+/**
+ * Cross-validation options.
+ *
+ * - 'scheme':       Split scheme.
+ * - 'folds':        Number of folds (>= 2 for k-fold, >= 1 for chaining).
+ * - 'num_threads':  Worker threads; <= 0 uses one per online CPU. Never
+ *                   more than 'folds'.
+ * - 'train':        Per-fold training options. Checkpointing, resuming and
+ *                   verbose output are disabled inside folds.
+ */
+typedef struct {
+    CVScheme    scheme;
+    size_t      folds;
+    int         num_threads;
+    TrainConfig train;
+} CVConfig;
+
+/**
+ * Outcome of one fold.
+ *
+ * - 'train_rows':  Rows trained on.
+ * - 'test_start':  First test row.
+ * - 'test_rows':   Rows evaluated.
+ * - 'train_loss':  Final training MSE.
+ * - 'test_mse':    MSE on the held-out rows.
+ * - 'test_mae':    Mean absolute error on the held-out rows.
+ * - 'epochs_run', 'converged': As in TrainResult.
+ * - 'seconds':     Wall time spent training and evaluating this fold.
+ */
+typedef struct {
+    size_t train_rows;
+    size_t test_start;
+    size_t test_rows;
+    double train_loss;
+    double test_mse;
+    double test_mae;
+    int    epochs_run;
+    int    converged;
+    double seconds;
+} CVFoldResult;
+
+/* ------------------------------------------------------------------------- */
+/*                                 DRIVER                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Default options: the given scheme and fold count, one thread per CPU,
+ * train_default_config() for training.
+ */
+CVConfig cv_default_config(CVScheme scheme, size_t folds);
+
+/**
+ * Cross-validate y_pred = X * W + b. Each fold starts from W = 0, b = 0
+ * and trains with train_linear_regression_parts() on row-slice views of
+ * X and y; folds run concurrently on a pool of worker threads.
+ *
+ * X and y are only read (the views hold references while folds run).
+ *
+ * @param X        Input features, shape = [n, d] (strided)
+ * @param y        Targets, shape = [n, 1] or [n]
+ * @param cfg      Options
+ * @param results  Receives cfg->folds per-fold results
+ * @param coefs    Optional [folds, d + 1] float64 tensor receiving each
+ *                 fold's [W..., b]
+ * @return         0 on success, -1 on invalid input or allocation failure
+ */
+int cross_validate(Tensor *X, Tensor *y, const CVConfig *cfg,
+                   CVFoldResult *results, Tensor *coefs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CV_H */
@@ -0,0 +1,140 @@
+#ifndef ENET_H
+#define ENET_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Elastic-net regression by coordinate descent:
+ *
+ *   minimize  1/(2n) ||y - X w - b||^2
+ *             + lambda * ( alpha ||w||_1 + (1 - alpha)/2 ||w||^2 )
+ *
+ * alpha = 1 is the lasso, alpha = 0 ridge. The intercept b is not
+ * penalized. Features are used as given; standardize them first (see
+ * scaler.h) if the penalty should treat them alike.
+ */
+
+/**
+ * Sufficient statistics of a dataset for the solver, computed once with
+ * two passes over the rows. Every fit afterwards costs O(d^2) per sweep,
+ * independent of n.
+ *
+ * - 'n', 'd':   Rows and features.
+ * - 'G':        [d, d] centered Gram matrix (1/n) Xc^T Xc.
+ * - 'c':        [d, 1] centered covariances (1/n) Xc^T yc.
+ * - 'mean_x':   [d] feature means.
+ * - 'mean_y':   Target mean.
+ * - 'var_y':    (1/n) ||yc||^2, the MSE of the intercept-only model.
+ */
+typedef struct {
+    size_t  n;
+    size_t  d;
+    Tensor *G;
+    Tensor *c;
+    Tensor *mean_x;
+    double  mean_y;
+    double  var_y;
+} ENetGram;
+
+/**
+ * Path options.
+ *
+ * - 'alpha':         L1 share of the penalty in [0, 1].
+ * - 'num_lambdas':   Points on the path when 'lambdas' is NULL.
+ * - 'lambda_ratio':  Smallest / largest lambda when 'lambdas' is NULL.
+ *                    The path runs log-spaced down from lambda_max, the
+ *                    smallest lambda with all weights zero (for ridge,
+ *                    that of alpha = 0.001).
+ * - 'lambdas':       Optional explicit path, largest first.
+ * - 'tol':           A lambda is solved when no sweep moves any weight by
+ *                    more than G_jj * dw^2 > tol * var_y.
+ * - 'max_sweeps':    Upper bound on coordinate sweeps per lambda.
+ */
+typedef struct {
+    double        alpha;
+    size_t        num_lambdas;
+    double        lambda_ratio;
+    const double *lambdas;
+    double        tol;
+    int           max_sweeps;
+} ENetConfig;
+
+/**
+ * One solved point of the path.
+ *
+ * - 'lambda':     Penalty strength.
+ * - 'intercept':  Fitted b.
+ * - 'nonzero':    Nonzero weights.
+ * - 'train_mse':  (1/n) ||y - X w - b||^2, from the Gram matrix.
+ * - 'sweeps':     Coordinate sweeps spent on this lambda.
+ * - 'converged':  0 if max_sweeps ran out.
+ */
+typedef struct {
+    double lambda;
+    double intercept;
+    size_t nonzero;
+    double train_mse;
+    int    sweeps;
+    int    converged;
+} ENetPathPoint;
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Compute the Gram statistics of X ([n, d], strided) and y ([n, 1] or [n]).
+ *
+ * @return New statistics, or NULL on invalid input or allocation failure
+ */
+ENetGram* enet_gram_create(const Tensor *X, const Tensor *y);
+
+/**
+ * Free the statistics.
+ */
+void enet_gram_free(ENetGram *g);
+
+/* ------------------------------------------------------------------------- */
+/*                                 SOLVER                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Default options: the given alpha, 100 lambdas down to 1e-3 * lambda_max,
+ * tol 1e-7, 10000 sweeps per lambda.
+ */
+ENetConfig enet_default_config(double alpha);
+
+/**
+ * Fit the whole regularization path, largest lambda first.
+ *
+ * Each lambda starts from the previous solution (warm start). Sweeps run
+ * over a working set chosen by the sequential strong rule (plus every
+ * weight that is already nonzero); after it converges, the KKT conditions
+ * of the screened-out features are checked and violators are added back,
+ * so the result is exact. Each coordinate update adjusts the covariance
+ * residual c - G w in O(d), so no pass over the rows is ever needed.
+ *
+ * @param g       Statistics from enet_gram_create()
+ * @param cfg     Path options
+ * @param coefs   [L, d + 1]; row k receives the weights at lambda k
+ *                followed by the intercept
+ * @param points  Optional array of L path points
+ * @return        0 on success, -1 on invalid input or allocation failure
+ *
+ * L is cfg->num_lambdas (also when cfg->lambdas is given).
+ */
+int enet_path(const ENetGram *g, const ENetConfig *cfg, Tensor *coefs, ENetPathPoint *points);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENET_H */
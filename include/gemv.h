@@ -0,0 +1,44 @@
+#ifndef GEMV_H
+#define GEMV_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                       MATRIX-VECTOR KERNELS (FLOAT64)                     */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Row-major float64 kernels for the skinny products that dominate linear
+ * models: predictions X*w ([n,d] x [d,1]) and gradients X^T*r
+ * ([d,n] x [n,1]). For inner widths 1..GEMV_SMALL_MAX the loops over the
+ * width are fully unrolled at compile time (one kernel per width,
+ * generated from a macro template) with the vector held in registers.
+ */
+
+/** Widest vector that gets a dedicated unrolled kernel. */
+#define GEMV_SMALL_MAX 16
+
+/**
+ * GEMV: y[i] = bias + sum_j A[i*lda + j] * x[j], for i < m, j < k.
+ * Each row is summed starting from 'bias', in order j = 0..k-1.
+ */
+void gemv_f64(size_t m, size_t k, const double *A, size_t lda,
+              const double *x, double bias, double *y);
+
+/**
+ * GEVM: y[j] += sum_i x[i] * A[i*lda + j], for j < n, i < m.
+ * Accumulates A^T x into y, reading A row by row; each y[j] is updated
+ * in order i = 0..m-1, as a row-at-a-time loop would.
+ */
+void gevm_f64(size_t m, size_t n, const double *A, size_t lda,
+              const double *x, double *y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEMV_H */
@@ -0,0 +1,148 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Streaming data loader. Opaque: owns a background reader thread and a
+ * ring of 'depth' preallocated chunk buffers. While the caller trains on
+ * one chunk, the reader fills the next ones, so I/O and conversion
+ * overlap with compute and only 'depth' chunks are ever in memory.
+ */
+typedef struct DataLoader DataLoader;
+
+/**
+ * Source callback: convert up to 'max_rows' rows, starting at row 'row0'
+ * of the dataset, into float64 buffers X (row-major, max_rows x d) and
+ * y (max_rows). Sets '*rows' to the number of rows written; 0 means the
+ * dataset has ended. Called on the reader thread only.
+ *
+ * @return 0 on success, -1 on failure (reported to the consumer)
+ */
+typedef int (*LoaderFillFn)(void *ctx, size_t row0, size_t max_rows,
+                            double *X, double *y, size_t *rows);
+
+/**
+ * Where rows come from.
+ *
+ * - 'fill':         Row producer (see LoaderFillFn).
+ * - 'close':        Optional; called with 'ctx' by loader_free().
+ * - 'ctx':          Passed to both callbacks.
+ * - 'num_features': Columns of X (d >= 1).
+ */
+typedef struct {
+    LoaderFillFn fill;
+    void       (*close)(void *ctx);
+    void        *ctx;
+    size_t       num_features;
+} LoaderSource;
+
+/**
+ * Counters describing how well loading overlapped with compute.
+ *
+ * - 'chunks':   Chunks handed to the consumer.
+ * - 'rows':     Rows handed to the consumer.
+ * - 'passes':   Completed passes over the dataset.
+ * - 'load_ns':  Time the reader spent inside the source callback.
+ * - 'stall_ns': Time the consumer spent waiting for a chunk.
+ */
+typedef struct {
+    long   chunks;
+    long   rows;
+    long   passes;
+    double load_ns;
+    double stall_ns;
+} LoaderStats;
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Create a loader over 'src' and start its reader thread. The reader
+ * streams the dataset pass after pass (a new pass starts at row 0 right
+ * after the previous one ends), staying at most 'depth' chunks ahead.
+ *
+ * @param src         Row source; copied, its ctx is borrowed (or closed
+ *                    by loader_free() if src->close is set)
+ * @param chunk_rows  Rows per chunk (> 0)
+ * @param depth       Chunk buffers, including the one being consumed
+ *                    (0 means 2: double buffering)
+ * @return            New loader, or NULL on failure
+ */
+DataLoader* loader_create(const LoaderSource *src, size_t chunk_rows, size_t depth);
+
+/**
+ * Create a loader over a dataset file written by loader_write_file().
+ * Records are converted to float64 on the reader thread.
+ *
+ * @return New loader, or NULL if the file is missing or malformed (bad
+ *         header, d above 2^24, or a body that is not whole records)
+ */
+DataLoader* loader_open_file(const char *path, size_t chunk_rows, size_t depth);
+
+/**
+ * Stop the reader thread, close the source and free all chunk buffers.
+ * Chunks returned by loader_next() become invalid.
+ */
+void loader_free(DataLoader *L);
+
+/* ------------------------------------------------------------------------- */
+/*                               ITERATION                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Hand out the next chunk, waiting for the reader if it is not ready yet.
+ * The previous chunk is released back to the reader first, so views from
+ * an earlier call must not be used afterwards.
+ *
+ * @param L  The loader
+ * @param X  Receives a float64 view of shape [rows, d]
+ * @param y  Receives a float64 view of shape [rows, 1]
+ * @return   1 for a chunk, 0 at the end of a pass (the next call starts
+ *           the next pass), -1 if the source failed (sticky)
+ */
+int loader_next(DataLoader *L, const Tensor **X, const Tensor **y);
+
+/**
+ * Number of feature columns per row.
+ */
+size_t loader_num_features(const DataLoader *L);
+
+/**
+ * Copy the current counters.
+ */
+void loader_get_stats(DataLoader *L, LoaderStats *stats);
+
+/* ------------------------------------------------------------------------- */
+/*                               DATASET FILES                               */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Write rows of X ([n, d]) and y ([n, 1] or [n]) as a dataset file, each
+ * value stored as 'dtype' (TENSOR_FLOAT32 or TENSOR_FLOAT64). With
+ * 'append' set and the file present, the rows are added at the end
+ * (header must match), so a large history can be written chunk by chunk.
+ *
+ * Binary format (native byte order):
+ *   "MLDS" | u32 version | u32 dtype | u64 d |
+ *   rows x ( d feature values | target value ), until end of file
+ *
+ * @return 0 on success, -1 on failure
+ */
+int loader_write_file(const char *path, const Tensor *X, const Tensor *y,
+                      TensorDtype dtype, int append);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOADER_H */
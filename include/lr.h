@@ -2,6 +2,143 @@
 #define LR_H
 
 #include "tensor.h"
+#include "optim.h"
+#include "checkpoint.h"
+#include "loader.h"
+
+/**
+ * Training options for train_linear_regression_ex().
+ *
+ * - 'optim':       Optimizer type and hyperparameters.
+ * - 'max_epochs':  Upper bound on full passes over X.
+ * - 'loss_tol':    Stop when the relative loss change between epochs is
+ *                  <= loss_tol (0 disables).
+ * - 'grad_tol':    Stop when the L2 norm of the gradient (W and b) is
+ *                  <= grad_tol (0 disables).
+ * - 'verbose':     If nonzero, prints loss every 100 epochs.
+ * - 'checkpoint':  Optional background writer; W, b and the optimizer
+ *                  state are snapshotted every 'checkpoint_every' epochs
+ *                  and once more when training ends.
+ * - 'checkpoint_every': Snapshot interval in epochs (<= 0 disables).
+ * - 'resume_path': Optional checkpoint to resume from. If the file exists
+ *                  and matches, W, b, the optimizer state and the epoch
+ *                  counter are restored; otherwise training starts fresh.
+ */
+typedef struct {
+    OptimizerConfig optim;
+    int    max_epochs;
+    double loss_tol;
+    double grad_tol;
+    int    verbose;
+    Checkpointer *checkpoint;
+    int    checkpoint_every;
+    const char *resume_path;
+} TrainConfig;
+
+/**
+ * Outcome of a training run.
+ *
+ * - 'epochs_run':  Number of parameter updates performed.
+ * - 'final_loss':  MSE at the returned parameters' last evaluated epoch.
+ * - 'grad_norm':   Gradient norm at that epoch.
+ * - 'converged':   1 if a tolerance was met, 0 if max_epochs ran out
+ *                  or the loss became non-finite.
+ */
+typedef struct {
+    int    epochs_run;
+    double final_loss;
+    double grad_norm;
+    int    converged;
+} TrainResult;
+
+/**
+ * Default TrainConfig: plain SGD (lr=0.01), 1000 epochs, tolerances off,
+ * no checkpointing.
+ */
+TrainConfig train_default_config(void);
+
+/**
+ * Trains y_pred = X * W + b on MSE with a pluggable optimizer and
+ * tolerance-based early stopping. Each epoch is a single fused pass over X
+ * computing the loss and both gradients; all workspace is allocated once.
+ *
+ * @param X       Input features, shape = [n, d] (strided, CSR or compressed)
+ * @param y       Target values, shape = [n, 1]
+ * @param W       Weights, shape = [d, 1] (initialized externally, contiguous)
+ * @param b       Bias, shape = [1] (initialized externally)
+ * @param cfg     Training options
+ * @param result  Optional; receives epochs run, final loss and convergence
+ * @return        0 on success, -1 on invalid input or allocation failure
+ */
+int train_linear_regression_ex(
+    const Tensor *X,
+    const Tensor *y,
+    Tensor *W,
+    Tensor *b,
+    const TrainConfig *cfg,
+    TrainResult *result
+);
+
+/**
+ * Same as train_linear_regression_ex(), but the training rows are the
+ * concatenation of 'num_parts' row blocks, e.g. row-slice views of one
+ * buffer. Lets a training set with a hole in it (a k-fold train split)
+ * be used without copying rows together; loss and gradients are
+ * averaged over the total row count.
+ *
+ * @param X_parts    Row blocks of X, each shape = [n_p, d]
+ * @param y_parts    Matching row blocks of y, each shape = [n_p, 1]
+ * @param num_parts  Number of blocks (>= 1)
+ * @return           0 on success, -1 on invalid input or allocation failure
+ */
+int train_linear_regression_parts(
+    const Tensor *const *X_parts,
+    const Tensor *const *y_parts,
+    size_t num_parts,
+    Tensor *W,
+    Tensor *b,
+    const TrainConfig *cfg,
+    TrainResult *result
+);
+
+/** How train_linear_regression_stream() turns chunks into updates. */
+typedef enum {
+    TRAIN_FULL_BATCH,   // one step per pass, on the gradient over all rows
+    TRAIN_MINI_BATCH,   // one step per chunk, on that chunk's gradient
+} TrainBatching;
+
+/**
+ * Trains y_pred = X * W + b on rows streamed from a DataLoader, so the
+ * dataset never has to fit in memory: the loader reads the next chunks
+ * on its own thread while the current one is being trained on.
+ *
+ * TRAIN_FULL_BATCH gives exactly the updates of train_linear_regression_ex()
+ * on the concatenated rows (the line search re-reads a full pass per
+ * trial). TRAIN_MINI_BATCH steps once per chunk; an epoch is still one
+ * pass, and its loss and gradient norm are the row-weighted means of the
+ * per-chunk values. In both modes 'epochs_run' counts passes, and
+ * checkpointing, resuming and tolerances follow the TrainConfig.
+ *
+ * The loader must be at the start of a pass (fresh, or after
+ * loader_next() returned 0) and is left at one.
+ *
+ * @param loader    Row source; its chunk size is the mini-batch size
+ * @param batching  TRAIN_FULL_BATCH or TRAIN_MINI_BATCH
+ * @param W         Weights, shape = [d, 1] (initialized externally, contiguous)
+ * @param b         Bias, shape = [1] (initialized externally)
+ * @param cfg       Training options
+ * @param result    Optional; receives epochs run, final loss and convergence
+ * @return          0 on success, -1 on invalid input, allocation failure
+ *                  or a loader error
+ */
+int train_linear_regression_stream(
+    DataLoader *loader,
+    TrainBatching batching,
+    Tensor *W,
+    Tensor *b,
+    const TrainConfig *cfg,
+    TrainResult *result
+);
 
 /**
  * Trains a linear regressor of the form y_pred = X * W + b
@@ -14,6 +151,9 @@
  * @param lr       Learning rate (e.g., 0.01)
  * @param epochs   Number of training epochs (e.g., 1000)
  * @param verbose  If nonzero, prints loss every few iterations
+ *
+ * Equivalent to train_linear_regression_ex() with OPTIM_SGD and no
+ * early stopping.
  */
 void train_linear_regression(
     const Tensor *X,
@@ -25,6 +165,54 @@ void train_linear_regression(
     int verbose
 );
 
+/**
+ * Options for train_linear_regression_batched(). Per-model arrays have
+ * length K.
+ *
+ * - 'lr':          Per-model learning rates (plain gradient descent).
+ * - 'l2':          Per-model L2 penalties on W, or NULL for none. The
+ *                  objective is MSE + l2 * ||W_k||^2.
+ * - 'max_epochs':  Upper bound on passes over X.
+ * - 'loss_tol':    Per-model relative loss-change tolerance (0 disables).
+ * - 'grad_tol':    Per-model gradient-norm tolerance (0 disables).
+ * - 'verbose':     If nonzero, prints every 100 epochs.
+ */
+typedef struct {
+    const double *lr;
+    const double *l2;
+    int    max_epochs;
+    double loss_tol;
+    double grad_tol;
+    int    verbose;
+} BatchTrainConfig;
+
+/**
+ * Fits K linear models at once on the same X, e.g. for a learning-rate or
+ * L2 sweep or for several targets. Each epoch is a single pass over X that
+ * forms P = X W + b for all models ([n, d] x [d, K]) and accumulates
+ * X^T R, so X is read once per epoch instead of K times.
+ * Models stop independently; stopped models drop out of the pass.
+ *
+ * @param X             Input features, shape = [n, d]
+ * @param Y             Targets, shape = [n, K], or [n, 1] shared by all models
+ * @param W             Weights, shape = [d, K] (initialized externally)
+ * @param b             Biases, K contiguous elements, e.g. shape = [1, K]
+ * @param cfg           Training options
+ * @param results       Optional array of K per-model results
+ * @param loss_history  Optional, shape = [max_epochs, K]; row e holds each
+ *                      model's loss at epoch e, NaN once the model stopped
+ * @return              0 on success, -1 on invalid input or allocation failure
+ */
+int train_linear_regression_batched(
+    const Tensor *X,
+    const Tensor *Y,
+    Tensor *W,
+    Tensor *b,
+    const BatchTrainConfig *cfg,
+    TrainResult *results,
+    Tensor *loss_history
+);
+
 /**
  * Computes mean squared error (MSE) = mean( (y_pred - y)^2 )
  * @param y_pred shape = [n, 1]
@@ -0,0 +1,110 @@
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Online linear regressor y = x^T W + b fitted by recursive least squares.
+ * Each row is folded in with O(p^2) work, p = d + 1, independent of how
+ * many rows have been seen.
+ *
+ * - 'd':       Number of features.
+ * - 'lambda':  Forgetting factor in (0, 1]. 1 weighs all history equally;
+ *              smaller values discount a row seen k updates ago by lambda^k.
+ * - 'count':   Rows folded in so far.
+ * - 'P':       [p, p] inverse of the (discounted, regularized) Gram matrix.
+ * - 'theta':   [p, 1] coefficients: W followed by b.
+ * - 'z/Pz':    Scratch vectors of length p.
+ */
+typedef struct {
+    size_t  d;
+    double  lambda;
+    size_t  count;
+    Tensor *P;
+    Tensor *theta;
+    double *z;
+    double *Pz;
+} OnlineRLS;
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Create a regressor with theta = 0 and P = delta * I.
+ *
+ * @param d       Number of features
+ * @param lambda  Forgetting factor in (0, 1]
+ * @param delta   Initial P scale; large values (e.g. 1e6) mean a weak prior
+ * @return        New regressor, or NULL on failure
+ */
+OnlineRLS* rls_create(size_t d, double lambda, double delta);
+
+/**
+ * Free the regressor.
+ */
+void rls_free(OnlineRLS *m);
+
+/* ------------------------------------------------------------------------- */
+/*                                UPDATES                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Fold one row into the model.
+ *
+ * @param x  Feature row of length d
+ * @param y  Target
+ * @return   A-priori prediction error y - x^T W - b (before the update)
+ */
+double rls_update(OnlineRLS *m, const double *x, double y);
+
+/**
+ * Fold a micro-batch of rows into the model, in order.
+ *
+ * @param X  shape = [k, d]
+ * @param y  shape = [k, 1]
+ * @return   0 on success, -1 on shape mismatch
+ */
+int rls_update_batch(OnlineRLS *m, const Tensor *X, const Tensor *y);
+
+/**
+ * Predict for one feature row of length d.
+ */
+double rls_predict(const OnlineRLS *m, const double *x);
+
+/**
+ * Copy the current coefficients into W (shape [d, 1], contiguous) and
+ * b (shape [1]), e.g. for use with linear_forward().
+ */
+int rls_get_params(const OnlineRLS *m, Tensor *W, Tensor *b);
+
+/* ------------------------------------------------------------------------- */
+/*                              PERSISTENCE                                  */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Write the full state (d, lambda, count, theta, P) to a binary file in
+ * native byte order. Returns 0 on success, -1 on I/O error.
+ */
+int rls_save(const OnlineRLS *m, const char *path);
+
+/**
+ * Restore a regressor written by rls_save(). Returns NULL on failure,
+ * including a header with d = 0, a d whose state would not fit in memory,
+ * or a file whose length does not match its header.
+ */
+OnlineRLS* rls_load(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ONLINE_H */
@@ -0,0 +1,124 @@
+#ifndef OPTIM_H
+#define OPTIM_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/** Supported update rules. */
+typedef enum {
+    OPTIM_SGD,          // p -= lr * g
+    OPTIM_MOMENTUM,     // v = mu*v + g;  p -= lr * v
+    OPTIM_NESTEROV,     // v = mu*v + g;  p -= lr * (g + mu*v)
+    OPTIM_ADAM,         // bias-corrected first/second moment estimates
+    OPTIM_LINE_SEARCH,  // gradient step with backtracking (Armijo) step size
+} OptimizerType;
+
+/**
+ * Hyperparameters. Fields that do not apply to the chosen type are ignored.
+ *
+ * - 'lr':          Learning rate (initial trial step for OPTIM_LINE_SEARCH).
+ * - 'momentum':    Momentum coefficient mu for OPTIM_MOMENTUM/OPTIM_NESTEROV.
+ * - 'beta1/beta2': Adam moment decay rates.
+ * - 'eps':         Adam denominator guard.
+ * - 'ls_shrink':   Step multiplier after a rejected line-search trial (0..1).
+ * - 'ls_c':        Armijo sufficient-decrease constant.
+ * - 'ls_max_iter': Maximum trials per line-search step.
+ */
+typedef struct {
+    OptimizerType type;
+    double lr;
+    double momentum;
+    double beta1;
+    double beta2;
+    double eps;
+    double ls_shrink;
+    double ls_c;
+    int    ls_max_iter;
+} OptimizerConfig;
+
+/**
+ * Optimizer state. All per-parameter state tensors are allocated once in
+ * optimizer_create() with the same shapes as the parameters, so a step
+ * performs no allocation.
+ *
+ * - 'params':  Parameters being optimized (borrowed, updated in place).
+ * - 'state1':  Velocity (momentum/Nesterov) or first moment (Adam).
+ * - 'state2':  Second moment (Adam) or the step's starting point (line search).
+ * - 'step':    Number of steps taken (drives Adam bias correction).
+ * - 'last_lr': Step size used by the most recent step.
+ */
+typedef struct {
+    OptimizerConfig cfg;
+    size_t   num_params;
+    Tensor **params;
+    Tensor **state1;
+    Tensor **state2;
+    long     step;
+    double   last_lr;
+} Optimizer;
+
+/**
+ * Loss callback used by OPTIM_LINE_SEARCH. Must return the loss at the
+ * current values of the optimizer's parameters.
+ */
+typedef double (*OptimLossFn)(void *ctx);
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Default hyperparameters for the given type
+ * (lr=0.01, momentum=0.9, beta1=0.9, beta2=0.999, eps=1e-8,
+ *  ls_shrink=0.5, ls_c=1e-4, ls_max_iter=30).
+ */
+OptimizerConfig optimizer_default_config(OptimizerType type);
+
+/**
+ * Create an optimizer over 'num_params' parameter tensors.
+ * Parameters must be contiguous; their state is preallocated here.
+ *
+ * @return New optimizer, or NULL on failure
+ */
+Optimizer* optimizer_create(const OptimizerConfig *cfg, Tensor **params, size_t num_params);
+
+/**
+ * Free the optimizer and its state (not the parameters).
+ */
+void optimizer_free(Optimizer *opt);
+
+/**
+ * Zero all state (velocities, moments) and the step counter.
+ */
+void optimizer_reset(Optimizer *opt);
+
+/* ------------------------------------------------------------------------- */
+/*                                 UPDATE                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Apply one update to all parameters.
+ *
+ * @param opt      The optimizer
+ * @param grads    Gradients, one per parameter with matching element counts
+ * @param loss     Loss at the current parameters (used by line search)
+ * @param loss_fn  Loss callback (required for OPTIM_LINE_SEARCH, else NULL)
+ * @param ctx      Passed to loss_fn
+ * @return         0 on success, -1 on failure, 1 if line search found no
+ *                 step with sufficient decrease (parameters left unchanged)
+ */
+int optimizer_step(Optimizer *opt, Tensor *const *grads,
+                   double loss, OptimLossFn loss_fn, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OPTIM_H */
@@ -0,0 +1,67 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/** Loop body over the index range [lo, hi). */
+typedef void (*ParallelForFn)(size_t lo, size_t hi, void *ctx);
+
+/** Reduction body: returns the partial sum over [lo, hi). */
+typedef double (*ParallelReduceFn)(size_t lo, size_t hi, void *ctx);
+
+/* ------------------------------------------------------------------------- */
+/*                                RUNTIME                                    */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * A process-wide pool of worker threads, started on first use. The thread
+ * count is ML_NUM_THREADS if set, else the number of online CPUs; the
+ * calling thread is one of them.
+ *
+ * A parallel call cuts [0, n) into chunks of 'grain' indices and deals
+ * them out as contiguous runs, one per-thread deque each. Threads take
+ * chunks from the back of their own deque and, when it runs dry, steal
+ * from the front of the others'.
+ *
+ * One parallel region runs at a time. A call made from inside a region
+ * body, or while another thread's region is running, runs serially on
+ * the calling thread instead of queueing or oversubscribing.
+ */
+
+/**
+ * Run fn over [0, n) in chunks of 'grain' indices (grain 0 means 1).
+ * Small ranges (n <= grain) run inline. Returns when all chunks are done.
+ */
+void parallel_for(size_t n, size_t grain, ParallelForFn fn, void *ctx);
+
+/**
+ * Sum fn's partials over [0, n). Deterministic: the chunk boundaries
+ * depend only on n and grain, and partials are added in chunk order, so
+ * the result is bit-identical for any thread count or steal pattern.
+ */
+double parallel_reduce_sum(size_t n, size_t grain, ParallelReduceFn fn, void *ctx);
+
+/**
+ * Number of threads parallel calls use (including the caller).
+ */
+int parallel_num_threads(void);
+
+/**
+ * Cap the threads used by later parallel calls (<= 0 restores the pool
+ * size). The pool itself is not resized.
+ */
+void parallel_set_num_threads(int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PARALLEL_H */
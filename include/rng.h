@@ -0,0 +1,85 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Counter-based random generator (Philox4x32-10, Salmon et al. 2011).
+ *
+ * Block number 'counter' under key 'seed' is a fixed function of the two,
+ * so any element of a fill can be computed without the ones before it.
+ * Element i of a fill is taken from block counter + i / 2 (two 64-bit
+ * draws per 128-bit block), which makes the result independent of how
+ * the fill is split across threads. Each fill then advances 'counter'
+ * past the blocks it used.
+ *
+ * - 'seed':     Key; different seeds give independent streams.
+ * - 'counter':  Next unused block.
+ */
+typedef struct {
+    uint64_t seed;
+    uint64_t counter;
+} TensorRng;
+
+/* ------------------------------------------------------------------------- */
+/*                               GENERATOR                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Generator for 'seed', starting at block 0.
+ */
+TensorRng tensor_rng(uint64_t seed);
+
+/**
+ * Raw Philox4x32-10 block: out = philox(counter, key = seed).
+ * The counter words are (low 32 bits, high 32 bits, 0, 0).
+ */
+void tensor_rng_block(uint64_t seed, uint64_t counter, uint32_t out[4]);
+
+/* ------------------------------------------------------------------------- */
+/*                              RANDOM FILLS                                 */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Fills write every element of a strided tensor of any dtype in logical
+ * (row-major) order. Large fills run on the parallel pool and give the
+ * same values for any thread count.
+ */
+
+/**
+ * Uniform values in [lo, hi); each uses a 53-bit draw.
+ *
+ * @return 0 on success, -1 on invalid input
+ */
+int tensor_rand_uniform(Tensor *t, double lo, double hi, TensorRng *rng);
+
+/**
+ * Normal values with the given mean and standard deviation (Box-Muller:
+ * the two draws of a block give one cosine and one sine sample).
+ *
+ * @return 0 on success, -1 on invalid input
+ */
+int tensor_randn(Tensor *t, double mean, double std, TensorRng *rng);
+
+/**
+ * Random permutation of 0 .. n-1 into a 1D tensor of n elements
+ * (Fisher-Yates, one 64-bit draw per step; runs on one thread).
+ *
+ * @return 0 on success, -1 on invalid input (or n too large for int32)
+ */
+int tensor_randperm(Tensor *t, TensorRng *rng);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RNG_H */
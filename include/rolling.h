@@ -0,0 +1,113 @@
+#ifndef ROLLING_H
+#define ROLLING_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Rolling-window options.
+ *
+ * - 'window':   Rows per fit (must be >= 1).
+ * - 'ridge':    L2 penalty added to the weight diagonal (not the bias);
+ *               0 gives plain least squares.
+ * - 'refresh':  Rebuild the window sums from scratch every 'refresh'
+ *               pushes to bound floating-point drift from add/remove
+ *               (0 = never). Rebuilding costs O(window * p^2), so
+ *               refresh = window keeps the total cost linear in n.
+ */
+typedef struct {
+    size_t window;
+    double ridge;
+    size_t refresh;
+} RollingConfig;
+
+/**
+ * Incremental rolling least-squares engine. Keeps the window's sufficient
+ * statistics G = sum z z^T and c = sum z y over augmented rows z = [x, 1],
+ * plus a ring buffer of the rows so the oldest can be subtracted.
+ *
+ * - 'd':       Number of features (p = d + 1 parameters).
+ * - 'filled':  Rows currently in the window (<= window).
+ * - 'head':    Ring-buffer slot the next row will overwrite.
+ * - 'pushes':  Rows pushed since the last rebuild.
+ * - 'ring':    [window, p + 1] rows stored as [x, 1, y].
+ * - 'G/c':     Window sums, [p, p] and [p, 1].
+ * - 'L':       Scratch for the Cholesky factor, [p, p].
+ */
+typedef struct {
+    RollingConfig cfg;
+    size_t  d;
+    size_t  filled;
+    size_t  head;
+    size_t  pushes;
+    Tensor *ring;
+    Tensor *G;
+    Tensor *c;
+    Tensor *L;
+} RollingOLS;
+
+/* ------------------------------------------------------------------------- */
+/*                           INCREMENTAL ENGINE                              */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Default options for the given window: ridge = 0, refresh = window.
+ */
+RollingConfig rolling_default_config(size_t window);
+
+/**
+ * Create an empty engine for 'd' features.
+ */
+RollingOLS* rolling_create(size_t d, const RollingConfig *cfg);
+
+/**
+ * Free the engine.
+ */
+void rolling_free(RollingOLS *r);
+
+/**
+ * Add a row (length d) and target, evicting the oldest row once the window
+ * is full. O(p^2).
+ *
+ * @return 1 if the window is now full, 0 otherwise
+ */
+int rolling_push(RollingOLS *r, const double *x, double y);
+
+/**
+ * Solve for the current window's coefficients. O(p^3), independent of
+ * the window length.
+ *
+ * @param coef  Output of length d + 1: W followed by b
+ * @return      0 on success, -1 if the window is not full or the system is
+ *              singular (e.g. a constant feature with ridge = 0)
+ */
+int rolling_solve(RollingOLS *r, double *coef);
+
+/* ------------------------------------------------------------------------- */
+/*                              BATCH DRIVER                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Fit every full window of a series in one pass.
+ *
+ * @param X    Features, shape = [n, d]
+ * @param y    Targets, shape = [n, 1]
+ * @param cfg  Window options
+ * @return     New tensor of shape [n - window + 1, d + 1]; row t holds
+ *             W then b for rows [t, t + window). Singular windows are
+ *             filled with NaN. NULL on invalid input.
+ */
+Tensor* rolling_regression(const Tensor *X, const Tensor *y, const RollingConfig *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ROLLING_H */
@@ -0,0 +1,118 @@
+#ifndef SCALER_H
+#define SCALER_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/** Supported column scalings: x' = (x - center) / scale. */
+typedef enum {
+    SCALER_ZSCORE,   // center = mean,   scale = standard deviation
+    SCALER_MINMAX,   // center = min,    scale = max - min
+    SCALER_ROBUST,   // center = median, scale = interquartile range
+} ScalerType;
+
+/**
+ * Per-column scaling parameters plus the running statistics used to
+ * compute them.
+ *
+ * - 'd':       Number of columns.
+ * - 'count':   Rows observed so far.
+ * - 'center':  Value subtracted from each column (valid once fitted).
+ * - 'scale':   Value each centered column is divided by (never 0).
+ * - 'mean/m2': Welford accumulators (z-score).
+ * - 'min/max': Running extrema (min-max).
+ * - 'fitted':  Nonzero after scaler_finalize()/scaler_fit().
+ */
+typedef struct {
+    ScalerType type;
+    size_t  d;
+    size_t  count;
+    double *center;
+    double *scale;
+    double *mean;
+    double *m2;
+    double *min;
+    double *max;
+    int     fitted;
+} Scaler;
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Create an unfitted scaler for 'd' columns.
+ */
+Scaler* scaler_create(ScalerType type, size_t d);
+
+/**
+ * Free the scaler.
+ */
+void scaler_free(Scaler *s);
+
+/* ------------------------------------------------------------------------- */
+/*                                FITTING                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Accumulate one row (length d) into the running statistics. Intended to be
+ * called from the same loop that fills X, so no extra pass is needed for
+ * z-score and min-max. O(d) per row.
+ */
+void scaler_observe_row(Scaler *s, const double *row);
+
+/**
+ * Turn the accumulated statistics into center/scale.
+ * SCALER_ROBUST needs order statistics that cannot be streamed, so 'X'
+ * (shape [n, d]) is read once to find the quartiles; other types ignore it
+ * and may pass NULL.
+ *
+ * @return 0 on success, -1 on failure
+ */
+int scaler_finalize(Scaler *s, const Tensor *X);
+
+/**
+ * Convenience: observe every row of X (shape [n, d]) and finalize.
+ */
+int scaler_fit(Scaler *s, const Tensor *X);
+
+/* ------------------------------------------------------------------------- */
+/*                              TRANSFORMS                                   */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Scale X (shape [n, d]) in place: x' = (x - center) / scale.
+ */
+int scaler_transform(const Scaler *s, Tensor *X);
+
+/**
+ * Undo scaler_transform() in place: x = x' * scale + center.
+ */
+int scaler_inverse_transform(const Scaler *s, Tensor *X);
+
+/**
+ * Map parameters learned on scaled data back to original units, in place,
+ * so that linear_forward() can be applied to raw X:
+ *
+ *   W_j <- sy * W_j / sx_j
+ *   b   <- sy * (b - sum_j W_j * cx_j / sx_j) + cy
+ *
+ * @param xs  Scaler used on X (d columns)
+ * @param ys  Scaler used on y (1 column), or NULL if y was not scaled
+ * @param W   Weights, shape = [d, 1] (contiguous)
+ * @param b   Bias, shape = [1]
+ */
+int scaler_unscale_params(const Scaler *xs, const Scaler *ys, Tensor *W, Tensor *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCALER_H */
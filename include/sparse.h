@@ -0,0 +1,94 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                          DATA TYPES & STRUCTS                             */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Compressed sparse row storage behind a TENSOR_LAYOUT_CSR tensor of
+ * shape [rows, cols]. Values are float64.
+ *
+ * - 'nnz':      Number of stored entries.
+ * - 'indptr':   Row start offsets into indices/values (length rows + 1).
+ * - 'indices':  Column index per entry, ascending within each row.
+ * - 'values':   Value per entry.
+ */
+typedef struct {
+    size_t  nnz;
+    size_t *indptr;
+    size_t *indices;
+    double *values;
+} CSRStorage;
+
+/* ------------------------------------------------------------------------- */
+/*                              CONSTRUCTION                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Build a CSR tensor from a 2D strided tensor, keeping the nonzero entries.
+ *
+ * @return New CSR tensor (free with tensor_free), or NULL on failure
+ */
+Tensor* tensor_csr_from_dense(const Tensor *dense);
+
+/**
+ * Build a CSR tensor of shape [rows, cols] from coordinate lists.
+ * Entries may be in any order; duplicates are summed.
+ *
+ * @param rows, cols  Shape
+ * @param nnz         Number of coordinates
+ * @param row_idx     Row of each entry
+ * @param col_idx     Column of each entry
+ * @param values      Value of each entry
+ * @return            New CSR tensor, or NULL on invalid input
+ */
+Tensor* tensor_csr_from_coo(size_t rows, size_t cols, size_t nnz,
+                            const size_t *row_idx, const size_t *col_idx,
+                            const double *values);
+
+/**
+ * Expand a CSR tensor into a new dense float64 tensor.
+ */
+Tensor* tensor_csr_to_dense(const Tensor *sp);
+
+/**
+ * Access the CSR arrays of a TENSOR_LAYOUT_CSR tensor (NULL otherwise).
+ */
+const CSRStorage* tensor_csr(const Tensor *sp);
+
+/* ------------------------------------------------------------------------- */
+/*                               KERNELS                                     */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Sparse x dense: out = A * B.
+ * - A: CSR, shape=[M, K]
+ * - B: strided, shape=[K, N]  (N = 1 is SpMV)
+ * - out: contiguous float64, shape=[M, N], overwritten
+ *
+ * @return 0 on success, -1 on shape mismatch
+ */
+int tensor_spmm(const Tensor *A, const Tensor *B, Tensor *out);
+
+/**
+ * Transposed sparse x dense: out = A^T * R, without forming A^T.
+ * - A: CSR, shape=[M, K]
+ * - R: strided, shape=[M, N]
+ * - out: contiguous float64, shape=[K, N], overwritten
+ *
+ * @return 0 on success, -1 on shape mismatch
+ */
+int tensor_spmm_t(const Tensor *A, const Tensor *R, Tensor *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPARSE_H */
@@ -19,6 +19,51 @@ typedef enum {
     // Extend as needed...
 } TensorDtype;
 
+/** Alignment in bytes of every buffer allocated by tensor_create_ex(). */
+#define TENSOR_ALIGNMENT 64
+
+/** Allocation policy flags for tensor_create_ex(). */
+enum {
+    TENSOR_ALLOC_ZERO        = 1 << 0,  /* zero-fill (tensor_create's default) */
+    TENSOR_ALLOC_HUGEPAGE    = 1 << 1,  /* huge pages for buffers >= 2 MiB (Linux) */
+    TENSOR_ALLOC_FIRST_TOUCH = 1 << 2,  /* zero-fill split over threads (NUMA placement) */
+};
+
+/** How a tensor's data buffer was obtained (decides how it is released). */
+typedef enum {
+    TENSOR_BUFFER_NONE,     // no owned buffer: views, non-strided layouts
+    TENSOR_BUFFER_HEAP,     // posix_memalign
+    TENSOR_BUFFER_MAPPED,   // anonymous mmap (huge pages)
+} TensorBufferKind;
+
+/** Elementwise unary operations for tensor_unary(). */
+typedef enum {
+    TENSOR_OP_ABS,
+    TENSOR_OP_NEG,
+    TENSOR_OP_SQUARE,
+    TENSOR_OP_SQRT,
+    TENSOR_OP_EXP,
+    TENSOR_OP_LOG,
+    TENSOR_OP_SIGMOID,   // 1 / (1 + exp(-x))
+    TENSOR_OP_TANH,
+} TensorUnaryOp;
+
+/**
+ * Storage layouts. Strided tensors keep elements in 'data' addressed through
+ * 'strides'; other layouts keep a layout-specific representation in
+ * 'storage' and leave 'data' NULL.
+ */
+typedef enum {
+    TENSOR_LAYOUT_STRIDED,
+    TENSOR_LAYOUT_CSR,      // 2D compressed sparse rows, see sparse.h
+    TENSOR_LAYOUT_COMPRESSED,   // XOR-encoded float64 column blocks, see compress.h
+} TensorLayout;
+
+/** Layout flags kept in Tensor::flags. */
+enum {
+    TENSOR_FLAG_C_CONTIGUOUS = 1 << 0,  /* row-major, no gaps: flat loops allowed */
+};
+
 /**
  * The main Tensor structure.
  *
@@ -31,8 +76,18 @@ typedef enum {
  * - 'owner':      If 1, this tensor is considered the 'owner' of the data buffer.
  *                 If 0, it means the data pointer is shared from another tensor.
  * - 'num_elems':  Total number of elements (product of shape).
+ * - 'flags':      Layout flags (TENSOR_FLAG_*), recomputed whenever the
+ *                 shape or strides change.
+ * - 'base':       For views, the owning tensor whose buffer is referenced.
+ *                 A view holds a reference on 'base', so the buffer stays
+ *                 alive until both the owner and all views are freed.
+ * - 'layout':     Storage layout (TENSOR_LAYOUT_*).
+ * - 'storage':    Layout-specific representation for non-strided layouts,
+ *                 owned by the tensor and released with 'storage_free'.
+ * - 'buffer_kind', 'buffer_bytes': How 'data' was allocated and its mapped
+ *                 size, for owners; TENSOR_BUFFER_NONE otherwise.
  */
-typedef struct {
+typedef struct Tensor {
     size_t      ndim;
     size_t     *shape;
     size_t     *strides;
@@ -41,6 +96,13 @@ typedef struct {
     int         ref_count;  
     int         owner;      
     size_t      num_elems;  
+    int         flags;
+    struct Tensor *base;
+    TensorLayout layout;
+    void       *storage;
+    void      (*storage_free)(void *storage);
+    TensorBufferKind buffer_kind;
+    size_t      buffer_bytes;
 } Tensor;
 
 /* ------------------------------------------------------------------------- */
@@ -58,8 +120,33 @@ typedef struct {
  */
 Tensor* tensor_create(size_t ndim, const size_t *shape, TensorDtype dtype);
 
+/**
+ * Like tensor_create(), but the contents are left uninitialized. For
+ * outputs that are about to be fully written.
+ */
+Tensor* tensor_empty(size_t ndim, const size_t *shape, TensorDtype dtype);
+
+/**
+ * Create a tensor with an explicit allocation policy. The buffer is always
+ * TENSOR_ALIGNMENT-aligned; 'alloc_flags' is a mask of TENSOR_ALLOC_*:
+ *
+ * - TENSOR_ALLOC_ZERO:        zero the buffer.
+ * - TENSOR_ALLOC_HUGEPAGE:    back buffers of 2 MiB or more with huge pages:
+ *                             explicit (MAP_HUGETLB) when the system has a
+ *                             reserved pool, else transparent (MADV_HUGEPAGE).
+ *                             Falls back to the heap elsewhere.
+ * - TENSOR_ALLOC_FIRST_TOUCH: zero the buffer from one thread per CPU, each
+ *                             taking an equal contiguous share, so pages are
+ *                             placed on the NUMA node of the thread that will
+ *                             process them under the same static split.
+ *
+ * @return New tensor, or NULL on failure
+ */
+Tensor* tensor_create_ex(size_t ndim, const size_t *shape, TensorDtype dtype, int alloc_flags);
+
 /**
  * Free a Tensor. Decrements the reference count. If it reaches zero, data is deallocated.
+ * Freeing a view releases its reference on the owning tensor instead.
  */
 void tensor_free(Tensor *t);
 
@@ -78,9 +165,60 @@ Tensor* tensor_copy(const Tensor *src);
 /**
  * Reshape a tensor in-place (if contiguous and the total number of elements
  * remains the same). Returns 0 on success, -1 on failure.
+ * Non-contiguous tensors are rejected; use tensor_view_reshape() or
+ * tensor_contiguous() instead.
  */
 int tensor_reshape(Tensor *t, size_t ndim, const size_t *new_shape);
 
+/**
+ * Returns 1 if the tensor is laid out row-major without gaps, so its
+ * elements can be visited with a flat loop over offsets [0, num_elems).
+ */
+int tensor_is_contiguous(const Tensor *t);
+
+/**
+ * Return a contiguous tensor with the same contents as 't'.
+ * If 't' is already contiguous, this is a view (no copy); otherwise the
+ * data is copied into a new owning tensor. Either way the result must be
+ * released with tensor_free().
+ */
+Tensor* tensor_contiguous(Tensor *t);
+
+/**
+ * Create a reshaped view of 't' without copying. Works for contiguous
+ * tensors and for strided views whose layout can express the new shape
+ * (e.g. splitting or merging dimensions that are laid out contiguously).
+ * Returns NULL if the reshape would require a copy.
+ */
+Tensor* tensor_view_reshape(Tensor *t, size_t ndim, const size_t *new_shape);
+
+/**
+ * Broadcast 't' to a larger shape as a view. Dimensions of size 1 (and
+ * missing leading dimensions) get stride 0, so no data is replicated.
+ * The view should be treated as read-only: its elements alias each other.
+ *
+ * Example: shape=[1,3] expanded to [4,3] => strides=[0,1]
+ */
+Tensor* tensor_expand(Tensor *t, size_t ndim, const size_t *new_shape);
+
+/**
+ * Remove dimension 'dim' (which must have size 1) as a view.
+ * If 'dim' is negative, all size-1 dimensions are removed.
+ */
+Tensor* tensor_squeeze(Tensor *t, int dim);
+
+/**
+ * Insert a new dimension of size 1 at position 'dim' (0 <= dim <= ndim)
+ * as a view.
+ */
+Tensor* tensor_unsqueeze(Tensor *t, size_t dim);
+
+/**
+ * Swap the two dimensions of a 2D tensor as a view (strides swapped,
+ * no copy). shape=[M,N] => shape=[N,M].
+ */
+Tensor* tensor_transpose(Tensor *t);
+
 /**
  * Create a sliced 'view' of an existing tensor. The returned tensor
  * shares the underlying data (no copy). 
@@ -90,6 +228,8 @@ int tensor_reshape(Tensor *t, size_t ndim, const size_t *new_shape);
  * @param end        Array of end indices (exclusive) for each dimension
  * @return           A new Tensor that references the same data
  *
+ * The view keeps the source buffer alive; free it with tensor_free().
+ *
  * Example: For a 2D tensor shape=[4,5], slicing rows [1..3) and columns [0..4)
  *          => new shape=[2,4] (rows=3-1=2, cols=4-0=4)
  */
@@ -105,10 +245,16 @@ void tensor_print(const Tensor *t, const char *name);
 /*                     LOW-LEVEL OFFSET-BASED ACCESS                         */
 /* ------------------------------------------------------------------------- */
 
+/**
+ * Size in bytes of one element of the given dtype (0 if unsupported).
+ */
+size_t tensor_dtype_size(TensorDtype dtype);
+
 /**
  * Read an element from the tensor at a given linear 'offset' (row-major),
  * and return it as a double. 
- * No bounds checking is performed.
+ * No bounds or layout checking is performed; 't' must be strided
+ * (asserted in debug builds).
  *
  * @param t       The tensor (must not be NULL)
  * @param offset  The zero-based element index into the underlying array
@@ -119,6 +265,7 @@ double tensor_read_at_offset(const Tensor *t, size_t offset);
 /**
  * Write a double value into the tensor at a given linear 'offset' (row-major),
  * casting to the tensor’s dtype. No bounds checking is performed.
+ * 't' must be strided (asserted in debug builds).
  *
  * @param t       The tensor (must not be NULL)
  * @param offset  The zero-based element index
@@ -135,13 +282,14 @@ void tensor_write_at_offset(Tensor *t, size_t offset, double value);
  *
  * @param t        The tensor
  * @param indices  Array of length t->ndim
- * @return         The element value cast to double
+ * @return         The element value cast to double (0.0 for a NULL or
+ *                 non-strided tensor)
  */
 double tensor_get(const Tensor *t, const size_t *indices);
 
 /**
  * Set an element in the tensor (the value is provided as double, 
- * then cast to the tensor's dtype).
+ * then cast to the tensor's dtype). Non-strided tensors are left unchanged.
  *
  * @param t        The tensor
  * @param indices  Indices array
@@ -155,6 +303,9 @@ void tensor_set(Tensor *t, const size_t *indices, double value);
  *
  * Broadcasting rules: 
  * - If shapes differ in a dimension, one of them must have size 1 or the same size as the other.
+ *
+ * Contiguous float64 operands of equal size, or with a scalar 'b', run
+ * the dispatched binary kernel from cpu.h (this holds for all four ops).
  */
 Tensor* tensor_add(const Tensor *a, const Tensor *b);
 
@@ -173,12 +324,100 @@ Tensor* tensor_mul(const Tensor *a, const Tensor *b);
  */
 Tensor* tensor_div(const Tensor *a, const Tensor *b);
 
+/* ------------------------------------------------------------------------- */
+/*                          ELEMENTWISE UNARY OPS                            */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Element-wise out = op(t). Float tensors keep their dtype; integer
+ * tensors produce float64. Evaluated with the SIMD kernels in vmath.h
+ * (see there for error bounds), directly on the data when it is
+ * contiguous float64 and through a small double buffer otherwise.
+ *
+ * Returns a new allocated tensor with the result.
+ */
+Tensor* tensor_unary(const Tensor *t, TensorUnaryOp op);
+
+/**
+ * In-place t = op(t). Integer tensors store the result truncated.
+ *
+ * @return 0 on success, -1 on invalid input
+ */
+int tensor_unary_inplace(Tensor *t, TensorUnaryOp op);
+
+/**
+ * out = op(t) into a preallocated tensor of the same shape (any dtype and
+ * strides). 'out' may be 't' itself but must not otherwise overlap it.
+ *
+ * @return 0 on success, -1 on invalid input or shape mismatch
+ */
+int tensor_unary_out(const Tensor *t, TensorUnaryOp op, Tensor *out);
+
+/* ------------------------------------------------------------------------- */
+/*                        GATHER, SCATTER & JOIN                             */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Row operations index dimension 0. Index tensors are 1D of any dtype
+ * (int32, as from tensor_randperm(), is read directly). When source and
+ * destination share a dtype and their rows are contiguous, each row is
+ * one memcpy (or one vector add); the rows of upcoming indices are
+ * prefetched so random patterns overlap their cache misses. Large
+ * gathers run on the parallel pool.
+ */
+
+/**
+ * Gather rows: out[k, ...] = src[indices[k], ...].
+ *
+ * If the indices are a contiguous ascending range (k0, k0+1, ...), the
+ * result is a zero-copy view of src, as from tensor_slice(); otherwise a
+ * new contiguous tensor with src's dtype.
+ *
+ * @return New tensor or view, or NULL on invalid input or an index out of range
+ */
+Tensor* tensor_index_select(Tensor *src, const Tensor *indices);
+
+/**
+ * Gather rows into a preallocated 'out' of shape [len(indices), src->shape[1..]]
+ * (any dtype and strides), e.g. one mini-batch buffer reused every step.
+ *
+ * @return 0 on success, -1 on invalid input, shape mismatch or an index out of range
+ */
+int tensor_index_select_out(const Tensor *src, const Tensor *indices, Tensor *out);
+
+/**
+ * Scatter-add rows: dst[indices[k], ...] += src[k, ...]. Repeated indices
+ * accumulate, in order of k.
+ *
+ * @return 0 on success, -1 on invalid input, shape mismatch or an index out of range
+ */
+int tensor_scatter_add(Tensor *dst, const Tensor *indices, const Tensor *src);
+
+/**
+ * Concatenate 'count' tensors along an existing dimension 'dim'. All must
+ * have the same ndim and equal sizes except along 'dim'.
+ *
+ * Returns a new contiguous tensor with the first tensor's dtype.
+ */
+Tensor* tensor_concat(const Tensor *const *ts, size_t count, size_t dim);
+
+/**
+ * Stack 'count' tensors of identical shape along a new dimension 'dim'
+ * (0 .. ndim): the result has shape[dim] = count.
+ *
+ * Returns a new contiguous tensor with the first tensor's dtype.
+ */
+Tensor* tensor_stack(const Tensor *const *ts, size_t count, size_t dim);
+
 /* ------------------------------------------------------------------------- */
 /*                       REDUCTIONS & LINEAR ALGEBRA                         */
 /* ------------------------------------------------------------------------- */
 
 /**
  * Sum all elements in the tensor, returned as double.
+ * CSR and compressed tensors are summed from their own storage; contiguous
+ * float64 goes through the dispatched kernel from cpu.h (eight interleaved
+ * partial sums, the same on every instruction-set level).
  */
 double tensor_sum(const Tensor *t);
 
@@ -199,10 +438,33 @@ double tensor_dot(const Tensor *v1, const Tensor *v2);
  * - B: shape=[K, N]
  * - out: shape=[M, N]
  *
+ * A may be a TENSOR_LAYOUT_CSR tensor, in which case the sparse kernel
+ * from sparse.h is used, or a TENSOR_LAYOUT_COMPRESSED one (N == 1 is
+ * decoded block by block; other shapes decompress A first). Float64
+ * matrix-vector shapes (N == 1, or M == 1) go through tensor_gemv's
+ * kernels, and other float64 products with unit-stride rows through the
+ * dispatched GEMM kernel from cpu.h, instead of the triple loop.
+ *
  * Returns a new allocated tensor with the result.
  */
 Tensor* tensor_matmul(const Tensor *A, const Tensor *B);
 
+/**
+ * Float64 matrix-vector product plus a scalar: out = A x + bias
+ * - A: shape=[M, K], float64, strided or compressed (compress.h)
+ * - x: shape=[K] or [K, 1], float64
+ * - out: shape=[M, 1]
+ *
+ * Uses the kernels from gemv.h (unrolled for K <= GEMV_SMALL_MAX) when A
+ * has contiguous rows, or contiguous columns as with a tensor_transpose()
+ * view (X^T r without materializing X^T). Large products run on the
+ * parallel pool. Each out[i] is 'bias' plus the products in order of k,
+ * whichever path is taken.
+ *
+ * Returns NULL on dtype/shape mismatch.
+ */
+Tensor* tensor_gemv(const Tensor *A, const Tensor *x, double bias);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,48 @@
+#ifndef VMATH_H
+#define VMATH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*                        VECTORIZED DOUBLE KERNELS                          */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Elementwise y[i] = f(x[i]) over n doubles, processed VMATH_WIDTH lanes at a
+ * time with GCC/Clang vector extensions (lowered to whatever SIMD the target
+ * enables). x and y may be the same array but must not otherwise overlap.
+ *
+ * Accuracy relative to the correctly rounded result, measured over
+ * [-700, 700] (exp), (0, 1e300] (log) and [-40, 40] (sigmoid, tanh):
+ *
+ *   abs, neg, square, sqrt  exact / correctly rounded
+ *   exp      rel. error < 1e-15; subnormal results lose relative precision
+ *   log      rel. error < 1e-15 (abs. error < 3e-16 near x = 1)
+ *   sigmoid  rel. error < 2e-15
+ *   tanh     rel. error < 4e-15
+ *
+ * IEEE special cases follow libm: exp(-inf) = 0, exp(+inf) = inf,
+ * log(0) = -inf, log(x < 0) = NaN, NaN in -> NaN out.
+ */
+
+/** Doubles per vector step: 128-bit lanes, native on x86-64 (SSE2) and AArch64. */
+#define VMATH_WIDTH 2
+
+void vmath_abs(const double *x, double *y, size_t n);
+void vmath_neg(const double *x, double *y, size_t n);
+void vmath_square(const double *x, double *y, size_t n);
+void vmath_sqrt(const double *x, double *y, size_t n);
+void vmath_exp(const double *x, double *y, size_t n);
+void vmath_log(const double *x, double *y, size_t n);
+void vmath_sigmoid(const double *x, double *y, size_t n);
+void vmath_tanh(const double *x, double *y, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VMATH_H */
@@ -0,0 +1,328 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "checkpoint.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#define CHECKPOINT_VERSION 1u
+
+/** File header magic. */
+static const char CKPT_MAGIC[4] = { 'M', 'L', 'C', 'K' };
+
+/** One serialized snapshot, ready to be written with a single fwrite. */
+typedef struct {
+    char  *buf;
+    size_t cap;
+    size_t len;
+} Snapshot;
+
+struct Checkpointer {
+    char           *path;
+    char           *tmp_path;
+    Snapshot        slots[2];
+    int             pending;   // slot waiting to be written, or -1
+    int             writing;   // slot the writer is writing, or -1
+    int             stop;
+    CheckpointStats stats;
+    pthread_mutex_t lock;
+    pthread_cond_t  work;      // writer waits for a pending slot
+    pthread_cond_t  idle;      // flush waits for pending == writing == -1
+    pthread_t       thread;
+};
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/** Bytes needed to serialize the given tensors. */
+static size_t snapshot_size(Tensor *const *tensors, size_t count) {
+    size_t total = sizeof(CKPT_MAGIC) + sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint64_t);
+    for (size_t i = 0; i < count; i++) {
+        total += 2 * sizeof(uint32_t) + tensors[i]->ndim * sizeof(uint64_t);
+        total += tensors[i]->num_elems * tensor_dtype_size(tensors[i]->dtype);
+    }
+    return total;
+}
+
+static char* put(char *p, const void *src, size_t n) {
+    memcpy(p, src, n);
+    return p + n;
+}
+
+/** Serialize into 'snap', growing its buffer if the layout changed. */
+static int snapshot_fill(Snapshot *snap, long epoch, Tensor *const *tensors, size_t count) {
+    size_t need = snapshot_size(tensors, count);
+    if (need > snap->cap) {
+        char *grown = (char*)realloc(snap->buf, need);
+        if (!grown) return -1;
+        snap->buf = grown;
+        snap->cap = need;
+    }
+
+    uint32_t version = CHECKPOINT_VERSION;
+    int64_t epoch64 = (int64_t)epoch;
+    uint64_t count64 = (uint64_t)count;
+    char *p = snap->buf;
+    p = put(p, CKPT_MAGIC, sizeof(CKPT_MAGIC));
+    p = put(p, &version, sizeof(version));
+    p = put(p, &epoch64, sizeof(epoch64));
+    p = put(p, &count64, sizeof(count64));
+    for (size_t i = 0; i < count; i++) {
+        const Tensor *t = tensors[i];
+        uint32_t dtype = (uint32_t)t->dtype;
+        uint32_t ndim = (uint32_t)t->ndim;
+        p = put(p, &dtype, sizeof(dtype));
+        p = put(p, &ndim, sizeof(ndim));
+        for (size_t k = 0; k < t->ndim; k++) {
+            uint64_t dim = (uint64_t)t->shape[k];
+            p = put(p, &dim, sizeof(dim));
+        }
+        p = put(p, t->data, t->num_elems * tensor_dtype_size(t->dtype));
+    }
+    snap->len = need;
+    return 0;
+}
+
+/** Write one snapshot to tmp_path and atomically rename it over path. */
+static int write_snapshot(const Checkpointer *c, const Snapshot *snap) {
+    FILE *f = fopen(c->tmp_path, "wb");
+    if (!f) {
+        fprintf(stderr, "[checkpoint] cannot open %s.\n", c->tmp_path);
+        return -1;
+    }
+    int ok = fwrite(snap->buf, 1, snap->len, f) == snap->len;
+    if (fclose(f) != 0) ok = 0;
+    if (!ok || rename(c->tmp_path, c->path) != 0) {
+        fprintf(stderr, "[checkpoint] failed to write %s.\n", c->path);
+        return -1;
+    }
+    return 0;
+}
+
+/** Writer thread: take the pending slot, write it without holding the lock. */
+static void* writer_main(void *arg) {
+    Checkpointer *c = (Checkpointer*)arg;
+    pthread_mutex_lock(&c->lock);
+    for (;;) {
+        while (c->pending < 0 && !c->stop) {
+            pthread_cond_wait(&c->work, &c->lock);
+        }
+        if (c->pending < 0 && c->stop) break;
+
+        c->writing = c->pending;
+        c->pending = -1;
+        pthread_mutex_unlock(&c->lock);
+
+        int rc = write_snapshot(c, &c->slots[c->writing]);
+
+        pthread_mutex_lock(&c->lock);
+        if (rc == 0) c->stats.written++;
+        c->writing = -1;
+        pthread_cond_broadcast(&c->idle);
+    }
+    pthread_mutex_unlock(&c->lock);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+Checkpointer* checkpoint_create(const char *path) {
+    if (!path) return NULL;
+    Checkpointer *c = (Checkpointer*)calloc(1, sizeof(Checkpointer));
+    if (!c) return NULL;
+
+    size_t len = strlen(path);
+    c->path = (char*)malloc(len + 1);
+    c->tmp_path = (char*)malloc(len + 5);
+    if (!c->path || !c->tmp_path) {
+        free(c->path);
+        free(c->tmp_path);
+        free(c);
+        return NULL;
+    }
+    memcpy(c->path, path, len + 1);
+    memcpy(c->tmp_path, path, len);
+    memcpy(c->tmp_path + len, ".tmp", 5);
+
+    c->pending = -1;
+    c->writing = -1;
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->work, NULL);
+    pthread_cond_init(&c->idle, NULL);
+    if (pthread_create(&c->thread, NULL, writer_main, c) != 0) {
+        fprintf(stderr, "[checkpoint_create] failed to start writer thread.\n");
+        pthread_mutex_destroy(&c->lock);
+        pthread_cond_destroy(&c->work);
+        pthread_cond_destroy(&c->idle);
+        free(c->path);
+        free(c->tmp_path);
+        free(c);
+        return NULL;
+    }
+    return c;
+}
+
+void checkpoint_free(Checkpointer *c) {
+    if (!c) return;
+    pthread_mutex_lock(&c->lock);
+    c->stop = 1;
+    pthread_cond_signal(&c->work);
+    pthread_mutex_unlock(&c->lock);
+    pthread_join(c->thread, NULL);
+
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->work);
+    pthread_cond_destroy(&c->idle);
+    free(c->slots[0].buf);
+    free(c->slots[1].buf);
+    free(c->path);
+    free(c->tmp_path);
+    free(c);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           SAVE / RESTORE                                  */
+/* ------------------------------------------------------------------------- */
+
+int checkpoint_submit(Checkpointer *c, long epoch, Tensor *const *tensors, size_t count) {
+    if (!c || !tensors) return -1;
+    for (size_t i = 0; i < count; i++) {
+        if (!tensors[i] || !tensor_is_contiguous(tensors[i])) {
+            fprintf(stderr, "[checkpoint_submit] tensor %zu must be contiguous.\n", i);
+            return -1;
+        }
+    }
+
+    double t0 = now_ns();
+    pthread_mutex_lock(&c->lock);
+
+    // Fill the slot the writer is not using. A pending (not yet picked up)
+    // snapshot is simply superseded by this newer one.
+    int slot;
+    if (c->pending >= 0) {
+        slot = c->pending;
+        c->pending = -1;
+        c->stats.superseded++;
+    } else {
+        slot = (c->writing == 0) ? 1 : 0;
+    }
+    int rc = snapshot_fill(&c->slots[slot], epoch, tensors, count);
+    if (rc == 0) {
+        c->pending = slot;
+        c->stats.submitted++;
+        pthread_cond_signal(&c->work);
+    }
+
+    double stall = now_ns() - t0;
+    c->stats.stall_total_ns += stall;
+    if (stall > c->stats.stall_max_ns) c->stats.stall_max_ns = stall;
+    pthread_mutex_unlock(&c->lock);
+    return rc;
+}
+
+void checkpoint_flush(Checkpointer *c) {
+    if (!c) return;
+    pthread_mutex_lock(&c->lock);
+    while (c->pending >= 0 || c->writing >= 0) {
+        pthread_cond_wait(&c->idle, &c->lock);
+    }
+    pthread_mutex_unlock(&c->lock);
+}
+
+void checkpoint_get_stats(Checkpointer *c, CheckpointStats *stats) {
+    if (!c || !stats) return;
+    pthread_mutex_lock(&c->lock);
+    *stats = c->stats;
+    pthread_mutex_unlock(&c->lock);
+}
+
+/** Bounds-checked reader over an in-memory file. */
+typedef struct {
+    const char *p;
+    const char *end;
+} Reader;
+
+static int take(Reader *r, void *dst, size_t n) {
+    if ((size_t)(r->end - r->p) < n) return 0;
+    if (dst) memcpy(dst, r->p, n);
+    r->p += n;
+    return 1;
+}
+
+/**
+ * Walk the file and check it against 'tensors'. With copy = 0 nothing is
+ * written, so a mismatch leaves the destinations untouched.
+ */
+static int parse_snapshot(Reader r, long *epoch, Tensor *const *tensors, size_t count, int copy) {
+    char magic[4];
+    uint32_t version = 0;
+    int64_t epoch64 = 0;
+    uint64_t count64 = 0;
+    if (!take(&r, magic, sizeof(magic)) || memcmp(magic, CKPT_MAGIC, 4) != 0 ||
+        !take(&r, &version, sizeof(version)) || version != CHECKPOINT_VERSION ||
+        !take(&r, &epoch64, sizeof(epoch64)) ||
+        !take(&r, &count64, sizeof(count64)) || count64 != (uint64_t)count) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        Tensor *t = tensors[i];
+        uint32_t dtype = 0, ndim = 0;
+        if (!t || !tensor_is_contiguous(t) ||
+            !take(&r, &dtype, sizeof(dtype)) || dtype != (uint32_t)t->dtype ||
+            !take(&r, &ndim, sizeof(ndim)) || ndim != (uint32_t)t->ndim) {
+            return -1;
+        }
+        for (size_t k = 0; k < t->ndim; k++) {
+            uint64_t dim = 0;
+            if (!take(&r, &dim, sizeof(dim)) || dim != (uint64_t)t->shape[k]) return -1;
+        }
+        size_t bytes = t->num_elems * tensor_dtype_size(t->dtype);
+        if (!take(&r, copy ? t->data : NULL, bytes)) return -1;
+    }
+    if (r.p != r.end) return -1;   // trailing bytes: concatenated or damaged file
+    if (epoch) *epoch = (long)epoch64;
+    return 0;
+}
+
+int checkpoint_load(const char *path, long *epoch, Tensor *const *tensors, size_t count) {
+    if (!path || !tensors) return -1;
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+
+    // Read the whole file so it can be validated before anything is restored
+    char *buf = NULL;
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0) size = ftell(f);
+    if (size >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+        buf = (char*)malloc(size > 0 ? (size_t)size : 1);
+        if (buf && fread(buf, 1, (size_t)size, f) != (size_t)size) {
+            free(buf);
+            buf = NULL;
+        }
+    }
+    fclose(f);
+    if (!buf) return -1;
+
+    Reader r = { buf, buf + size };
+    int rc = parse_snapshot(r, NULL, tensors, count, 0);
+    if (rc == 0) {
+        rc = parse_snapshot(r, epoch, tensors, count, 1);
+    } else {
+        fprintf(stderr, "[checkpoint_load] %s does not match the expected layout.\n", path);
+    }
+    free(buf);
+    return rc;
+}
@@ -0,0 +1,417 @@
+#include "compress.h"
+#include "parallel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/** Bytes a decoder may read past the last encoded byte. */
+#define COMPRESS_PAD 8
+
+/**
+ * Independent streams the kernels decode side by side. Each value depends
+ * on the previous one through its control byte and the running XOR, so a
+ * single stream is one serial chain; interleaving four keeps the core busy.
+ */
+#define DECODE_WAYS 4
+
+/** Work (rows x cols) below which kernels skip the thread pool. */
+#define COMPRESS_PARALLEL_MIN (1u << 16)
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static void compressed_storage_free(void *storage) {
+    CompressedStorage *cs = (CompressedStorage*)storage;
+    if (!cs) return;
+    free(cs->offsets);
+    free(cs->bytes);
+    free(cs);
+}
+
+/** Encode 'count' values (count >= 1); returns the end of the output. */
+static unsigned char* encode_block(const double *v, size_t count, unsigned char *p) {
+    uint64_t prev;
+    memcpy(&prev, &v[0], sizeof(prev));
+    for (int k = 0; k < 8; k++) {
+        *p++ = (unsigned char)(prev >> (8 * k));
+    }
+    for (size_t i = 1; i < count; i++) {
+        uint64_t bits;
+        memcpy(&bits, &v[i], sizeof(bits));
+        uint64_t x = bits ^ prev;
+        prev = bits;
+        if (x == 0) {
+            *p++ = 0;
+            continue;
+        }
+        unsigned lead = (unsigned)__builtin_clzll(x) / 8;
+        unsigned trail = (unsigned)__builtin_ctzll(x) / 8;
+        unsigned nb = 8 - lead - trail;
+        *p++ = (unsigned char)((trail << 4) | nb);
+        uint64_t payload = x >> (8 * trail);
+        for (unsigned k = 0; k < nb; k++) {
+            *p++ = (unsigned char)(payload >> (8 * k));
+        }
+    }
+    return p;
+}
+
+/** Load 'nb' (0..8) little-endian bytes; may read up to 8 bytes. */
+static inline uint64_t load_le(const unsigned char *p, unsigned nb) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    static const uint64_t mask[9] = {
+        0, 0xff, 0xffff, 0xffffff, 0xffffffff, 0xffffffffffull,
+        0xffffffffffffull, 0xffffffffffffffull, 0xffffffffffffffffull
+    };
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v & mask[nb];
+#else
+    uint64_t v = 0;
+    for (unsigned k = 0; k < nb; k++) {
+        v |= (uint64_t)p[k] << (8 * k);
+    }
+    return v;
+#endif
+}
+
+/** Advance one stream by a value: returns the new bit pattern. */
+static inline uint64_t decode_next(const unsigned char **pp, uint64_t prev) {
+    const unsigned char *p = *pp;
+    unsigned c = *p++;
+    unsigned nb = c & 15u;
+    prev ^= load_le(p, nb) << (8 * (c >> 4));
+    *pp = p + nb;
+    return prev;
+}
+
+static inline double as_double(uint64_t bits) {
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static void decode_block(const unsigned char *p, size_t count, double *out) {
+    uint64_t prev = load_le(p, 8);
+    p += 8;
+    out[0] = as_double(prev);
+    for (size_t i = 1; i < count; i++) {
+        prev = decode_next(&p, prev);
+        out[i] = as_double(prev);
+    }
+}
+
+/**
+ * Decode DECODE_WAYS blocks of equal length at once; block k goes to
+ * out[k * ld + i * inc] for value i.
+ */
+static void decode_blocks(const unsigned char *const *src, size_t count,
+                          double *out, size_t ld, size_t inc) {
+    const unsigned char *p[DECODE_WAYS];
+    uint64_t v[DECODE_WAYS];
+    #pragma GCC unroll 4
+    for (int k = 0; k < DECODE_WAYS; k++) {
+        v[k] = load_le(src[k], 8);
+        p[k] = src[k] + 8;
+        out[k * ld] = as_double(v[k]);
+    }
+    for (size_t i = 1; i < count; i++) {
+        #pragma GCC unroll 4
+        for (int k = 0; k < DECODE_WAYS; k++) {
+            v[k] = decode_next(&p[k], v[k]);
+            out[k * ld + i * inc] = as_double(v[k]);
+        }
+    }
+}
+
+/** Rows in block b. */
+static size_t block_count(const CompressedStorage *cs, size_t b) {
+    size_t lo = b * cs->block_rows;
+    return (cs->rows - lo < cs->block_rows) ? cs->rows - lo : cs->block_rows;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              CONSTRUCTION                                 */
+/* ------------------------------------------------------------------------- */
+
+Tensor* tensor_compress(const Tensor *dense) {
+    if (!dense || dense->layout != TENSOR_LAYOUT_STRIDED || dense->ndim < 1 || dense->ndim > 2) {
+        fprintf(stderr, "[tensor_compress] expected a 1D or 2D strided tensor.\n");
+        return NULL;
+    }
+    size_t rows = dense->shape[0];
+    size_t cols = dense->ndim == 2 ? dense->shape[1] : 1;
+    size_t s0 = dense->strides[0], s1 = dense->ndim == 2 ? dense->strides[1] : 0;
+    size_t B = COMPRESS_BLOCK_ROWS;
+    size_t num_blocks = (rows + B - 1) / B;
+
+    Tensor *t = (Tensor*)calloc(1, sizeof(Tensor));
+    CompressedStorage *cs = (CompressedStorage*)calloc(1, sizeof(CompressedStorage));
+    double *col = (double*)malloc(B * sizeof(double));
+    int ok = t && cs && col;
+    if (ok) {
+        t->shape = (size_t*)malloc(dense->ndim * sizeof(size_t));
+        t->strides = (size_t*)calloc(dense->ndim, sizeof(size_t));   // unused
+        cs->offsets = (size_t*)malloc((cols * num_blocks + 1) * sizeof(size_t));
+        // Worst case: 9 bytes per value after the first of each block
+        cs->bytes = (unsigned char*)malloc(cols * rows * 9 + COMPRESS_PAD);
+        ok = t->shape && t->strides && cs->offsets && cs->bytes;
+    }
+    if (!ok) {
+        fprintf(stderr, "[tensor_compress] allocation failure.\n");
+        free(col);
+        if (t) {
+            free(t->shape);
+            free(t->strides);
+            free(t);
+        }
+        compressed_storage_free(cs);
+        return NULL;
+    }
+
+    unsigned char *p = cs->bytes;
+    for (size_t j = 0; j < cols; j++) {
+        for (size_t b = 0; b < num_blocks; b++) {
+            size_t lo = b * B;
+            size_t count = (rows - lo < B) ? rows - lo : B;
+            for (size_t i = 0; i < count; i++) {
+                col[i] = tensor_read_at_offset(dense, (lo + i) * s0 + j * s1);
+            }
+            cs->offsets[j * num_blocks + b] = (size_t)(p - cs->bytes);
+            p = encode_block(col, count, p);
+        }
+    }
+    free(col);
+    cs->rows = rows;
+    cs->cols = cols;
+    cs->block_rows = B;
+    cs->num_blocks = num_blocks;
+    cs->num_bytes = (size_t)(p - cs->bytes);
+    cs->offsets[cols * num_blocks] = cs->num_bytes;
+    memset(p, 0, COMPRESS_PAD);
+
+    // Give back the worst-case slack
+    unsigned char *shrunk = (unsigned char*)realloc(cs->bytes, cs->num_bytes + COMPRESS_PAD);
+    if (shrunk) cs->bytes = shrunk;
+
+    t->ndim = dense->ndim;
+    for (size_t k = 0; k < dense->ndim; k++) t->shape[k] = dense->shape[k];
+    t->data = NULL;
+    t->dtype = TENSOR_FLOAT64;
+    t->ref_count = 1;
+    t->owner = 1;
+    t->num_elems = rows * cols;
+    t->flags = 0;
+    t->base = NULL;
+    t->layout = TENSOR_LAYOUT_COMPRESSED;
+    t->storage = cs;
+    t->storage_free = compressed_storage_free;
+    return t;
+}
+
+Tensor* tensor_decompress(const Tensor *c) {
+    const CompressedStorage *cs = tensor_compressed(c);
+    if (!cs) {
+        fprintf(stderr, "[tensor_decompress] expected a compressed tensor.\n");
+        return NULL;
+    }
+    Tensor *out = tensor_empty(c->ndim, c->shape, TENSOR_FLOAT64);
+    double *buf = (double*)malloc(cs->block_rows * sizeof(double));
+    if (!out || !buf) {
+        tensor_free(out);
+        free(buf);
+        return NULL;
+    }
+    double *o = (double*)out->data;
+    for (size_t j = 0; j < cs->cols; j++) {
+        for (size_t b = 0; b < cs->num_blocks; b++) {
+            size_t count = tensor_compressed_decode(c, j, b, buf);
+            double *dst = o + b * cs->block_rows * cs->cols + j;
+            for (size_t i = 0; i < count; i++) {
+                dst[i * cs->cols] = buf[i];
+            }
+        }
+    }
+    free(buf);
+    return out;
+}
+
+const CompressedStorage* tensor_compressed(const Tensor *c) {
+    if (!c || c->layout != TENSOR_LAYOUT_COMPRESSED) return NULL;
+    return (const CompressedStorage*)c->storage;
+}
+
+size_t tensor_compressed_decode(const Tensor *c, size_t col, size_t block, double *out) {
+    const CompressedStorage *cs = tensor_compressed(c);
+    if (!cs || col >= cs->cols || block >= cs->num_blocks || !out) return 0;
+    size_t count = block_count(cs, block);
+    decode_block(cs->bytes + cs->offsets[col * cs->num_blocks + block], count, out);
+    return count;
+}
+
+size_t tensor_compressed_decode_rows(const Tensor *c, size_t block, double *out) {
+    const CompressedStorage *cs = tensor_compressed(c);
+    if (!cs || block >= cs->num_blocks || !out) return 0;
+    double buf[COMPRESS_BLOCK_ROWS];
+    size_t count = block_count(cs, block);
+    size_t j = 0;
+    for (; j + DECODE_WAYS <= cs->cols; j += DECODE_WAYS) {
+        const unsigned char *src[DECODE_WAYS];
+        #pragma GCC unroll 4
+        for (int k = 0; k < DECODE_WAYS; k++) {
+            src[k] = cs->bytes + cs->offsets[(j + k) * cs->num_blocks + block];
+        }
+        decode_blocks(src, count, out + j, 1, cs->cols);
+    }
+    for (; j < cs->cols; j++) {
+        decode_block(cs->bytes + cs->offsets[j * cs->num_blocks + block], count, buf);
+        for (size_t i = 0; i < count; i++) {
+            out[i * cs->cols + j] = buf[i];
+        }
+    }
+    return count;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               KERNELS                                     */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Sum over flat block indices [lo, hi) (index = col * num_blocks + block),
+ * decoding DECODE_WAYS consecutive blocks of equal length at a time.
+ */
+static double sum_blocks(size_t lo, size_t hi, void *arg) {
+    const CompressedStorage *cs = tensor_compressed((const Tensor*)arg);
+    double s[DECODE_WAYS] = { 0.0 };
+    size_t u = lo;
+    while (u < hi) {
+        size_t count = block_count(cs, u % cs->num_blocks);
+        int ways = u + DECODE_WAYS <= hi &&
+                   block_count(cs, (u + DECODE_WAYS - 1) % cs->num_blocks) == count &&
+                   (u % cs->num_blocks) + DECODE_WAYS <= cs->num_blocks;
+        if (!ways) {
+            const unsigned char *p = cs->bytes + cs->offsets[u];
+            uint64_t v = load_le(p, 8);
+            p += 8;
+            s[0] += as_double(v);
+            for (size_t i = 1; i < count; i++) {
+                v = decode_next(&p, v);
+                s[0] += as_double(v);
+            }
+            u++;
+            continue;
+        }
+        const unsigned char *p[DECODE_WAYS];
+        uint64_t v[DECODE_WAYS];
+        #pragma GCC unroll 4
+        for (int k = 0; k < DECODE_WAYS; k++) {
+            p[k] = cs->bytes + cs->offsets[u + k];
+            v[k] = load_le(p[k], 8);
+            p[k] += 8;
+            s[k] += as_double(v[k]);
+        }
+        for (size_t i = 1; i < count; i++) {
+            #pragma GCC unroll 4
+            for (int k = 0; k < DECODE_WAYS; k++) {
+                v[k] = decode_next(&p[k], v[k]);
+                s[k] += as_double(v[k]);
+            }
+        }
+        u += DECODE_WAYS;
+    }
+    double total = 0.0;
+    #pragma GCC unroll 4
+    for (int k = 0; k < DECODE_WAYS; k++) total += s[k];
+    return total;
+}
+
+double tensor_compressed_sum(const Tensor *c) {
+    const CompressedStorage *cs = tensor_compressed(c);
+    if (!cs) return 0.0;
+    size_t units = cs->cols * cs->num_blocks;
+    size_t grain = cs->rows * cs->cols >= COMPRESS_PARALLEL_MIN ? 16 : units;
+    return parallel_reduce_sum(units, grain, sum_blocks, (void*)c);
+}
+
+typedef struct {
+    const Tensor *A;
+    const double *x;
+    double        bias;
+    double       *y;
+} CompressedGemvContext;
+
+/** Row blocks [lo, hi): y = bias, then one decoded column at a time. */
+static void gemv_blocks(size_t lo, size_t hi, void *arg) {
+    const CompressedGemvContext *g = (const CompressedGemvContext*)arg;
+    const CompressedStorage *cs = tensor_compressed(g->A);
+    double buf[COMPRESS_BLOCK_ROWS];
+    for (size_t b = lo; b < hi; b++) {
+        double *y = g->y + b * cs->block_rows;
+        size_t count = block_count(cs, b);
+        for (size_t i = 0; i < count; i++) y[i] = g->bias;
+        size_t j = 0;
+        for (; j + DECODE_WAYS <= cs->cols; j += DECODE_WAYS) {
+            // Columns j..j+3 decoded together, added in column order
+            const unsigned char *p[DECODE_WAYS];
+            uint64_t v[DECODE_WAYS];
+            #pragma GCC unroll 4
+            for (int k = 0; k < DECODE_WAYS; k++) {
+                p[k] = cs->bytes + cs->offsets[(j + k) * cs->num_blocks + b];
+                v[k] = load_le(p[k], 8);
+                p[k] += 8;
+            }
+            const double *xj = g->x + j;
+            for (size_t i = 0; i < count; i++) {
+                if (i > 0) {
+                    #pragma GCC unroll 4
+                    for (int k = 0; k < DECODE_WAYS; k++) v[k] = decode_next(&p[k], v[k]);
+                }
+                double acc = y[i];
+                #pragma GCC unroll 4
+                for (int k = 0; k < DECODE_WAYS; k++) acc += as_double(v[k]) * xj[k];
+                y[i] = acc;
+            }
+        }
+        for (; j < cs->cols; j++) {
+            tensor_compressed_decode(g->A, j, b, buf);
+            double xj = g->x[j];
+            for (size_t i = 0; i < count; i++) {
+                y[i] += buf[i] * xj;
+            }
+        }
+    }
+}
+
+int tensor_compressed_gemv(const Tensor *A, const Tensor *x, double bias, Tensor *out) {
+    const CompressedStorage *cs = tensor_compressed(A);
+    if (!cs || A->ndim != 2 || !x || x->layout != TENSOR_LAYOUT_STRIDED ||
+        x->ndim < 1 || x->ndim > 2 || x->shape[0] != cs->cols ||
+        (x->ndim == 2 && x->shape[1] != 1)) {
+        fprintf(stderr, "[tensor_compressed_gemv] expected compressed A [M,K] and x [K,1].\n");
+        return -1;
+    }
+    if (!out || out->layout != TENSOR_LAYOUT_STRIDED || out->dtype != TENSOR_FLOAT64 ||
+        !tensor_is_contiguous(out) || out->num_elems != cs->rows) {
+        fprintf(stderr, "[tensor_compressed_gemv] out must be contiguous float64 [%zu, 1].\n",
+                cs->rows);
+        return -1;
+    }
+
+    double *xv = (double*)malloc((cs->cols ? cs->cols : 1) * sizeof(double));
+    if (!xv) return -1;
+    for (size_t j = 0; j < cs->cols; j++) {
+        xv[j] = tensor_read_at_offset(x, j * x->strides[0]);
+    }
+
+    CompressedGemvContext g = { A, xv, bias, (double*)out->data };
+    if (cs->rows * cs->cols >= COMPRESS_PARALLEL_MIN) {
+        parallel_for(cs->num_blocks, 1, gemv_blocks, &g);
+    } else {
+        gemv_blocks(0, cs->num_blocks, &g);
+    }
+    free(xv);
+    return 0;
+}
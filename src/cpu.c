@@ -0,0 +1,362 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "cpu.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/*
+ * No level may fuse a * b + c into one FMA: results must not depend on
+ * the level, and only some levels have FMA units.
+ */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CPU_X86 1
+#else
+#define CPU_X86 0
+#endif
+
+/** Partial sums kept by every reduction variant (lane = index % 8). */
+#define CPU_LANES 8
+
+/** GEMM output columns held in registers per pass: 4 vectors. */
+#define GEMM_UNROLL 4
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static _Atomic int kernel_ran[CPU_KERNEL_COUNT] = { -1, -1, -1, -1, -1 };
+
+static inline void note_ran(CpuKernel k, CpuLevel level) {
+    atomic_store_explicit(&kernel_ran[k], (int)level, memory_order_relaxed);
+}
+
+/** Fold the eight lanes in a fixed tree order, shared by every variant. */
+static inline double fold_lanes(const double *l) {
+    return ((l[0] + l[1]) + (l[2] + l[3])) + ((l[4] + l[5]) + (l[6] + l[7]));
+}
+
+static inline double apply_op(CpuBinaryOp op, double a, double b) {
+    switch (op) {
+        case CPU_OP_ADD: return a + b;
+        case CPU_OP_SUB: return a - b;
+        case CPU_OP_MUL: return a * b;
+        default:         return a / b;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*                            SCALAR VARIANTS                                */
+/* ------------------------------------------------------------------------- */
+
+static void binary_scalar(CpuBinaryOp op, const double *a, const double *b, int b_scalar,
+                          double *y, size_t n) {
+    note_ran(CPU_KERNEL_BINARY, CPU_LEVEL_SCALAR);
+    for (size_t i = 0; i < n; i++) {
+        y[i] = apply_op(op, a[i], b_scalar ? b[0] : b[i]);
+    }
+}
+
+static double sum_scalar(const double *x, size_t n) {
+    note_ran(CPU_KERNEL_SUM, CPU_LEVEL_SCALAR);
+    double l[CPU_LANES] = { 0.0 };
+    size_t i = 0;
+    for (; i + CPU_LANES <= n; i += CPU_LANES) {
+        for (int k = 0; k < CPU_LANES; k++) l[k] += x[i + k];
+    }
+    double s = fold_lanes(l);
+    for (; i < n; i++) s += x[i];
+    return s;
+}
+
+static double dot_scalar(const double *x, const double *y, size_t n) {
+    note_ran(CPU_KERNEL_DOT, CPU_LEVEL_SCALAR);
+    double l[CPU_LANES] = { 0.0 };
+    size_t i = 0;
+    for (; i + CPU_LANES <= n; i += CPU_LANES) {
+        for (int k = 0; k < CPU_LANES; k++) l[k] += x[i + k] * y[i + k];
+    }
+    double s = fold_lanes(l);
+    for (; i < n; i++) s += x[i] * y[i];
+    return s;
+}
+
+static void gemm_scalar(size_t M, size_t N, size_t K, const double *A, size_t lda,
+                        const double *B, size_t ldb, double *C, size_t ldc) {
+    note_ran(CPU_KERNEL_GEMM, CPU_LEVEL_SCALAR);
+    for (size_t i = 0; i < M; i++) {
+        double *c = C + i * ldc;
+        for (size_t j = 0; j < N; j++) c[j] = 0.0;
+        for (size_t k = 0; k < K; k++) {
+            double a = A[i * lda + k];
+            const double *b = B + k * ldb;
+            for (size_t j = 0; j < N; j++) c[j] += a * b[j];
+        }
+    }
+}
+
+static void f32_to_f64_scalar(const float *x, double *y, size_t n) {
+    note_ran(CPU_KERNEL_CONVERT, CPU_LEVEL_SCALAR);
+    for (size_t i = 0; i < n; i++) y[i] = (double)x[i];
+}
+
+static void f64_to_f32_scalar(const double *x, float *y, size_t n) {
+    note_ran(CPU_KERNEL_CONVERT, CPU_LEVEL_SCALAR);
+    for (size_t i = 0; i < n; i++) y[i] = (float)x[i];
+}
+
+/* ------------------------------------------------------------------------- */
+/*                             SIMD VARIANTS                                 */
+/* ------------------------------------------------------------------------- */
+
+/*
+ * One set of kernels per x86 level, compiled for that level only through
+ * the target attribute, so the rest of the library keeps the baseline
+ * ISA. Vector types of V doubles (GCC/Clang extensions) are loaded and
+ * stored with memcpy, which lowers to unaligned vector moves. Lane k of
+ * accumulator v holds partial sum v * V + k, matching sum_scalar.
+ */
+#if CPU_X86
+
+#define DEFINE_SIMD_KERNELS(SUF, TARGET, LEVEL, V)                                      \
+typedef double vd_##SUF __attribute__((vector_size((V) * sizeof(double))));             \
+typedef float  vf_##SUF __attribute__((vector_size((V) * sizeof(float))));              \
+                                                                                        \
+__attribute__((target(TARGET)))                                                         \
+static void binary_##SUF(CpuBinaryOp op, const double *a, const double *b, int b_scalar,\
+                         double *y, size_t n) {                                         \
+    note_ran(CPU_KERNEL_BINARY, LEVEL);                                                 \
+    vd_##SUF vb = (vd_##SUF){ 0 } + b[0];                                               \
+    size_t i = 0;                                                                       \
+    for (; i + (V) <= n; i += (V)) {                                                    \
+        vd_##SUF va, vr;                                                                \
+        memcpy(&va, a + i, sizeof(va));                                                 \
+        if (!b_scalar) memcpy(&vb, b + i, sizeof(vb));                                  \
+        switch (op) {                                                                   \
+            case CPU_OP_ADD: vr = va + vb; break;                                       \
+            case CPU_OP_SUB: vr = va - vb; break;                                       \
+            case CPU_OP_MUL: vr = va * vb; break;                                       \
+            default:         vr = va / vb; break;                                       \
+        }                                                                               \
+        memcpy(y + i, &vr, sizeof(vr));                                                 \
+    }                                                                                   \
+    for (; i < n; i++) {                                                                \
+        y[i] = apply_op(op, a[i], b_scalar ? b[0] : b[i]);                              \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+__attribute__((target(TARGET)))                                                         \
+static double sum_##SUF(const double *x, size_t n) {                                    \
+    note_ran(CPU_KERNEL_SUM, LEVEL);                                                    \
+    vd_##SUF acc[CPU_LANES / (V)];                                                      \
+    for (int v = 0; v < CPU_LANES / (V); v++) acc[v] = (vd_##SUF){ 0 };                 \
+    size_t i = 0;                                                                       \
+    for (; i + CPU_LANES <= n; i += CPU_LANES) {                                        \
+        for (int v = 0; v < CPU_LANES / (V); v++) {                                     \
+            vd_##SUF t;                                                                 \
+            memcpy(&t, x + i + v * (V), sizeof(t));                                     \
+            acc[v] += t;                                                                \
+        }                                                                               \
+    }                                                                                   \
+    double l[CPU_LANES];                                                                \
+    memcpy(l, acc, sizeof(l));                                                          \
+    double s = fold_lanes(l);                                                           \
+    for (; i < n; i++) s += x[i];                                                       \
+    return s;                                                                           \
+}                                                                                       \
+                                                                                        \
+__attribute__((target(TARGET)))                                                         \
+static double dot_##SUF(const double *x, const double *y, size_t n) {                   \
+    note_ran(CPU_KERNEL_DOT, LEVEL);                                                    \
+    vd_##SUF acc[CPU_LANES / (V)];                                                      \
+    for (int v = 0; v < CPU_LANES / (V); v++) acc[v] = (vd_##SUF){ 0 };                 \
+    size_t i = 0;                                                                       \
+    for (; i + CPU_LANES <= n; i += CPU_LANES) {                                        \
+        for (int v = 0; v < CPU_LANES / (V); v++) {                                     \
+            vd_##SUF tx, ty;                                                            \
+            memcpy(&tx, x + i + v * (V), sizeof(tx));                                   \
+            memcpy(&ty, y + i + v * (V), sizeof(ty));                                   \
+            acc[v] += tx * ty;                                                          \
+        }                                                                               \
+    }                                                                                   \
+    double l[CPU_LANES];                                                                \
+    memcpy(l, acc, sizeof(l));                                                          \
+    double s = fold_lanes(l);                                                           \
+    for (; i < n; i++) s += x[i] * y[i];                                                \
+    return s;                                                                           \
+}                                                                                       \
+                                                                                        \
+__attribute__((target(TARGET)))                                                         \
+static void gemm_##SUF(size_t M, size_t N, size_t K, const double *A, size_t lda,       \
+                       const double *B, size_t ldb, double *C, size_t ldc) {            \
+    note_ran(CPU_KERNEL_GEMM, LEVEL);                                                   \
+    for (size_t i = 0; i < M; i++) {                                                    \
+        const double *a = A + i * lda;                                                  \
+        double *c = C + i * ldc;                                                        \
+        size_t j = 0;                                                                   \
+        for (; j + GEMM_UNROLL * (V) <= N; j += GEMM_UNROLL * (V)) {                    \
+            vd_##SUF acc[GEMM_UNROLL];                                                  \
+            for (int u = 0; u < GEMM_UNROLL; u++) acc[u] = (vd_##SUF){ 0 };             \
+            for (size_t k = 0; k < K; k++) {                                            \
+                vd_##SUF va = (vd_##SUF){ 0 } + a[k];                                   \
+                const double *b = B + k * ldb + j;                                      \
+                for (int u = 0; u < GEMM_UNROLL; u++) {                                 \
+                    vd_##SUF vb;                                                        \
+                    memcpy(&vb, b + u * (V), sizeof(vb));                               \
+                    acc[u] += va * vb;                                                  \
+                }                                                                       \
+            }                                                                           \
+            memcpy(c + j, acc, sizeof(acc));                                            \
+        }                                                                               \
+        for (; j + (V) <= N; j += (V)) {                                                \
+            vd_##SUF acc = (vd_##SUF){ 0 };                                             \
+            for (size_t k = 0; k < K; k++) {                                            \
+                vd_##SUF vb;                                                            \
+                memcpy(&vb, B + k * ldb + j, sizeof(vb));                               \
+                acc += ((vd_##SUF){ 0 } + a[k]) * vb;                                   \
+            }                                                                           \
+            memcpy(c + j, &acc, sizeof(acc));                                           \
+        }                                                                               \
+        for (; j < N; j++) {                                                            \
+            double s = 0.0;                                                             \
+            for (size_t k = 0; k < K; k++) s += a[k] * B[k * ldb + j];                  \
+            c[j] = s;                                                                   \
+        }                                                                               \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+__attribute__((target(TARGET)))                                                         \
+static void f32_to_f64_##SUF(const float *x, double *y, size_t n) {                     \
+    note_ran(CPU_KERNEL_CONVERT, LEVEL);                                                \
+    size_t i = 0;                                                                       \
+    for (; i + (V) <= n; i += (V)) {                                                    \
+        vf_##SUF t;                                                                     \
+        memcpy(&t, x + i, sizeof(t));                                                   \
+        vd_##SUF r = __builtin_convertvector(t, vd_##SUF);                              \
+        memcpy(y + i, &r, sizeof(r));                                                   \
+    }                                                                                   \
+    for (; i < n; i++) y[i] = (double)x[i];                                             \
+}                                                                                       \
+                                                                                        \
+__attribute__((target(TARGET)))                                                         \
+static void f64_to_f32_##SUF(const double *x, float *y, size_t n) {                     \
+    note_ran(CPU_KERNEL_CONVERT, LEVEL);                                                \
+    size_t i = 0;                                                                       \
+    for (; i + (V) <= n; i += (V)) {                                                    \
+        vd_##SUF t;                                                                     \
+        memcpy(&t, x + i, sizeof(t));                                                   \
+        vf_##SUF r = __builtin_convertvector(t, vf_##SUF);                              \
+        memcpy(y + i, &r, sizeof(r));                                                   \
+    }                                                                                   \
+    for (; i < n; i++) y[i] = (float)x[i];                                              \
+}
+
+DEFINE_SIMD_KERNELS(sse42,  "sse4.2",  CPU_LEVEL_SSE42,  2)
+DEFINE_SIMD_KERNELS(avx2,   "avx2",    CPU_LEVEL_AVX2,   4)
+DEFINE_SIMD_KERNELS(avx512, "avx512f", CPU_LEVEL_AVX512, 8)
+
+#endif /* CPU_X86 */
+
+/* ------------------------------------------------------------------------- */
+/*                                DISPATCH                                   */
+/* ------------------------------------------------------------------------- */
+
+#define KERNEL_ROW(LEVEL, SUF) \
+    { LEVEL, binary_##SUF, sum_##SUF, dot_##SUF, gemm_##SUF, f32_to_f64_##SUF, f64_to_f32_##SUF }
+
+/** Table rows indexed by level; a level without variants reuses a lower row. */
+static const CpuKernels kernel_table[CPU_LEVEL_COUNT] = {
+    KERNEL_ROW(CPU_LEVEL_SCALAR, scalar),
+#if CPU_X86
+    KERNEL_ROW(CPU_LEVEL_SSE42, sse42),
+    KERNEL_ROW(CPU_LEVEL_AVX2, avx2),
+    KERNEL_ROW(CPU_LEVEL_AVX512, avx512),
+#else
+    KERNEL_ROW(CPU_LEVEL_SCALAR, scalar),
+    KERNEL_ROW(CPU_LEVEL_SCALAR, scalar),
+    KERNEL_ROW(CPU_LEVEL_SCALAR, scalar),
+#endif
+};
+
+static const char *level_names[CPU_LEVEL_COUNT] = { "scalar", "sse4.2", "avx2", "avx512" };
+
+static pthread_once_t dispatch_once = PTHREAD_ONCE_INIT;
+static CpuLevel detected = CPU_LEVEL_SCALAR;
+static _Atomic(const CpuKernels*) active = NULL;
+
+static CpuLevel detect_level(void) {
+#if CPU_X86
+    // libgcc also checks via XGETBV that the OS saves the wider registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return CPU_LEVEL_AVX512;
+    if (__builtin_cpu_supports("avx2"))    return CPU_LEVEL_AVX2;
+    if (__builtin_cpu_supports("sse4.2"))  return CPU_LEVEL_SSE42;
+#endif
+    return CPU_LEVEL_SCALAR;
+}
+
+static void dispatch_init(void) {
+    detected = detect_level();
+    CpuLevel level = detected;
+    const char *env = getenv("ML_CPU_LEVEL");
+    if (env && *env) {
+        int found = 0;
+        for (int k = 0; k < CPU_LEVEL_COUNT; k++) {
+            if (strcmp(env, level_names[k]) == 0) {
+                found = 1;
+                if ((CpuLevel)k <= detected) {
+                    level = (CpuLevel)k;
+                } else {
+                    fprintf(stderr, "[cpu] ML_CPU_LEVEL=%s not supported, using %s.\n",
+                            env, level_names[detected]);
+                }
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "[cpu] unknown ML_CPU_LEVEL=%s, using %s.\n", env, level_names[detected]);
+        }
+    }
+    atomic_store_explicit(&active, &kernel_table[level], memory_order_release);
+}
+
+const CpuKernels* cpu_kernels(void) {
+    pthread_once(&dispatch_once, dispatch_init);
+    return atomic_load_explicit(&active, memory_order_acquire);
+}
+
+CpuLevel cpu_detected_level(void) {
+    pthread_once(&dispatch_once, dispatch_init);
+    return detected;
+}
+
+CpuLevel cpu_active_level(void) {
+    return cpu_kernels()->level;
+}
+
+int cpu_set_level(CpuLevel level) {
+    pthread_once(&dispatch_once, dispatch_init);
+    if ((int)level < 0 || level > detected) {
+        return -1;
+    }
+    atomic_store_explicit(&active, &kernel_table[level], memory_order_release);
+    return 0;
+}
+
+const char* cpu_level_name(CpuLevel level) {
+    if ((int)level < 0 || level >= CPU_LEVEL_COUNT) return "unknown";
+    return level_names[level];
+}
+
+int cpu_kernel_ran(CpuKernel k) {
+    if ((int)k < 0 || k >= CPU_KERNEL_COUNT) return -1;
+    return atomic_load_explicit(&kernel_ran[k], memory_order_relaxed);
+}
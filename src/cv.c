@@ -0,0 +1,228 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "cv.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/** Everything one fold needs; built on the calling thread, run on a worker. */
+typedef struct {
+    Tensor       *X_parts[2];
+    Tensor       *y_parts[2];
+    size_t        num_parts;
+    Tensor       *X_test;
+    Tensor       *y_test;
+    Tensor       *W;
+    Tensor       *b;
+    int           status;
+    CVFoldResult  result;
+} FoldJob;
+
+/** Shared work queue: workers claim the next unstarted fold. */
+typedef struct {
+    FoldJob           *jobs;
+    size_t             num_jobs;
+    size_t             next;
+    const TrainConfig *train;
+    pthread_mutex_t    lock;
+} FoldQueue;
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+/** View of rows [r0, r1) of a 1D or 2D tensor. */
+static Tensor* row_view(Tensor *t, size_t r0, size_t r1) {
+    size_t start[2] = { r0, 0 };
+    size_t end[2] = { r1, t->ndim == 2 ? t->shape[1] : 0 };
+    return tensor_slice(t, start, end);
+}
+
+/** Add rows [r0, r1) of X/y as the next training block (skips empty ranges). */
+static int add_train_part(FoldJob *job, Tensor *X, Tensor *y, size_t r0, size_t r1) {
+    if (r1 <= r0) return 0;
+    size_t p = job->num_parts;
+    job->X_parts[p] = row_view(X, r0, r1);
+    job->y_parts[p] = row_view(y, r0, r1);
+    job->num_parts++;
+    job->result.train_rows += r1 - r0;
+    return (job->X_parts[p] && job->y_parts[p]) ? 0 : -1;
+}
+
+static void fold_job_free(FoldJob *job) {
+    for (size_t p = 0; p < job->num_parts; p++) {
+        tensor_free(job->X_parts[p]);
+        tensor_free(job->y_parts[p]);
+    }
+    tensor_free(job->X_test);
+    tensor_free(job->y_test);
+    tensor_free(job->W);
+    tensor_free(job->b);
+}
+
+/** Test-set MSE and MAE at the trained (W, b). */
+static void evaluate_fold(FoldJob *job) {
+    const Tensor *X = job->X_test, *y = job->y_test;
+    size_t n = X->shape[0];
+    size_t d = X->shape[1];
+    const double *w = (const double*)job->W->data;
+    double bias = ((const double*)job->b->data)[0];
+    double sse = 0.0, sae = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double pred = bias;
+        for (size_t j = 0; j < d; j++) {
+            pred += tensor_read_at_offset(X, i * X->strides[0] + j * X->strides[1]) * w[j];
+        }
+        double r = pred - tensor_read_at_offset(y, i * y->strides[0]);
+        sse += r * r;
+        sae += fabs(r);
+    }
+    job->result.test_mse = sse / (double)n;
+    job->result.test_mae = sae / (double)n;
+}
+
+static void run_fold(FoldJob *job, const TrainConfig *train) {
+    double t0 = now_seconds();
+    TrainResult tr;
+    job->status = train_linear_regression_parts(
+        (const Tensor *const*)job->X_parts, (const Tensor *const*)job->y_parts,
+        job->num_parts, job->W, job->b, train, &tr);
+    if (job->status == 0) {
+        job->result.train_loss = tr.final_loss;
+        job->result.epochs_run = tr.epochs_run;
+        job->result.converged = tr.converged;
+        evaluate_fold(job);
+    }
+    job->result.seconds = now_seconds() - t0;
+}
+
+static void* worker_main(void *arg) {
+    FoldQueue *q = (FoldQueue*)arg;
+    for (;;) {
+        pthread_mutex_lock(&q->lock);
+        size_t f = q->next < q->num_jobs ? q->next++ : q->num_jobs;
+        pthread_mutex_unlock(&q->lock);
+        if (f == q->num_jobs) break;
+        run_fold(&q->jobs[f], q->train);
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                 DRIVER                                    */
+/* ------------------------------------------------------------------------- */
+
+CVConfig cv_default_config(CVScheme scheme, size_t folds) {
+    CVConfig cfg;
+    cfg.scheme = scheme;
+    cfg.folds = folds;
+    cfg.num_threads = 0;
+    cfg.train = train_default_config();
+    return cfg;
+}
+
+int cross_validate(Tensor *X, Tensor *y, const CVConfig *cfg,
+                   CVFoldResult *results, Tensor *coefs) {
+    if (!X || !y || !cfg || !results || X->ndim != 2 ||
+        X->layout != TENSOR_LAYOUT_STRIDED || y->layout != TENSOR_LAYOUT_STRIDED ||
+        y->shape[0] != X->shape[0]) {
+        fprintf(stderr, "[cross_validate] invalid arguments.\n");
+        return -1;
+    }
+    size_t n = X->shape[0];
+    size_t d = X->shape[1];
+    size_t k = cfg->folds;
+    size_t blocks = (cfg->scheme == CV_KFOLD) ? k : k + 1;
+    if (k == 0 || (cfg->scheme == CV_KFOLD && k < 2) || n < blocks) {
+        fprintf(stderr, "[cross_validate] need at least one row per block.\n");
+        return -1;
+    }
+    if (coefs && (coefs->ndim != 2 || coefs->shape[0] != k || coefs->shape[1] != d + 1)) {
+        fprintf(stderr, "[cross_validate] coefs must be [folds, d + 1].\n");
+        return -1;
+    }
+
+    FoldJob *jobs = (FoldJob*)calloc(k, sizeof(FoldJob));
+    if (!jobs) return -1;
+
+    // 1) Fold views: block boundaries at i * n / blocks
+    int rc = 0;
+    for (size_t f = 0; f < k && rc == 0; f++) {
+        FoldJob *job = &jobs[f];
+        size_t t0, t1;
+        if (cfg->scheme == CV_KFOLD) {
+            t0 = f * n / blocks;
+            t1 = (f + 1) * n / blocks;
+            rc |= add_train_part(job, X, y, 0, t0);
+            rc |= add_train_part(job, X, y, t1, n);
+        } else {
+            t0 = (f + 1) * n / blocks;
+            t1 = (f + 2) * n / blocks;
+            rc |= add_train_part(job, X, y, 0, t0);
+        }
+        job->result.test_start = t0;
+        job->result.test_rows = t1 - t0;
+        job->X_test = row_view(X, t0, t1);
+        job->y_test = row_view(y, t0, t1);
+        job->W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+        job->b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+        if (!job->X_test || !job->y_test || !job->W || !job->b) rc = -1;
+    }
+
+    // 2) Run folds on the pool (the calling thread works too)
+    if (rc == 0) {
+        TrainConfig train = cfg->train;
+        train.checkpoint = NULL;
+        train.checkpoint_every = 0;
+        train.resume_path = NULL;
+        train.verbose = 0;
+
+        long threads = cfg->num_threads > 0 ? cfg->num_threads : sysconf(_SC_NPROCESSORS_ONLN);
+        if (threads < 1) threads = 1;
+        if ((size_t)threads > k) threads = (long)k;
+
+        FoldQueue q = { jobs, k, 0, &train, PTHREAD_MUTEX_INITIALIZER };
+        pthread_t *tids = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+        long started = 0;
+        if (tids) {
+            while (started < threads - 1 &&
+                   pthread_create(&tids[started], NULL, worker_main, &q) == 0) {
+                started++;
+            }
+        }
+        worker_main(&q);
+        for (long i = 0; i < started; i++) {
+            pthread_join(tids[i], NULL);
+        }
+        free(tids);
+        pthread_mutex_destroy(&q.lock);
+    }
+
+    // 3) Collect results
+    for (size_t f = 0; f < k; f++) {
+        if (rc == 0 && jobs[f].status != 0) rc = -1;
+        if (rc == 0) {
+            results[f] = jobs[f].result;
+            if (coefs) {
+                for (size_t j = 0; j < d; j++) {
+                    tensor_set(coefs, (size_t[]){f, j}, ((double*)jobs[f].W->data)[j]);
+                }
+                tensor_set(coefs, (size_t[]){f, d}, ((double*)jobs[f].b->data)[0]);
+            }
+        }
+        fold_job_free(&jobs[f]);
+    }
+    free(jobs);
+    return rc;
+}
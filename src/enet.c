@@ -0,0 +1,250 @@
+#include "enet.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static double soft_threshold(double z, double t) {
+    if (z > t) return z - t;
+    if (z < -t) return z + t;
+    return 0.0;
+}
+
+/**
+ * Coordinate update of w[j] with r = c - G w kept current in O(d).
+ * Returns G_jj * dw^2, the objective-scale size of the move.
+ */
+static double cd_update(size_t j, size_t d, const double *G, double *w, double *r,
+                        double l1, double l2) {
+    double gjj = G[j * d + j];
+    if (gjj + l2 <= 0.0) return 0.0;   // constant feature, unpenalized
+    double wj = w[j];
+    double wn = soft_threshold(r[j] + gjj * wj, l1) / (gjj + l2);
+    double dw = wn - wj;
+    if (dw == 0.0) return 0.0;
+    w[j] = wn;
+    const double *Gj = G + j * d;      // symmetric: row j is column j
+    for (size_t k = 0; k < d; k++) {
+        r[k] -= Gj[k] * dw;
+    }
+    return gjj * dw * dw;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+ENetGram* enet_gram_create(const Tensor *X, const Tensor *y) {
+    if (!X || !y || X->ndim != 2 || X->layout != TENSOR_LAYOUT_STRIDED ||
+        y->layout != TENSOR_LAYOUT_STRIDED || y->shape[0] != X->shape[0] ||
+        X->shape[0] == 0 || X->shape[1] == 0) {
+        fprintf(stderr, "[enet_gram_create] invalid arguments.\n");
+        return NULL;
+    }
+    size_t n = X->shape[0];
+    size_t d = X->shape[1];
+    size_t sx0 = X->strides[0], sx1 = X->strides[1], sy0 = y->strides[0];
+
+    ENetGram *g = (ENetGram*)calloc(1, sizeof(ENetGram));
+    double *xc = (double*)malloc(d * sizeof(double));
+    if (g) {
+        g->G = tensor_create(2, (size_t[]){d, d}, TENSOR_FLOAT64);
+        g->c = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+        g->mean_x = tensor_create(1, &d, TENSOR_FLOAT64);
+    }
+    if (!g || !xc || !g->G || !g->c || !g->mean_x) {
+        fprintf(stderr, "[enet_gram_create] allocation failure.\n");
+        free(xc);
+        enet_gram_free(g);
+        return NULL;
+    }
+    g->n = n;
+    g->d = d;
+    double *G = (double*)g->G->data;
+    double *c = (double*)g->c->data;
+    double *mx = (double*)g->mean_x->data;
+
+    // 1) Means
+    double my = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < d; j++) {
+            mx[j] += tensor_read_at_offset(X, i * sx0 + j * sx1);
+        }
+        my += tensor_read_at_offset(y, i * sy0);
+    }
+    for (size_t j = 0; j < d; j++) mx[j] /= (double)n;
+    my /= (double)n;
+
+    // 2) Centered products (upper triangle), then mirror and scale
+    double vy = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < d; j++) {
+            xc[j] = tensor_read_at_offset(X, i * sx0 + j * sx1) - mx[j];
+        }
+        double yc = tensor_read_at_offset(y, i * sy0) - my;
+        for (size_t j = 0; j < d; j++) {
+            double *Gj = G + j * d;
+            double xj = xc[j];
+            for (size_t k = j; k < d; k++) {
+                Gj[k] += xj * xc[k];
+            }
+            c[j] += xj * yc;
+        }
+        vy += yc * yc;
+    }
+    double inv_n = 1.0 / (double)n;
+    for (size_t j = 0; j < d; j++) {
+        for (size_t k = j; k < d; k++) {
+            G[j * d + k] *= inv_n;
+            G[k * d + j] = G[j * d + k];
+        }
+        c[j] *= inv_n;
+    }
+    g->mean_y = my;
+    g->var_y = vy * inv_n;
+
+    free(xc);
+    return g;
+}
+
+void enet_gram_free(ENetGram *g) {
+    if (!g) return;
+    tensor_free(g->G);
+    tensor_free(g->c);
+    tensor_free(g->mean_x);
+    free(g);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                 SOLVER                                    */
+/* ------------------------------------------------------------------------- */
+
+ENetConfig enet_default_config(double alpha) {
+    ENetConfig cfg;
+    cfg.alpha = alpha;
+    cfg.num_lambdas = 100;
+    cfg.lambda_ratio = 1e-3;
+    cfg.lambdas = NULL;
+    cfg.tol = 1e-7;
+    cfg.max_sweeps = 10000;
+    return cfg;
+}
+
+int enet_path(const ENetGram *g, const ENetConfig *cfg, Tensor *coefs, ENetPathPoint *points) {
+    if (!g || !cfg || !coefs || cfg->num_lambdas == 0 || !(cfg->alpha >= 0.0 && cfg->alpha <= 1.0) ||
+        coefs->layout != TENSOR_LAYOUT_STRIDED || coefs->ndim != 2 ||
+        coefs->shape[0] != cfg->num_lambdas || coefs->shape[1] != g->d + 1) {
+        fprintf(stderr, "[enet_path] invalid arguments (coefs must be [num_lambdas, d + 1]).\n");
+        return -1;
+    }
+    size_t d = g->d;
+    size_t L = cfg->num_lambdas;
+    const double *G = (const double*)g->G->data;
+    const double *c = (const double*)g->c->data;
+    const double *mx = (const double*)g->mean_x->data;
+    double alpha = cfg->alpha;
+
+    double *w = (double*)calloc(d, sizeof(double));
+    double *r = (double*)malloc(d * sizeof(double));   // c - G w
+    size_t *set = (size_t*)malloc(d * sizeof(size_t));
+    unsigned char *in_set = (unsigned char*)malloc(d);
+    if (!w || !r || !set || !in_set) {
+        fprintf(stderr, "[enet_path] allocation failure.\n");
+        free(w);
+        free(r);
+        free(set);
+        free(in_set);
+        return -1;
+    }
+    memcpy(r, c, d * sizeof(double));
+
+    double lambda_max = 0.0;
+    for (size_t j = 0; j < d; j++) {
+        lambda_max = fmax(lambda_max, fabs(c[j]));
+    }
+    lambda_max /= fmax(alpha, 1e-3);
+    double thresh = cfg->tol * (g->var_y > 0.0 ? g->var_y : 1.0);
+    double lam_prev = lambda_max;
+
+    for (size_t k = 0; k < L; k++) {
+        double lam;
+        if (cfg->lambdas) {
+            lam = cfg->lambdas[k];
+        } else {
+            lam = (L == 1) ? lambda_max
+                           : lambda_max * pow(cfg->lambda_ratio, (double)k / (double)(L - 1));
+        }
+        double l1 = lam * alpha;
+        double l2 = lam * (1.0 - alpha);
+
+        // 1) Working set: current nonzeros plus the strong-rule survivors
+        size_t m = 0;
+        double strong = alpha * (2.0 * lam - lam_prev);
+        for (size_t j = 0; j < d; j++) {
+            in_set[j] = (w[j] != 0.0 || fabs(r[j]) >= strong);
+            if (in_set[j]) set[m++] = j;
+        }
+
+        // 2) Sweep the working set; then add KKT violators and repeat
+        int sweeps = 0, converged = 0;
+        for (;;) {
+            double max_move = 0.0;
+            while (sweeps < cfg->max_sweeps) {
+                sweeps++;
+                max_move = 0.0;
+                for (size_t t = 0; t < m; t++) {
+                    max_move = fmax(max_move, cd_update(set[t], d, G, w, r, l1, l2));
+                }
+                if (max_move <= thresh) break;
+            }
+            if (max_move > thresh) break;
+
+            size_t added = 0;
+            for (size_t j = 0; j < d; j++) {
+                if (!in_set[j] && fabs(r[j]) > l1) {
+                    in_set[j] = 1;
+                    set[m++] = j;
+                    added++;
+                }
+            }
+            if (added == 0) {
+                converged = 1;
+                break;
+            }
+            if (sweeps >= cfg->max_sweeps) break;   // violators added but never swept
+        }
+
+        // 3) Record the point
+        double b = g->mean_y;
+        double cw = 0.0, rw = 0.0;
+        size_t nonzero = 0;
+        for (size_t j = 0; j < d; j++) {
+            b -= mx[j] * w[j];
+            cw += c[j] * w[j];
+            rw += r[j] * w[j];
+            nonzero += (w[j] != 0.0);
+            tensor_write_at_offset(coefs, k * coefs->strides[0] + j * coefs->strides[1], w[j]);
+        }
+        tensor_write_at_offset(coefs, k * coefs->strides[0] + d * coefs->strides[1], b);
+        if (points) {
+            points[k].lambda = lam;
+            points[k].intercept = b;
+            points[k].nonzero = nonzero;
+            points[k].train_mse = g->var_y - cw - rw;
+            points[k].sweeps = sweeps;
+            points[k].converged = converged;
+        }
+        lam_prev = lam;
+    }
+
+    free(w);
+    free(r);
+    free(set);
+    free(in_set);
+    return 0;
+}
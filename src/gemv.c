@@ -0,0 +1,126 @@
+#include "gemv.h"
+
+/* ------------------------------------------------------------------------- */
+/*                          UNROLLING TEMPLATES                              */
+/* ------------------------------------------------------------------------- */
+
+/* REPn(M) expands to M(0) M(1) ... M(n-1). */
+#define REP1(M)  M(0)
+#define REP2(M)  REP1(M)  M(1)
+#define REP3(M)  REP2(M)  M(2)
+#define REP4(M)  REP3(M)  M(3)
+#define REP5(M)  REP4(M)  M(4)
+#define REP6(M)  REP5(M)  M(5)
+#define REP7(M)  REP6(M)  M(6)
+#define REP8(M)  REP7(M)  M(7)
+#define REP9(M)  REP8(M)  M(8)
+#define REP10(M) REP9(M)  M(9)
+#define REP11(M) REP10(M) M(10)
+#define REP12(M) REP11(M) M(11)
+#define REP13(M) REP12(M) M(12)
+#define REP14(M) REP13(M) M(13)
+#define REP15(M) REP14(M) M(14)
+#define REP16(M) REP15(M) M(15)
+
+/* GEMV pieces: x held in named locals, one multiply-add per column. */
+#define GEMV_LOAD_X(j)  const double x##j = x[j];
+#define GEMV_MADD(j)    s += a[j] * x##j;
+
+/* GEVM pieces: y[j] carried in a register per output column. */
+#define GEVM_LOAD(j)    double acc##j = y[j];
+#define GEVM_MADD(j)    acc##j += xi * a[j];
+#define GEVM_STORE(j)   y[j] = acc##j;
+
+#define DEFINE_SMALL_KERNELS(D)                                               \
+    static void gemv_small_##D(size_t m, const double *A, size_t lda,          \
+                               const double *x, double bias, double *y) {     \
+        REP##D(GEMV_LOAD_X)                                                   \
+        for (size_t i = 0; i < m; i++) {                                      \
+            const double *a = A + i * lda;                                    \
+            double s = bias;                                                  \
+            REP##D(GEMV_MADD)                                                 \
+            y[i] = s;                                                         \
+        }                                                                     \
+    }                                                                         \
+    static void gevm_small_##D(size_t m, const double *A, size_t lda,          \
+                               const double *x, double *y) {                  \
+        REP##D(GEVM_LOAD)                                                     \
+        for (size_t i = 0; i < m; i++) {                                      \
+            const double *a = A + i * lda;                                    \
+            double xi = x[i];                                                 \
+            REP##D(GEVM_MADD)                                                 \
+        }                                                                     \
+        REP##D(GEVM_STORE)                                                    \
+    }
+
+DEFINE_SMALL_KERNELS(1)
+DEFINE_SMALL_KERNELS(2)
+DEFINE_SMALL_KERNELS(3)
+DEFINE_SMALL_KERNELS(4)
+DEFINE_SMALL_KERNELS(5)
+DEFINE_SMALL_KERNELS(6)
+DEFINE_SMALL_KERNELS(7)
+DEFINE_SMALL_KERNELS(8)
+DEFINE_SMALL_KERNELS(9)
+DEFINE_SMALL_KERNELS(10)
+DEFINE_SMALL_KERNELS(11)
+DEFINE_SMALL_KERNELS(12)
+DEFINE_SMALL_KERNELS(13)
+DEFINE_SMALL_KERNELS(14)
+DEFINE_SMALL_KERNELS(15)
+DEFINE_SMALL_KERNELS(16)
+
+typedef void (*GemvSmallFn)(size_t, const double*, size_t, const double*, double, double*);
+typedef void (*GevmSmallFn)(size_t, const double*, size_t, const double*, double*);
+
+static const GemvSmallFn gemv_small[GEMV_SMALL_MAX + 1] = {
+    NULL,
+    gemv_small_1, gemv_small_2, gemv_small_3, gemv_small_4,
+    gemv_small_5, gemv_small_6, gemv_small_7, gemv_small_8,
+    gemv_small_9, gemv_small_10, gemv_small_11, gemv_small_12,
+    gemv_small_13, gemv_small_14, gemv_small_15, gemv_small_16,
+};
+
+static const GevmSmallFn gevm_small[GEMV_SMALL_MAX + 1] = {
+    NULL,
+    gevm_small_1, gevm_small_2, gevm_small_3, gevm_small_4,
+    gevm_small_5, gevm_small_6, gevm_small_7, gevm_small_8,
+    gevm_small_9, gevm_small_10, gevm_small_11, gevm_small_12,
+    gevm_small_13, gevm_small_14, gevm_small_15, gevm_small_16,
+};
+
+/* ------------------------------------------------------------------------- */
+/*                                KERNELS                                    */
+/* ------------------------------------------------------------------------- */
+
+void gemv_f64(size_t m, size_t k, const double *A, size_t lda,
+              const double *x, double bias, double *y) {
+    if (k >= 1 && k <= GEMV_SMALL_MAX) {
+        gemv_small[k](m, A, lda, x, bias, y);
+        return;
+    }
+    for (size_t i = 0; i < m; i++) {
+        const double *a = A + i * lda;
+        double s = bias;
+        for (size_t j = 0; j < k; j++) {
+            s += a[j] * x[j];
+        }
+        y[i] = s;
+    }
+}
+
+void gevm_f64(size_t m, size_t n, const double *A, size_t lda,
+              const double *x, double *y) {
+    if (n >= 1 && n <= GEMV_SMALL_MAX) {
+        gevm_small[n](m, A, lda, x, y);
+        return;
+    }
+    // Wide rows: stream each row once as an axpy into y
+    for (size_t i = 0; i < m; i++) {
+        const double *a = A + i * lda;
+        double xi = x[i];
+        for (size_t j = 0; j < n; j++) {
+            y[j] += xi * a[j];
+        }
+    }
+}
@@ -0,0 +1,427 @@
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64   // dataset files may exceed 2 GiB
+
+#include "loader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+#include <pthread.h>
+
+#define LOADER_VERSION 1u
+
+/** File header magic. */
+static const char LOADER_MAGIC[4] = { 'M', 'L', 'D', 'S' };
+
+/** Bytes before the first record: magic | version | dtype | d. */
+#define LOADER_HEADER_BYTES (sizeof(LOADER_MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t))
+
+/** Largest feature count accepted from a header; keeps record sizes and
+ *  chunk buffers far from size_t and off_t overflow. */
+#define LOADER_MAX_FEATURES ((uint64_t)1 << 24)
+
+/** One ring slot. rows == 0 marks the end of a pass. */
+typedef struct {
+    Tensor *X;        // [chunk_rows, d]
+    Tensor *y;        // [chunk_rows, 1]
+    size_t  rows;
+    int     status;
+} Chunk;
+
+struct DataLoader {
+    LoaderSource    src;
+    size_t          chunk_rows;
+    size_t          depth;
+    Chunk          *ring;
+    size_t          head;      // oldest filled slot
+    size_t          count;     // filled slots, including a held one
+    int             holding;   // consumer holds ring[head]
+    int             failed;
+    int             stop;
+    LoaderStats     stats;
+    Tensor         *view_X;    // views handed out by the last loader_next()
+    Tensor         *view_y;
+    pthread_mutex_t lock;
+    pthread_cond_t  filled;    // consumer waits for count > 0
+    pthread_cond_t  freed;     // reader waits for count < depth
+    pthread_t       thread;
+};
+
+/** Open dataset file, read on the reader thread. */
+typedef struct {
+    FILE         *f;
+    TensorDtype   dtype;
+    size_t        d;
+    size_t        record_bytes;
+    size_t        next_row;    // row at the current file position
+    unsigned char *buf;
+    size_t        cap;
+} FileSource;
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/** Give ring[head] back to the reader. Caller holds the lock. */
+static void release_head(DataLoader *L) {
+    L->head = (L->head + 1) % L->depth;
+    L->count--;
+    L->holding = 0;
+    pthread_cond_signal(&L->freed);
+}
+
+/** Reader thread: fill free slots in order, one pass after another. */
+static void* reader_main(void *arg) {
+    DataLoader *L = (DataLoader*)arg;
+    size_t row = 0;
+    pthread_mutex_lock(&L->lock);
+    for (;;) {
+        while (L->count == L->depth && !L->stop) {
+            pthread_cond_wait(&L->freed, &L->lock);
+        }
+        if (L->stop) break;
+        Chunk *c = &L->ring[(L->head + L->count) % L->depth];
+        pthread_mutex_unlock(&L->lock);
+
+        // Convert outside the lock; the consumer never touches unfilled slots
+        double t0 = now_ns();
+        size_t rows = 0;
+        int rc = L->src.fill(L->src.ctx, row, L->chunk_rows,
+                             (double*)c->X->data, (double*)c->y->data, &rows);
+        if (rows > L->chunk_rows) rc = -1;
+        double dt = now_ns() - t0;
+
+        pthread_mutex_lock(&L->lock);
+        L->stats.load_ns += dt;
+        c->rows = rows;
+        c->status = rc;
+        L->count++;
+        pthread_cond_signal(&L->filled);
+        if (rc != 0) break;
+        row = rows ? row + rows : 0;
+    }
+    pthread_mutex_unlock(&L->lock);
+    return NULL;
+}
+
+static void ring_free(Chunk *ring, size_t depth) {
+    if (!ring) return;
+    for (size_t i = 0; i < depth; i++) {
+        tensor_free(ring[i].X);
+        tensor_free(ring[i].y);
+    }
+    free(ring);
+}
+
+static int file_fill(void *ctx, size_t row0, size_t max_rows,
+                     double *X, double *y, size_t *rows) {
+    FileSource *fs = (FileSource*)ctx;
+    if (row0 != fs->next_row) {
+        off_t pos = (off_t)LOADER_HEADER_BYTES + (off_t)row0 * (off_t)fs->record_bytes;
+        if (fseeko(fs->f, pos, SEEK_SET) != 0) return -1;
+        fs->next_row = row0;
+    }
+    size_t need = max_rows * fs->record_bytes;
+    if (need > fs->cap) {
+        unsigned char *grown = (unsigned char*)realloc(fs->buf, need);
+        if (!grown) return -1;
+        fs->buf = grown;
+        fs->cap = need;
+    }
+
+    off_t start = ftello(fs->f);
+    size_t got = fread(fs->buf, fs->record_bytes, max_rows, fs->f);
+    if (got < max_rows) {
+        // A short read must end exactly on a record boundary
+        if (ferror(fs->f) || start < 0 ||
+            ftello(fs->f) != start + (off_t)got * (off_t)fs->record_bytes) {
+            fprintf(stderr, "[loader] dataset ends inside a record.\n");
+            return -1;
+        }
+    }
+
+    size_t d = fs->d;
+    for (size_t i = 0; i < got; i++) {
+        const unsigned char *rec = fs->buf + i * fs->record_bytes;
+        double *xi = X + i * d;
+        if (fs->dtype == TENSOR_FLOAT64) {
+            const double *v = (const double*)rec;
+            memcpy(xi, v, d * sizeof(double));
+            y[i] = v[d];
+        } else {
+            const float *v = (const float*)rec;
+            for (size_t j = 0; j < d; j++) xi[j] = (double)v[j];
+            y[i] = (double)v[d];
+        }
+    }
+    fs->next_row += got;
+    *rows = got;
+    return 0;
+}
+
+static void file_close(void *ctx) {
+    FileSource *fs = (FileSource*)ctx;
+    if (!fs) return;
+    if (fs->f) fclose(fs->f);
+    free(fs->buf);
+    free(fs);
+}
+
+/** Read and validate a dataset header; returns 0 and fills dtype/d. */
+static int read_header(FILE *f, TensorDtype *dtype, size_t *d) {
+    char magic[4];
+    uint32_t version, dt;
+    uint64_t d64;
+    if (fread(magic, 1, sizeof(magic), f) != sizeof(magic) ||
+        fread(&version, sizeof(version), 1, f) != 1 ||
+        fread(&dt, sizeof(dt), 1, f) != 1 ||
+        fread(&d64, sizeof(d64), 1, f) != 1) {
+        return -1;
+    }
+    if (memcmp(magic, LOADER_MAGIC, sizeof(magic)) != 0 || version != LOADER_VERSION ||
+        (dt != TENSOR_FLOAT32 && dt != TENSOR_FLOAT64) || d64 == 0 ||
+        d64 > LOADER_MAX_FEATURES) {
+        return -1;
+    }
+    *dtype = (TensorDtype)dt;
+    *d = (size_t)d64;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+DataLoader* loader_create(const LoaderSource *src, size_t chunk_rows, size_t depth) {
+    if (!src || !src->fill || src->num_features == 0 || chunk_rows == 0) {
+        fprintf(stderr, "[loader_create] invalid arguments.\n");
+        return NULL;
+    }
+    if (depth == 0) depth = 2;
+
+    DataLoader *L = (DataLoader*)calloc(1, sizeof(DataLoader));
+    Chunk *ring = (Chunk*)calloc(depth, sizeof(Chunk));
+    int ok = L && ring;
+    for (size_t i = 0; ok && i < depth; i++) {
+        ring[i].X = tensor_empty(2, (size_t[]){ chunk_rows, src->num_features }, TENSOR_FLOAT64);
+        ring[i].y = tensor_empty(2, (size_t[]){ chunk_rows, 1 }, TENSOR_FLOAT64);
+        ok = ring[i].X && ring[i].y;
+    }
+    if (!ok) {
+        fprintf(stderr, "[loader_create] allocation failure.\n");
+        ring_free(ring, depth);
+        free(L);
+        return NULL;
+    }
+
+    L->src = *src;
+    L->chunk_rows = chunk_rows;
+    L->depth = depth;
+    L->ring = ring;
+    pthread_mutex_init(&L->lock, NULL);
+    pthread_cond_init(&L->filled, NULL);
+    pthread_cond_init(&L->freed, NULL);
+    if (pthread_create(&L->thread, NULL, reader_main, L) != 0) {
+        fprintf(stderr, "[loader_create] failed to start reader thread.\n");
+        pthread_mutex_destroy(&L->lock);
+        pthread_cond_destroy(&L->filled);
+        pthread_cond_destroy(&L->freed);
+        ring_free(ring, depth);
+        free(L);
+        return NULL;
+    }
+    return L;
+}
+
+DataLoader* loader_open_file(const char *path, size_t chunk_rows, size_t depth) {
+    if (!path) return NULL;
+    FileSource *fs = (FileSource*)calloc(1, sizeof(FileSource));
+    if (!fs) return NULL;
+    fs->f = fopen(path, "rb");
+    if (!fs->f || read_header(fs->f, &fs->dtype, &fs->d) != 0) {
+        fprintf(stderr, "[loader_open_file] cannot read dataset %s.\n", path);
+        file_close(fs);
+        return NULL;
+    }
+    fs->record_bytes = (fs->d + 1) * tensor_dtype_size(fs->dtype);
+
+    // The body must be whole records, and a chunk of them must fit in size_t
+    off_t end = -1;
+    if (fseeko(fs->f, 0, SEEK_END) == 0) end = ftello(fs->f);
+    if (end < (off_t)LOADER_HEADER_BYTES ||
+        (end - (off_t)LOADER_HEADER_BYTES) % (off_t)fs->record_bytes != 0 ||
+        fseeko(fs->f, (off_t)LOADER_HEADER_BYTES, SEEK_SET) != 0 ||
+        chunk_rows > SIZE_MAX / fs->record_bytes) {
+        fprintf(stderr, "[loader_open_file] %s is malformed.\n", path);
+        file_close(fs);
+        return NULL;
+    }
+
+    LoaderSource src = { file_fill, file_close, fs, fs->d };
+    DataLoader *L = loader_create(&src, chunk_rows, depth);
+    if (!L) file_close(fs);
+    return L;
+}
+
+void loader_free(DataLoader *L) {
+    if (!L) return;
+    pthread_mutex_lock(&L->lock);
+    L->stop = 1;
+    pthread_cond_signal(&L->freed);
+    pthread_mutex_unlock(&L->lock);
+    pthread_join(L->thread, NULL);
+
+    tensor_free(L->view_X);
+    tensor_free(L->view_y);
+    ring_free(L->ring, L->depth);
+    if (L->src.close) L->src.close(L->src.ctx);
+    pthread_mutex_destroy(&L->lock);
+    pthread_cond_destroy(&L->filled);
+    pthread_cond_destroy(&L->freed);
+    free(L);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               ITERATION                                   */
+/* ------------------------------------------------------------------------- */
+
+int loader_next(DataLoader *L, const Tensor **X, const Tensor **y) {
+    if (!L || !X || !y) return -1;
+    *X = NULL;
+    *y = NULL;
+    tensor_free(L->view_X);
+    tensor_free(L->view_y);
+    L->view_X = NULL;
+    L->view_y = NULL;
+
+    pthread_mutex_lock(&L->lock);
+    if (L->holding) release_head(L);
+    if (L->failed) {
+        pthread_mutex_unlock(&L->lock);
+        return -1;
+    }
+    if (L->count == 0) {
+        double t0 = now_ns();
+        while (L->count == 0) {
+            pthread_cond_wait(&L->filled, &L->lock);
+        }
+        L->stats.stall_ns += now_ns() - t0;
+    }
+
+    Chunk *c = &L->ring[L->head];
+    int rc;
+    if (c->status != 0) {
+        fprintf(stderr, "[loader_next] source failed.\n");
+        L->failed = 1;
+        rc = -1;
+    } else if (c->rows == 0) {
+        release_head(L);
+        L->stats.passes++;
+        rc = 0;
+    } else {
+        L->holding = 1;
+        L->stats.chunks++;
+        L->stats.rows += (long)c->rows;
+        rc = 1;
+    }
+    pthread_mutex_unlock(&L->lock);
+    if (rc != 1) return rc;
+
+    // The held slot is ours until the next call; hand out row views of it
+    size_t d = L->src.num_features;
+    L->view_X = tensor_slice(c->X, (size_t[]){0, 0}, (size_t[]){c->rows, d});
+    L->view_y = tensor_slice(c->y, (size_t[]){0, 0}, (size_t[]){c->rows, 1});
+    if (!L->view_X || !L->view_y) return -1;
+    *X = L->view_X;
+    *y = L->view_y;
+    return 1;
+}
+
+size_t loader_num_features(const DataLoader *L) {
+    return L ? L->src.num_features : 0;
+}
+
+void loader_get_stats(DataLoader *L, LoaderStats *stats) {
+    if (!L || !stats) return;
+    pthread_mutex_lock(&L->lock);
+    *stats = L->stats;
+    pthread_mutex_unlock(&L->lock);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               DATASET FILES                               */
+/* ------------------------------------------------------------------------- */
+
+int loader_write_file(const char *path, const Tensor *X, const Tensor *y,
+                      TensorDtype dtype, int append) {
+    if (!path || !X || !y || X->ndim != 2 || X->layout != TENSOR_LAYOUT_STRIDED ||
+        y->layout != TENSOR_LAYOUT_STRIDED || y->shape[0] != X->shape[0] ||
+        (dtype != TENSOR_FLOAT32 && dtype != TENSOR_FLOAT64) || X->shape[1] == 0) {
+        fprintf(stderr, "[loader_write_file] invalid arguments.\n");
+        return -1;
+    }
+    size_t n = X->shape[0];
+    size_t d = X->shape[1];
+
+    // Append only onto a file with the same layout
+    FILE *f = NULL;
+    if (append && (f = fopen(path, "rb")) != NULL) {
+        TensorDtype file_dtype;
+        size_t file_d;
+        int match = read_header(f, &file_dtype, &file_d) == 0 && file_dtype == dtype && file_d == d;
+        fclose(f);
+        if (!match) {
+            fprintf(stderr, "[loader_write_file] %s has a different layout.\n", path);
+            return -1;
+        }
+        f = fopen(path, "ab");
+    } else {
+        f = fopen(path, "wb");
+        if (f) {
+            uint32_t version = LOADER_VERSION, dt = (uint32_t)dtype;
+            uint64_t d64 = (uint64_t)d;
+            fwrite(LOADER_MAGIC, 1, sizeof(LOADER_MAGIC), f);
+            fwrite(&version, sizeof(version), 1, f);
+            fwrite(&dt, sizeof(dt), 1, f);
+            fwrite(&d64, sizeof(d64), 1, f);
+        }
+    }
+    if (!f) {
+        fprintf(stderr, "[loader_write_file] cannot open %s.\n", path);
+        return -1;
+    }
+
+    size_t elem = tensor_dtype_size(dtype);
+    size_t record_bytes = (d + 1) * elem;
+    unsigned char *rec = (unsigned char*)malloc(record_bytes);
+    int ok = rec != NULL;
+    for (size_t i = 0; ok && i < n; i++) {
+        for (size_t j = 0; j <= d; j++) {
+            double v = (j < d) ? tensor_read_at_offset(X, i * X->strides[0] + j * X->strides[1])
+                               : tensor_read_at_offset(y, i * y->strides[0]);
+            if (dtype == TENSOR_FLOAT64) {
+                memcpy(rec + j * elem, &v, elem);
+            } else {
+                float fv = (float)v;
+                memcpy(rec + j * elem, &fv, elem);
+            }
+        }
+        ok = fwrite(rec, 1, record_bytes, f) == record_bytes;
+    }
+    free(rec);
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "[loader_write_file] failed to write %s.\n", path);
+        return -1;
+    }
+    return 0;
+}
@@ -1,14 +1,28 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "lr.h"
 #include "tensor.h"  // <-- Ensure we include "tensor.h" so we know about tensor_*()
+#include "sparse.h"
+#include "compress.h"
+#include "gemv.h"
+#include "cpu.h"
+
+/** Rows per block in the fused pass over dense float64 X. */
+#define LR_BLOCK_ROWS 256
 
 /**
  * Forward pass for linear regression: y_pred = X * W + b.
  * Returns a newly allocated tensor of shape [n, 1].
  */
 Tensor* linear_forward(const Tensor *X, const Tensor *W, const Tensor *b) {
+    // Dense or compressed float64 with a scalar bias: one GEMV pass, bias folded in
+    if (X && W && b && X->layout != TENSOR_LAYOUT_CSR && X->dtype == TENSOR_FLOAT64 &&
+        W->dtype == TENSOR_FLOAT64 && b->num_elems == 1) {
+        return tensor_gemv(X, W, tensor_read_at_offset(b, 0));
+    }
+
     // 1) out = matmul(X, W) => shape=[n,1]
     Tensor *out = tensor_matmul(X, W);
     if (!out) {
@@ -45,17 +59,582 @@ double mse_loss(const Tensor *y_pred, const Tensor *y) {
 }
 
 /**
- * Train a linear regressor y_pred = X*W + b using gradient descent on MSE.
+ * Fused pass over m row-major float64 rows starting at row i0 of y:
+ * predictions by GEMV, X^T r by GEVM ('r' is scratch for m residuals).
+ */
+static void lr_accumulate_block(size_t m, size_t d, const double *blk, size_t ld,
+                                const Tensor *y, size_t i0, const double *w, double bias,
+                                double *gw, double *r, double *loss, double *sum_r) {
+    size_t sy0 = y->strides[0];
+    gemv_f64(m, d, blk, ld, w, bias, r);
+    for (size_t i = 0; i < m; i++) {
+        r[i] -= tensor_read_at_offset(y, (i0 + i) * sy0);
+        *loss += r[i] * r[i];
+        *sum_r += r[i];
+    }
+    if (gw) {
+        gevm_f64(m, d, blk, ld, r, gw);
+    }
+}
+
+/**
+ * Accumulate one row block of the fused pass at (w, bias):
+ *   r = XW + b - y,  loss += sum(r^2),  sum_r += sum(r)
+ * and, if gw is non-NULL, gw += X^T r.
+ */
+static void lr_accumulate(const Tensor *X, const Tensor *y,
+                          const double *w, double bias, double *gw,
+                          double *loss, double *sum_r) {
+    size_t n = X->shape[0];
+    size_t d = X->shape[1];
+    size_t sy0 = y->strides[0];
+
+    const CSRStorage *csr = tensor_csr(X);
+    if (csr) {
+        // Sparse X: both the prediction and the gradient touch only nonzeros
+        for (size_t i = 0; i < n; i++) {
+            size_t lo = csr->indptr[i], hi = csr->indptr[i + 1];
+            double pred = bias;
+            for (size_t k = lo; k < hi; k++) {
+                pred += csr->values[k] * w[csr->indices[k]];
+            }
+            double r = pred - tensor_read_at_offset(y, i * sy0);
+            *loss += r * r;
+            *sum_r += r;
+            if (gw) {
+                for (size_t k = lo; k < hi; k++) {
+                    gw[csr->indices[k]] += csr->values[k] * r;
+                }
+            }
+        }
+        return;
+    }
+
+    const CompressedStorage *cs = tensor_compressed(X);
+    if (cs) {
+        // Compressed X: decode one row block at a time, then as dense rows
+        double *blk = (double*)malloc((cs->block_rows * d + cs->block_rows) * sizeof(double));
+        if (!blk) {
+            fprintf(stderr, "[train_linear_regression] allocation failure.\n");
+            *loss = NAN;
+            return;
+        }
+        double *r = blk + cs->block_rows * d;
+        for (size_t k = 0; k < cs->num_blocks; k++) {
+            size_t m = tensor_compressed_decode_rows(X, k, blk);
+            lr_accumulate_block(m, d, blk, d, y, k * cs->block_rows, w, bias, gw, r, loss, sum_r);
+        }
+        free(blk);
+        return;
+    }
+
+    size_t sx0 = X->strides[0], sx1 = X->strides[1];
+    if (X->dtype == TENSOR_FLOAT64 && (sx1 == 1 || d == 1)) {
+        // Dense float64 rows, a block at a time (same summation order as
+        // the loop below)
+        const double *x = (const double*)X->data;
+        double r[LR_BLOCK_ROWS];
+        for (size_t i0 = 0; i0 < n; i0 += LR_BLOCK_ROWS) {
+            size_t m = (n - i0 < LR_BLOCK_ROWS) ? n - i0 : LR_BLOCK_ROWS;
+            lr_accumulate_block(m, d, x + i0 * sx0, sx0, y, i0, w, bias, gw, r, loss, sum_r);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        size_t row = i * sx0;
+        double pred = bias;
+        for (size_t j = 0; j < d; j++) {
+            pred += tensor_read_at_offset(X, row + j * sx1) * w[j];
+        }
+        double r = pred - tensor_read_at_offset(y, i * sy0);
+        *loss += r * r;
+        *sum_r += r;
+        if (gw) {
+            for (size_t j = 0; j < d; j++) {
+                gw[j] += tensor_read_at_offset(X, row + j * sx1) * r;
+            }
+        }
+    }
+}
+
+/** Copy W into 'w', zero the gradient and return the bias, before a pass. */
+static double lr_pass_begin(const Tensor *W, const Tensor *b, size_t d,
+                            double *w, Tensor *gW) {
+    for (size_t j = 0; j < d; j++) {
+        w[j] = tensor_read_at_offset(W, j);
+    }
+    if (gW) {
+        double *gw = (double*)gW->data;
+        for (size_t j = 0; j < d; j++) gw[j] = 0.0;
+    }
+    return tensor_read_at_offset(b, 0);
+}
+
+/** Scale the sums of a pass over n rows into the mean loss and gradients. */
+static double lr_pass_end(size_t n, size_t d, double loss, double sum_r,
+                          Tensor *gW, Tensor *gb) {
+    double scale = 2.0 / (double)n;
+    if (gW) {
+        double *gw = (double*)gW->data;
+        for (size_t j = 0; j < d; j++) gw[j] *= scale;
+    }
+    if (gb) {
+        ((double*)gb->data)[0] = scale * sum_r;
+    }
+    return loss / (double)n;
+}
+
+/**
+ * One fused pass over the row blocks of X at the current (W, b):
+ *   r = XW + b - y,  loss = mean(r^2)
+ * and, if gW/gb are non-NULL, the MSE gradients
+ *   dW = (2/n) * X^T r,  db = (2/n) * sum(r)
+ * where n is the total row count. 'w' is scratch of length d holding W
+ * as doubles.
+ */
+static double lr_loss_grad(const Tensor *const *X_parts, const Tensor *const *y_parts,
+                           size_t num_parts, const Tensor *W, const Tensor *b,
+                           double *w, Tensor *gW, Tensor *gb) {
+    size_t d = X_parts[0]->shape[1];
+    double bias = lr_pass_begin(W, b, d, w, gW);
+    double *gw = gW ? (double*)gW->data : NULL;
+
+    size_t n = 0;
+    double loss = 0.0;
+    double sum_r = 0.0;
+    for (size_t p = 0; p < num_parts; p++) {
+        lr_accumulate(X_parts[p], y_parts[p], w, bias, gw, &loss, &sum_r);
+        n += X_parts[p]->shape[0];
+    }
+    return lr_pass_end(n, d, loss, sum_r, gW, gb);
+}
+
+/**
+ * A training set the full-batch loop can evaluate: fills the loss (and
+ * gradients, if gW/gb are non-NULL) over all rows at the current (W, b),
+ * with the conventions of lr_loss_grad(). Returns NaN on failure.
+ */
+typedef double (*LossGradFn)(void *data, const Tensor *W, const Tensor *b,
+                             double *w, Tensor *gW, Tensor *gb);
+
+/** In-memory row blocks. */
+typedef struct {
+    const Tensor *const *X_parts;
+    const Tensor *const *y_parts;
+    size_t        num_parts;
+} PartsData;
+
+static double parts_loss_grad(void *data, const Tensor *W, const Tensor *b,
+                              double *w, Tensor *gW, Tensor *gb) {
+    PartsData *pd = (PartsData*)data;
+    return lr_loss_grad(pd->X_parts, pd->y_parts, pd->num_parts, W, b, w, gW, gb);
+}
+
+/** Rows streamed by a loader; one evaluation consumes one pass. */
+typedef struct {
+    DataLoader *loader;
+    int         failed;
+} StreamData;
+
+static double stream_loss_grad(void *data, const Tensor *W, const Tensor *b,
+                               double *w, Tensor *gW, Tensor *gb) {
+    StreamData *sd = (StreamData*)data;
+    size_t d = loader_num_features(sd->loader);
+    double bias = lr_pass_begin(W, b, d, w, gW);
+    double *gw = gW ? (double*)gW->data : NULL;
+
+    size_t n = 0;
+    double loss = 0.0;
+    double sum_r = 0.0;
+    const Tensor *X, *y;
+    int rc;
+    while ((rc = loader_next(sd->loader, &X, &y)) == 1) {
+        lr_accumulate(X, y, w, bias, gw, &loss, &sum_r);
+        n += X->shape[0];
+    }
+    if (rc != 0 || n == 0) {
+        sd->failed = 1;
+        return NAN;
+    }
+    return lr_pass_end(n, d, loss, sum_r, gW, gb);
+}
+
+/** Line-search callback: loss at the current parameters, no gradients. */
+typedef struct {
+    LossGradFn    fn;
+    void         *data;
+    const Tensor *W;
+    const Tensor *b;
+    double       *w;
+} LossContext;
+
+static double lr_loss_callback(void *ctx) {
+    LossContext *c = (LossContext*)ctx;
+    return c->fn(c->data, c->W, c->b, c->w, NULL, NULL);
+}
+
+TrainConfig train_default_config(void) {
+    TrainConfig cfg;
+    cfg.optim = optimizer_default_config(OPTIM_SGD);
+    cfg.max_epochs = 1000;
+    cfg.loss_tol = 0.0;
+    cfg.grad_tol = 0.0;
+    cfg.verbose = 0;
+    cfg.checkpoint = NULL;
+    cfg.checkpoint_every = 0;
+    cfg.resume_path = NULL;
+    return cfg;
+}
+
+/**
+ * Tensors making up a training checkpoint, in file order:
+ *   W, b, meta = [optimizer step, optimizer last_lr, previous loss],
+ *   then the optimizer's per-parameter state tensors, if any.
+ * Returns the number of entries written to 'out' (at most 7).
+ */
+static size_t checkpoint_tensors(Tensor *W, Tensor *b, Tensor *meta,
+                                 const Optimizer *opt, Tensor **out) {
+    size_t k = 0;
+    out[k++] = W;
+    out[k++] = b;
+    out[k++] = meta;
+    for (size_t p = 0; p < opt->num_params; p++) {
+        if (opt->state1) out[k++] = opt->state1[p];
+    }
+    for (size_t p = 0; p < opt->num_params; p++) {
+        if (opt->state2) out[k++] = opt->state2[p];
+    }
+    return k;
+}
+
+/** Per-run training state shared by the full-batch and mini-batch loops. */
+typedef struct {
+    Tensor    *gW;
+    Tensor    *gb;
+    double    *w;
+    Tensor    *meta;
+    Optimizer *opt;
+    Tensor    *ckpt[7];
+    size_t     num_ckpt;
+} TrainWorkspace;
+
+static void workspace_free(TrainWorkspace *ws) {
+    tensor_free(ws->gW);
+    tensor_free(ws->gb);
+    free(ws->w);
+    tensor_free(ws->meta);
+    optimizer_free(ws->opt);
+}
+
+/** Allocate everything a run needs, once. */
+static int workspace_init(TrainWorkspace *ws, size_t d, Tensor *W, Tensor *b,
+                          const TrainConfig *cfg) {
+    size_t shapeG[2] = { d, 1 };
+    ws->gW = tensor_create(2, shapeG, TENSOR_FLOAT64);
+    ws->gb = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    ws->w = (double*)malloc(d * sizeof(double));
+    ws->meta = tensor_create(1, (size_t[]){3}, TENSOR_FLOAT64);
+    Tensor *params[2] = { W, b };
+    ws->opt = optimizer_create(&cfg->optim, params, 2);
+    if (!ws->gW || !ws->gb || !ws->w || !ws->meta || !ws->opt) {
+        fprintf(stderr, "[train_linear_regression] allocation failure.\n");
+        workspace_free(ws);
+        return -1;
+    }
+    ws->num_ckpt = checkpoint_tensors(W, b, ws->meta, ws->opt, ws->ckpt);
+    return 0;
+}
+
+/**
+ * Resume W, b, optimizer state and progress from cfg->resume_path.
+ * Returns the epoch to start from (0 if there is nothing to resume).
+ */
+static long workspace_resume(TrainWorkspace *ws, const TrainConfig *cfg, double *prev_loss) {
+    if (!cfg->resume_path) return 0;
+    long start = 0;
+    double *meta_v = (double*)ws->meta->data;
+    if (checkpoint_load(cfg->resume_path, &start, ws->ckpt, ws->num_ckpt) == 0) {
+        ws->opt->step = (long)meta_v[0];
+        ws->opt->last_lr = meta_v[1];
+        *prev_loss = meta_v[2];
+        if (cfg->verbose) {
+            printf("Resumed from %s at epoch %ld\n", cfg->resume_path, start);
+        }
+        return start;
+    }
+    if (cfg->verbose) {
+        printf("No usable checkpoint at %s, starting fresh\n", cfg->resume_path);
+    }
+    return 0;
+}
+
+/** Hand a snapshot to the background writer. */
+static void workspace_snapshot(TrainWorkspace *ws, const TrainConfig *cfg,
+                               long epoch, double prev_loss) {
+    double *meta_v = (double*)ws->meta->data;
+    meta_v[0] = (double)ws->opt->step;
+    meta_v[1] = ws->opt->last_lr;
+    meta_v[2] = prev_loss;
+    checkpoint_submit(cfg->checkpoint, epoch, ws->ckpt, ws->num_ckpt);
+}
+
+/** Stop test shared by both loops; sets res->converged. */
+static int lr_converged(const TrainConfig *cfg, TrainResult *res, int e,
+                        double prev_loss, double loss_val) {
+    if (cfg->grad_tol > 0.0 && res->grad_norm <= cfg->grad_tol) {
+        res->converged = 1;
+    }
+    if (cfg->loss_tol > 0.0 && e > 0 &&
+        fabs(prev_loss - loss_val) <= cfg->loss_tol * fmax(1.0, fabs(prev_loss))) {
+        res->converged = 1;
+    }
+    if (res->converged && cfg->verbose) {
+        printf("Converged at epoch %d, Loss = %.6f\n", e, loss_val);
+    }
+    return res->converged;
+}
+
+/**
+ * Train a linear regressor y_pred = X*W + b on MSE.
  *
- * We'll do:
- *   y_pred = X*W + b
- *   loss = mean((y - y_pred)^2)
+ * Per epoch:
+ *   (1) fused pass => loss, dW, db
+ *   (2) stop if the gradient norm or the relative loss change is under
+ *       tolerance (parameters are left at the point the loss was measured)
+ *   (3) optimizer step on W and b
+ *   (4) every 'checkpoint_every' epochs, hand a snapshot to the
+ *       background writer (memory copy only; disk I/O is off-thread)
+ */
+static int lr_train_full_batch(LossGradFn fn, void *data, size_t d,
+                               Tensor *W, Tensor *b, const TrainConfig *cfg,
+                               TrainResult *result) {
+    TrainWorkspace ws;
+    if (workspace_init(&ws, d, W, b, cfg) != 0) return -1;
+    Tensor *grads[2] = { ws.gW, ws.gb };
+    LossContext ctx = { fn, data, W, b, ws.w };
+
+    TrainResult res = { 0, 0.0, 0.0, 0 };
+    double prev_loss = 0.0;
+    long start = workspace_resume(&ws, cfg, &prev_loss);
+    res.epochs_run = (int)start;
+
+    for (int e = (int)start; e < cfg->max_epochs; e++) {
+        // (1) Loss and gradients in one pass
+        double loss_val = fn(data, W, b, ws.w, ws.gW, ws.gb);
+        double gnorm2 = 0.0;
+        for (size_t j = 0; j < d; j++) {
+            double g = ((double*)ws.gW->data)[j];
+            gnorm2 += g * g;
+        }
+        double gb_val = ((double*)ws.gb->data)[0];
+        gnorm2 += gb_val * gb_val;
+
+        res.final_loss = loss_val;
+        res.grad_norm = sqrt(gnorm2);
+
+        if (cfg->verbose && (e % 100 == 0 || e == cfg->max_epochs - 1)) {
+            printf("Epoch %d, Loss = %.6f\n", e, loss_val);
+        }
+        if (!isfinite(loss_val)) {
+            fprintf(stderr, "[train_linear_regression] loss diverged at epoch %d.\n", e);
+            break;
+        }
+
+        // (2) Convergence checks
+        if (lr_converged(cfg, &res, e, prev_loss, loss_val)) break;
+
+        // (3) Update W, b (1: line search found no descent step, W, b unchanged)
+        if (optimizer_step(ws.opt, grads, loss_val, lr_loss_callback, &ctx) != 0) {
+            break;
+        }
+        res.epochs_run++;
+        prev_loss = loss_val;
+
+        // (4) Snapshot for the background writer
+        if (cfg->checkpoint && cfg->checkpoint_every > 0 && (e + 1) % cfg->checkpoint_every == 0) {
+            workspace_snapshot(&ws, cfg, e + 1, prev_loss);
+        }
+    }
+
+    if (cfg->checkpoint && cfg->checkpoint_every > 0) {
+        workspace_snapshot(&ws, cfg, res.epochs_run, prev_loss);
+    }
+
+    if (result) *result = res;
+    workspace_free(&ws);
+    return 0;
+}
+
+int train_linear_regression_parts(
+    const Tensor *const *X_parts,
+    const Tensor *const *y_parts,
+    size_t num_parts,
+    Tensor *W,
+    Tensor *b,
+    const TrainConfig *cfg,
+    TrainResult *result
+) {
+    if (!X_parts || !y_parts || num_parts == 0 || !W || !b || !cfg) {
+        fprintf(stderr, "[train_linear_regression] invalid arguments.\n");
+        return -1;
+    }
+    size_t n = 0;
+    size_t d = X_parts[0] ? X_parts[0]->shape[1] : 0;
+    for (size_t p = 0; p < num_parts; p++) {
+        const Tensor *Xp = X_parts[p], *yp = y_parts[p];
+        if (!Xp || !yp || Xp->ndim != 2 || Xp->shape[1] != d ||
+            yp->layout != TENSOR_LAYOUT_STRIDED || yp->shape[0] != Xp->shape[0]) {
+            fprintf(stderr, "[train_linear_regression] row block %zu does not match.\n", p);
+            return -1;
+        }
+        n += Xp->shape[0];
+    }
+    if (n == 0 || W->layout != TENSOR_LAYOUT_STRIDED || b->layout != TENSOR_LAYOUT_STRIDED ||
+        W->num_elems != d || b->num_elems != 1) {
+        fprintf(stderr, "[train_linear_regression] shape mismatch.\n");
+        return -1;
+    }
+
+    PartsData data = { X_parts, y_parts, num_parts };
+    return lr_train_full_batch(parts_loss_grad, &data, d, W, b, cfg, result);
+}
+
+int train_linear_regression_ex(
+    const Tensor *X,
+    const Tensor *y,
+    Tensor *W,
+    Tensor *b,
+    const TrainConfig *cfg,
+    TrainResult *result
+) {
+    return train_linear_regression_parts(&X, &y, 1, W, b, cfg, result);
+}
+
+/**
+ * Mini-batch training over a loader: every chunk is one batch.
+ *
+ * Per epoch (one pass over the loader):
+ *   for each chunk: fused pass => chunk loss, dW, db; optimizer step
+ *   then the epoch loss and gradient are the row-weighted means of the
+ *   per-chunk values (each measured just before its step), and the same
+ *   tolerance and checkpoint rules as the full-batch loop apply.
+ */
+static int lr_train_mini_batch(DataLoader *loader, size_t d, Tensor *W, Tensor *b,
+                               const TrainConfig *cfg, TrainResult *result) {
+    TrainWorkspace ws;
+    if (workspace_init(&ws, d, W, b, cfg) != 0) return -1;
+    double *gsum = (double*)malloc((d + 1) * sizeof(double));
+    if (!gsum) {
+        workspace_free(&ws);
+        return -1;
+    }
+    Tensor *grads[2] = { ws.gW, ws.gb };
+    const Tensor *X, *y;
+    PartsData chunk = { &X, &y, 1 };
+    LossContext ctx = { parts_loss_grad, &chunk, W, b, ws.w };
+
+    TrainResult res = { 0, 0.0, 0.0, 0 };
+    double prev_loss = 0.0;
+    long start = workspace_resume(&ws, cfg, &prev_loss);
+    res.epochs_run = (int)start;
+    int rc = 0;
+
+    for (int e = (int)start; e < cfg->max_epochs; e++) {
+        // (1) One optimizer step per chunk
+        size_t n = 0;
+        double loss_sum = 0.0;
+        int ok = 1;
+        for (size_t j = 0; j <= d; j++) gsum[j] = 0.0;
+        while ((rc = loader_next(loader, &X, &y)) == 1) {
+            if (!ok) continue;   // drain the pass after a failed step
+            size_t rows = X->shape[0];
+            double loss_c = lr_loss_grad(&X, &y, 1, W, b, ws.w, ws.gW, ws.gb);
+            loss_sum += loss_c * (double)rows;
+            for (size_t j = 0; j < d; j++) {
+                gsum[j] += ((double*)ws.gW->data)[j] * (double)rows;
+            }
+            gsum[d] += ((double*)ws.gb->data)[0] * (double)rows;
+            n += rows;
+            ok = isfinite(loss_c) &&
+                 optimizer_step(ws.opt, grads, loss_c, lr_loss_callback, &ctx) >= 0;
+        }
+        if (rc != 0 || n == 0) {
+            rc = -1;
+            break;
+        }
+
+        double loss_val = loss_sum / (double)n;
+        double gnorm2 = 0.0;
+        for (size_t j = 0; j <= d; j++) {
+            double g = gsum[j] / (double)n;
+            gnorm2 += g * g;
+        }
+        res.final_loss = loss_val;
+        res.grad_norm = sqrt(gnorm2);
+
+        if (cfg->verbose && (e % 100 == 0 || e == cfg->max_epochs - 1)) {
+            printf("Epoch %d, Loss = %.6f\n", e, loss_val);
+        }
+        if (!ok || !isfinite(loss_val)) {
+            fprintf(stderr, "[train_linear_regression_stream] step failed or loss diverged at epoch %d.\n", e);
+            break;
+        }
+        res.epochs_run++;
+
+        // (2) Convergence checks, after this epoch's steps
+        int stop = lr_converged(cfg, &res, e, prev_loss, loss_val);
+        prev_loss = loss_val;
+
+        // (3) Snapshot for the background writer
+        if (cfg->checkpoint && cfg->checkpoint_every > 0 && (e + 1) % cfg->checkpoint_every == 0) {
+            workspace_snapshot(&ws, cfg, e + 1, prev_loss);
+        }
+        if (stop) break;
+    }
+
+    if (rc == 0 && cfg->checkpoint && cfg->checkpoint_every > 0) {
+        workspace_snapshot(&ws, cfg, res.epochs_run, prev_loss);
+    }
+
+    if (result) *result = res;
+    free(gsum);
+    workspace_free(&ws);
+    return rc;
+}
+
+int train_linear_regression_stream(
+    DataLoader *loader,
+    TrainBatching batching,
+    Tensor *W,
+    Tensor *b,
+    const TrainConfig *cfg,
+    TrainResult *result
+) {
+    if (!loader || !W || !b || !cfg) {
+        fprintf(stderr, "[train_linear_regression_stream] invalid arguments.\n");
+        return -1;
+    }
+    size_t d = loader_num_features(loader);
+    if (W->num_elems != d || b->num_elems != 1) {
+        fprintf(stderr, "[train_linear_regression_stream] shape mismatch.\n");
+        return -1;
+    }
+
+    if (batching == TRAIN_MINI_BATCH) {
+        return lr_train_mini_batch(loader, d, W, b, cfg, result);
+    }
+    StreamData data = { loader, 0 };
+    int rc = lr_train_full_batch(stream_loss_grad, &data, d, W, b, cfg, result);
+    return data.failed ? -1 : rc;
+}
+
+/**
+ * Train a linear regressor y_pred = X*W + b using gradient descent on MSE
+ * with a fixed learning rate and epoch count.
  *
  * Gradient wrt W: dW = (2/n) * X^T * (XW + b - y)
  * Gradient wrt b: db = (2/n) * sum( (XW + b - y) )
- *
- * We'll implement a naive approach using the tensor ops we have, 
- * ignoring in-place for clarity. 
  */
 void train_linear_regression(
     const Tensor *X,
@@ -66,80 +645,262 @@ void train_linear_regression(
     int epochs,
     int verbose
 ) {
-    // Basic checks omitted for brevity (see your original code).
-    // ...
+    TrainConfig cfg = train_default_config();
+    cfg.optim.lr = lr;
+    cfg.max_epochs = epochs;
+    cfg.verbose = verbose;
+    train_linear_regression_ex(X, y, W, b, &cfg, NULL);
+}
+
+/** Batched workspace: parameters and gradients in [d, K], the active
+ *  columns packed for the block products, and per-model accumulators. */
+typedef struct {
+    double *w, *g, *bias, *gb, *loss, *prev;
+    double *wa;     // active columns of w, [d, A]
+    double *ga;     // X^T R of the active models, [A, d]
+    double *gt;     // one block's R^T X, [A, d]
+    double *P;      // one block's predictions, then residuals, [m, A]
+    double *rt;     // P transposed, [A, m]
+    double *xb;     // row block copied to float64, for the generic path
+    size_t *active;
+} BatchWork;
+
+static void batch_work_free(BatchWork *bw) {
+    free(bw->w); free(bw->g); free(bw->bias); free(bw->gb); free(bw->loss);
+    free(bw->prev); free(bw->wa); free(bw->ga); free(bw->gt); free(bw->P);
+    free(bw->rt); free(bw->xb); free(bw->active);
+}
 
+/**
+ * One pass over X for the A = num_active models in bw->active, a row
+ * block at a time with rows as contiguous float64 ('blk', leading
+ * dimension 'ld'):
+ *   P = X_blk Wa ([m, d] x [d, A]),  r_ik = P_ik + b_k - y_ik
+ *   loss_k += r_ik^2,  gb_k += r_ik,  Ga += R^T X_blk ([A, m] x [m, d])
+ * X rows that are not contiguous float64 are first copied into bw->xb.
+ */
+static void batch_pass(const Tensor *X, const Tensor *Y, size_t ky, size_t K,
+                       BatchWork *bw, size_t num_active) {
+    const CpuKernels *kern = cpu_kernels();
+    size_t n = X->shape[0], d = X->shape[1], A = num_active;
+    size_t sx0 = X->strides[0], sx1 = X->strides[1];
+    size_t sy0 = Y->strides[0], sy1 = (Y->ndim == 2) ? Y->strides[1] : 0;
+    int direct = X->dtype == TENSOR_FLOAT64 && (sx1 == 1 || d == 1);
+
+    for (size_t j = 0; j < d; j++) {
+        for (size_t a = 0; a < A; a++) bw->wa[j * A + a] = bw->w[j * K + bw->active[a]];
+    }
+    memset(bw->ga, 0, A * d * sizeof(double));
+
+    for (size_t i0 = 0; i0 < n; i0 += LR_BLOCK_ROWS) {
+        size_t m = (n - i0 < LR_BLOCK_ROWS) ? n - i0 : LR_BLOCK_ROWS;
+        const double *blk;
+        size_t ld;
+        if (direct) {
+            blk = (const double*)X->data + i0 * sx0;
+            ld = sx0;
+        } else {
+            for (size_t i = 0; i < m; i++) {
+                for (size_t j = 0; j < d; j++) {
+                    bw->xb[i * d + j] = tensor_read_at_offset(X, (i0 + i) * sx0 + j * sx1);
+                }
+            }
+            blk = bw->xb;
+            ld = d;
+        }
+
+        kern->gemm_f64(m, A, d, blk, ld, bw->wa, A, bw->P, A);
+        for (size_t i = 0; i < m; i++) {
+            size_t yrow = (i0 + i) * sy0;
+            for (size_t a = 0; a < A; a++) {
+                size_t k = bw->active[a];
+                double target = tensor_read_at_offset(Y, yrow + (ky == 1 ? 0 : k * sy1));
+                double r = bw->P[i * A + a] + bw->bias[k] - target;
+                bw->rt[a * m + i] = r;
+                bw->loss[k] += r * r;
+                bw->gb[k] += r;
+            }
+        }
+        kern->gemm_f64(A, d, m, bw->rt, m, blk, ld, bw->gt, d);
+        for (size_t t = 0; t < A * d; t++) bw->ga[t] += bw->gt[t];
+    }
+
+    for (size_t a = 0; a < A; a++) {
+        size_t k = bw->active[a];
+        for (size_t j = 0; j < d; j++) bw->g[j * K + k] = bw->ga[a * d + j];
+    }
+}
+
+/**
+ * Batched gradient descent over K models sharing X.
+ *
+ * Per epoch, one blocked pass over the rows of X (batch_pass) gives each
+ * active model's squared-error sum and X^T r; the per-model loss,
+ * stopping test and update follow. Parameters live in double scratch
+ * (row-major [d, K]) during training and are written back at the end.
+ */
+int train_linear_regression_batched(
+    const Tensor *X,
+    const Tensor *Y,
+    Tensor *W,
+    Tensor *b,
+    const BatchTrainConfig *cfg,
+    TrainResult *results,
+    Tensor *loss_history
+) {
+    if (!X || !Y || !W || !b || !cfg || !cfg->lr || X->ndim != 2 || W->ndim != 2 ||
+        X->layout != TENSOR_LAYOUT_STRIDED || Y->layout != TENSOR_LAYOUT_STRIDED ||
+        W->layout != TENSOR_LAYOUT_STRIDED || b->layout != TENSOR_LAYOUT_STRIDED ||
+        !(b->flags & TENSOR_FLAG_C_CONTIGUOUS)) {
+        fprintf(stderr, "[train_linear_regression_batched] invalid arguments.\n");
+        return -1;
+    }
     size_t n = X->shape[0];
     size_t d = X->shape[1];
+    size_t K = W->shape[1];
+    size_t ky = (Y->ndim == 2) ? Y->shape[1] : 1;
+    if (n == 0 || K == 0 || Y->shape[0] != n || W->shape[0] != d || b->num_elems != K ||
+        (ky != K && ky != 1)) {
+        fprintf(stderr, "[train_linear_regression_batched] shape mismatch.\n");
+        return -1;
+    }
+    if (loss_history && (loss_history->layout != TENSOR_LAYOUT_STRIDED ||
+                         loss_history->ndim != 2 ||
+                         loss_history->shape[0] != (size_t)cfg->max_epochs ||
+                         loss_history->shape[1] != K)) {
+        fprintf(stderr, "[train_linear_regression_batched] loss_history must be [max_epochs, K].\n");
+        return -1;
+    }
 
-    for (int e = 0; e < epochs; e++) {
-        // (1) Forward pass
-        Tensor *y_pred = linear_forward(X, W, b); // shape=[n,1]
-        
-        // (2) Compute loss
-        double loss_val = mse_loss(y_pred, y);
-        
-        // (3) Gradients:
-        // diff = (y_pred - y)
-        Tensor *diff = tensor_sub(y_pred, y);
-        
-        double scale = 2.0 / (double)n;
-        double sum_diff = tensor_sum(diff);
-        double grad_b_val = scale * sum_diff; // scalar grad wrt b
-        
-        // Build X^T => shape=[d,n]
-        size_t shapeXT[2] = { d, n };
-        Tensor *X_trans = tensor_create(2, shapeXT, X->dtype);
-        if (!X_trans) {
-            fprintf(stderr, "[train_linear_regression] Failed to alloc X_trans.\n");
-            tensor_free(y_pred);
-            tensor_free(diff);
-            return;
+    // Workspace: parameters, gradients, per-model accumulators, block buffers
+    size_t mb = (n < LR_BLOCK_ROWS) ? n : LR_BLOCK_ROWS;
+    BatchWork bw = {
+        .w = (double*)malloc(d * K * sizeof(double)),
+        .g = (double*)malloc(d * K * sizeof(double)),
+        .bias = (double*)malloc(K * sizeof(double)),
+        .gb = (double*)malloc(K * sizeof(double)),
+        .loss = (double*)malloc(K * sizeof(double)),
+        .prev = (double*)malloc(K * sizeof(double)),
+        .wa = (double*)malloc(d * K * sizeof(double)),
+        .ga = (double*)malloc(d * K * sizeof(double)),
+        .gt = (double*)malloc(d * K * sizeof(double)),
+        .P = (double*)malloc(mb * K * sizeof(double)),
+        .rt = (double*)malloc(mb * K * sizeof(double)),
+        .xb = (double*)malloc(mb * d * sizeof(double)),
+        .active = (size_t*)malloc(K * sizeof(size_t)),
+    };
+    TrainResult *res = (TrainResult*)calloc(K, sizeof(TrainResult));
+    if (!bw.w || !bw.g || !bw.bias || !bw.gb || !bw.loss || !bw.prev || !bw.wa || !bw.ga ||
+        !bw.gt || !bw.P || !bw.rt || !bw.xb || !bw.active || !res) {
+        fprintf(stderr, "[train_linear_regression_batched] allocation failure.\n");
+        batch_work_free(&bw);
+        free(res);
+        return -1;
+    }
+    double *w = bw.w, *g = bw.g, *bias = bw.bias, *gb = bw.gb, *loss = bw.loss, *prev = bw.prev;
+    size_t *active = bw.active;
+
+    for (size_t j = 0; j < d; j++) {
+        for (size_t k = 0; k < K; k++) {
+            w[j * K + k] = tensor_read_at_offset(W, j * W->strides[0] + k * W->strides[1]);
         }
-        // fill X_trans
-        for (size_t i = 0; i < n; i++) {
+    }
+    for (size_t k = 0; k < K; k++) {
+        bias[k] = tensor_read_at_offset(b, k);
+        active[k] = k;
+    }
+    size_t num_active = K;
+
+    size_t sh0 = loss_history ? loss_history->strides[0] : 0;
+    size_t sh1 = loss_history ? loss_history->strides[1] : 0;
+    double scale = 2.0 / (double)n;
+
+    for (int e = 0; e < cfg->max_epochs && num_active > 0; e++) {
+        for (size_t a = 0; a < num_active; a++) {
+            size_t k = active[a];
+            loss[k] = 0.0;
+            gb[k] = 0.0;
+        }
+
+        // (1) One pass over X: forward, residual, loss and X^T R for all models
+        batch_pass(X, Y, ky, K, &bw, num_active);
+        // (2) Per-model loss, gradient, stopping and update
+        size_t still_active = 0;
+        for (size_t a = 0; a < num_active; a++) {
+            size_t k = active[a];
+            double l2 = cfg->l2 ? cfg->l2[k] : 0.0;
+            double wnorm2 = 0.0;
+            double gnorm2 = 0.0;
+            for (size_t j = 0; j < d; j++) {
+                double wk = w[j * K + k];
+                double gk = scale * g[j * K + k] + 2.0 * l2 * wk;
+                g[j * K + k] = gk;
+                wnorm2 += wk * wk;
+                gnorm2 += gk * gk;
+            }
+            gb[k] *= scale;
+            gnorm2 += gb[k] * gb[k];
+            loss[k] = loss[k] / (double)n + l2 * wnorm2;
+
+            res[k].final_loss = loss[k];
+            res[k].grad_norm = sqrt(gnorm2);
+            if (loss_history) {
+                tensor_write_at_offset(loss_history, (size_t)e * sh0 + k * sh1, loss[k]);
+            }
+
+            int stop = !isfinite(loss[k]);
+            if (cfg->grad_tol > 0.0 && res[k].grad_norm <= cfg->grad_tol) {
+                res[k].converged = 1;
+            }
+            if (cfg->loss_tol > 0.0 && e > 0 &&
+                fabs(prev[k] - loss[k]) <= cfg->loss_tol * fmax(1.0, fabs(prev[k]))) {
+                res[k].converged = 1;
+            }
+            if (stop || res[k].converged) {
+                if (cfg->verbose) {
+                    printf("Model %zu stopped at epoch %d, Loss = %.6f\n", k, e, loss[k]);
+                }
+                continue;
+            }
+
+            double lr = cfg->lr[k];
             for (size_t j = 0; j < d; j++) {
-                size_t idxX[2] = { i, j };
-                double val = tensor_get(X, idxX);
-                
-                size_t idxXT[2] = { j, i };
-                tensor_set(X_trans, idxXT, val);
+                w[j * K + k] -= lr * g[j * K + k];
             }
+            bias[k] -= lr * gb[k];
+            prev[k] = loss[k];
+            res[k].epochs_run++;
+            active[still_active++] = k;
         }
-        
-        // grad_w_raw = X^T * diff => shape=[d,1]
-        Tensor *grad_w_raw = tensor_matmul(X_trans, diff);
-        
-        // scale each element in grad_w_raw => multiply by scale
-        // We'll do a naive loop over its elements:
-        for (size_t i = 0; i < grad_w_raw->num_elems; i++) {
-            double old_val = tensor_read_at_offset(grad_w_raw, i);
-            double new_val = old_val * scale;
-            tensor_write_at_offset(grad_w_raw, i, new_val);
-        }
-        
-        // (4) Update W, b
-        // W := W - lr * grad_w_raw
-        for (size_t i = 0; i < W->num_elems; i++) {
-            double wv = tensor_read_at_offset(W, i);
-            double gw = tensor_read_at_offset(grad_w_raw, i);
-            wv -= (lr * gw);
-            tensor_write_at_offset(W, i, wv);
-        }
-        // b := b - lr * grad_b_val
-        double b_old = tensor_read_at_offset(b, 0); // offset=0 for shape=[1]
-        double b_new = b_old - (lr * grad_b_val);
-        tensor_write_at_offset(b, 0, b_new);
-        
-        // (5) Print progress if desired
-        if (verbose && (e % 100 == 0 || e == epochs - 1)) {
-            printf("Epoch %d, Loss = %.6f\n", e, loss_val);
+        num_active = still_active;
+
+        if (cfg->verbose && (e % 100 == 0 || e == cfg->max_epochs - 1)) {
+            printf("Epoch %d, %zu/%zu models active\n", e, num_active, K);
+        }
+    }
+
+    // NaN-fill history rows after each model stopped
+    if (loss_history) {
+        for (size_t k = 0; k < K; k++) {
+            for (int e = res[k].epochs_run + 1; e < cfg->max_epochs; e++) {
+                tensor_write_at_offset(loss_history, (size_t)e * sh0 + k * sh1, NAN);
+            }
+        }
+    }
+
+    for (size_t j = 0; j < d; j++) {
+        for (size_t k = 0; k < K; k++) {
+            tensor_write_at_offset(W, j * W->strides[0] + k * W->strides[1], w[j * K + k]);
         }
-        
-        // cleanup
-        tensor_free(y_pred);
-        tensor_free(diff);
-        tensor_free(X_trans);
-        tensor_free(grad_w_raw);
     }
+    for (size_t k = 0; k < K; k++) {
+        tensor_write_at_offset(b, k, bias[k]);
+    }
+    if (results) {
+        memcpy(results, res, K * sizeof(TrainResult));
+    }
+
+    batch_work_free(&bw);
+    free(res);
+    return 0;
 }
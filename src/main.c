@@ -3,13 +3,32 @@
 #include <string.h>
 #include <assert.h>
 #include "test_lr.h"
+#include "test_tensor.h"
 
 int main(void) {
-    int status = test_linear_regression();
+    int status = test_tensor_views();
+    status |= test_sparse_csr();
+    status |= test_unary_ops();
+    status |= test_tensor_alloc();
+    status |= test_parallel_runtime();
+    status |= test_gemv_kernels();
+    status |= test_compressed_storage();
+    status |= test_cpu_dispatch();
+    status |= test_random_tensors();
+    status |= test_gather_scatter();
+    status |= test_optimizers();
+    status |= test_online_rls();
+    status |= test_rolling_regression();
+    status |= test_batched_training();
+    status |= test_checkpoint_resume();
+    status |= test_cross_validation();
+    status |= test_streaming_loader();
+    status |= test_elastic_net();
+    status |= test_linear_regression();
     if (status == 0) {
         printf("All tests passed.\n");
     } else {
         printf("Some tests failed.\n");
     }
-    return 0;
+    return status ? EXIT_FAILURE : EXIT_SUCCESS;
 }
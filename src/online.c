@@ -0,0 +1,232 @@
+#include "online.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/** File header for rls_save()/rls_load(). */
+static const char RLS_MAGIC[4] = { 'R', 'L', 'S', '1' };
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+OnlineRLS* rls_create(size_t d, double lambda, double delta) {
+    if (d == 0 || !(lambda > 0.0 && lambda <= 1.0) || !(delta > 0.0)) {
+        fprintf(stderr, "[rls_create] invalid arguments.\n");
+        return NULL;
+    }
+    OnlineRLS *m = (OnlineRLS*)calloc(1, sizeof(OnlineRLS));
+    if (!m) return NULL;
+    m->d = d;
+    m->lambda = lambda;
+
+    size_t p = d + 1;
+    m->P = tensor_create(2, (size_t[]){p, p}, TENSOR_FLOAT64);
+    m->theta = tensor_create(2, (size_t[]){p, 1}, TENSOR_FLOAT64);
+    m->z = (double*)malloc(p * sizeof(double));
+    m->Pz = (double*)malloc(p * sizeof(double));
+    if (!m->P || !m->theta || !m->z || !m->Pz) {
+        fprintf(stderr, "[rls_create] allocation failure.\n");
+        rls_free(m);
+        return NULL;
+    }
+
+    double *P = (double*)m->P->data;
+    for (size_t i = 0; i < p; i++) {
+        P[i * p + i] = delta;
+    }
+    return m;
+}
+
+void rls_free(OnlineRLS *m) {
+    if (!m) return;
+    tensor_free(m->P);
+    tensor_free(m->theta);
+    free(m->z);
+    free(m->Pz);
+    free(m);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                UPDATES                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Standard RLS recursion on the augmented row z = [x, 1]:
+ *   Pz = P z,  k = Pz / (lambda + z^T P z)
+ *   e  = y - theta^T z
+ *   theta += k e
+ *   P  = (P - k Pz^T) / lambda
+ * P is updated on the upper triangle and mirrored, which keeps it exactly
+ * symmetric and avoids the slow drift of the naive full update.
+ */
+double rls_update(OnlineRLS *m, const double *x, double y) {
+    size_t p = m->d + 1;
+    double *P = (double*)m->P->data;
+    double *theta = (double*)m->theta->data;
+    double *z = m->z;
+    double *Pz = m->Pz;
+
+    memcpy(z, x, m->d * sizeof(double));
+    z[m->d] = 1.0;
+
+    double zPz = 0.0;
+    double pred = 0.0;
+    for (size_t i = 0; i < p; i++) {
+        const double *Prow = P + i * p;
+        double acc = 0.0;
+        for (size_t j = 0; j < p; j++) {
+            acc += Prow[j] * z[j];
+        }
+        Pz[i] = acc;
+        zPz += z[i] * acc;
+        pred += theta[i] * z[i];
+    }
+
+    double err = y - pred;
+    double denom = m->lambda + zPz;
+    double inv_denom = 1.0 / denom;
+    double inv_lambda = 1.0 / m->lambda;
+
+    for (size_t i = 0; i < p; i++) {
+        theta[i] += Pz[i] * inv_denom * err;
+    }
+    for (size_t i = 0; i < p; i++) {
+        double ki = Pz[i] * inv_denom;
+        for (size_t j = i; j < p; j++) {
+            double v = (P[i * p + j] - ki * Pz[j]) * inv_lambda;
+            P[i * p + j] = v;
+            P[j * p + i] = v;
+        }
+    }
+
+    m->count++;
+    return err;
+}
+
+int rls_update_batch(OnlineRLS *m, const Tensor *X, const Tensor *y) {
+    if (!m || !X || !y || X->layout != TENSOR_LAYOUT_STRIDED || y->layout != TENSOR_LAYOUT_STRIDED) {
+        fprintf(stderr, "[rls_update_batch] expected strided X and y.\n");
+        return -1;
+    }
+    if (X->ndim != 2 || X->shape[1] != m->d || y->shape[0] != X->shape[0]) {
+        fprintf(stderr, "[rls_update_batch] shape mismatch.\n");
+        return -1;
+    }
+    size_t k = X->shape[0];
+    double *row = (double*)malloc(m->d * sizeof(double));
+    if (!row) return -1;
+    for (size_t i = 0; i < k; i++) {
+        for (size_t j = 0; j < m->d; j++) {
+            row[j] = tensor_read_at_offset(X, i * X->strides[0] + j * X->strides[1]);
+        }
+        rls_update(m, row, tensor_read_at_offset(y, i * y->strides[0]));
+    }
+    free(row);
+    return 0;
+}
+
+double rls_predict(const OnlineRLS *m, const double *x) {
+    const double *theta = (const double*)m->theta->data;
+    double pred = theta[m->d];
+    for (size_t j = 0; j < m->d; j++) {
+        pred += theta[j] * x[j];
+    }
+    return pred;
+}
+
+int rls_get_params(const OnlineRLS *m, Tensor *W, Tensor *b) {
+    if (!m || !W || !b || W->layout != TENSOR_LAYOUT_STRIDED ||
+        !(W->flags & TENSOR_FLAG_C_CONTIGUOUS) || b->layout != TENSOR_LAYOUT_STRIDED) {
+        fprintf(stderr, "[rls_get_params] expected a contiguous W and a strided b.\n");
+        return -1;
+    }
+    if (W->num_elems != m->d || b->num_elems != 1) {
+        fprintf(stderr, "[rls_get_params] shape mismatch.\n");
+        return -1;
+    }
+    const double *theta = (const double*)m->theta->data;
+    for (size_t j = 0; j < m->d; j++) {
+        tensor_write_at_offset(W, j, theta[j]);
+    }
+    tensor_write_at_offset(b, 0, theta[m->d]);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              PERSISTENCE                                  */
+/* ------------------------------------------------------------------------- */
+
+int rls_save(const OnlineRLS *m, const char *path) {
+    if (!m || !path) return -1;
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "[rls_save] cannot open %s.\n", path);
+        return -1;
+    }
+    size_t p = m->d + 1;
+    uint64_t d64 = (uint64_t)m->d;
+    uint64_t count64 = (uint64_t)m->count;
+    int ok = fwrite(RLS_MAGIC, sizeof(RLS_MAGIC), 1, f) == 1 &&
+             fwrite(&d64, sizeof(d64), 1, f) == 1 &&
+             fwrite(&m->lambda, sizeof(double), 1, f) == 1 &&
+             fwrite(&count64, sizeof(count64), 1, f) == 1 &&
+             fwrite(m->theta->data, sizeof(double), p, f) == p &&
+             fwrite(m->P->data, sizeof(double), p * p, f) == p * p;
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+/**
+ * Whether d64 is a usable feature count and the rest of 'f' holds exactly
+ * theta and P for it, (d + 1) + (d + 1)^2 doubles. Leaves 'f' where it was.
+ */
+static int payload_matches(FILE *f, uint64_t d64) {
+    if (d64 == 0 || d64 >= (uint64_t)SIZE_MAX) return 0;
+    size_t p = (size_t)d64 + 1;
+    if (p + 1 > SIZE_MAX / sizeof(double) / p) return 0;
+    size_t bytes = p * (p + 1) * sizeof(double);
+
+    long pos = ftell(f);
+    if (pos < 0 || fseek(f, 0, SEEK_END) != 0) return 0;
+    long end = ftell(f);
+    if (end < pos || fseek(f, pos, SEEK_SET) != 0) return 0;
+    return (uint64_t)(end - pos) == (uint64_t)bytes;
+}
+
+OnlineRLS* rls_load(const char *path) {
+    if (!path) return NULL;
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "[rls_load] cannot open %s.\n", path);
+        return NULL;
+    }
+
+    char magic[4];
+    uint64_t d64 = 0, count64 = 0;
+    double lambda = 0.0;
+    OnlineRLS *m = NULL;
+    if (fread(magic, sizeof(magic), 1, f) == 1 && memcmp(magic, RLS_MAGIC, 4) == 0 &&
+        fread(&d64, sizeof(d64), 1, f) == 1 &&
+        fread(&lambda, sizeof(double), 1, f) == 1 &&
+        fread(&count64, sizeof(count64), 1, f) == 1 &&
+        payload_matches(f, d64)) {
+        m = rls_create((size_t)d64, lambda, 1.0);
+    }
+    if (m) {
+        size_t p = m->d + 1;
+        m->count = (size_t)count64;
+        if (fread(m->theta->data, sizeof(double), p, f) != p ||
+            fread(m->P->data, sizeof(double), p * p, f) != p * p) {
+            rls_free(m);
+            m = NULL;
+        }
+    }
+    if (!m) {
+        fprintf(stderr, "[rls_load] %s is not a valid RLS state file.\n", path);
+    }
+    fclose(f);
+    return m;
+}
@@ -0,0 +1,234 @@
+#include "optim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+/** Allocate one zeroed state tensor per parameter, shaped like the parameter. */
+static Tensor** alloc_state(Tensor **params, size_t num_params) {
+    Tensor **state = (Tensor**)calloc(num_params, sizeof(Tensor*));
+    if (!state) return NULL;
+    for (size_t i = 0; i < num_params; i++) {
+        state[i] = tensor_create(params[i]->ndim, params[i]->shape, TENSOR_FLOAT64);
+        if (!state[i]) {
+            for (size_t k = 0; k < i; k++) tensor_free(state[k]);
+            free(state);
+            return NULL;
+        }
+    }
+    return state;
+}
+
+static void free_state(Tensor **state, size_t num_params) {
+    if (!state) return;
+    for (size_t i = 0; i < num_params; i++) {
+        tensor_free(state[i]);
+    }
+    free(state);
+}
+
+/** Does the type keep a first/second state tensor per parameter? */
+static int uses_state1(OptimizerType type) {
+    return type == OPTIM_MOMENTUM || type == OPTIM_NESTEROV || type == OPTIM_ADAM;
+}
+static int uses_state2(OptimizerType type) {
+    return type == OPTIM_ADAM || type == OPTIM_LINE_SEARCH;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+OptimizerConfig optimizer_default_config(OptimizerType type) {
+    OptimizerConfig cfg;
+    cfg.type = type;
+    cfg.lr = 0.01;
+    cfg.momentum = 0.9;
+    cfg.beta1 = 0.9;
+    cfg.beta2 = 0.999;
+    cfg.eps = 1e-8;
+    cfg.ls_shrink = 0.5;
+    cfg.ls_c = 1e-4;
+    cfg.ls_max_iter = 30;
+    return cfg;
+}
+
+Optimizer* optimizer_create(const OptimizerConfig *cfg, Tensor **params, size_t num_params) {
+    if (!cfg || !params || num_params == 0) {
+        fprintf(stderr, "[optimizer_create] invalid arguments.\n");
+        return NULL;
+    }
+    for (size_t i = 0; i < num_params; i++) {
+        if (!params[i] || !tensor_is_contiguous(params[i])) {
+            fprintf(stderr, "[optimizer_create] parameter %zu must be contiguous.\n", i);
+            return NULL;
+        }
+    }
+
+    Optimizer *opt = (Optimizer*)calloc(1, sizeof(Optimizer));
+    if (!opt) return NULL;
+    opt->cfg = *cfg;
+    opt->num_params = num_params;
+    opt->last_lr = cfg->lr;
+
+    opt->params = (Tensor**)malloc(num_params * sizeof(Tensor*));
+    if (!opt->params) {
+        free(opt);
+        return NULL;
+    }
+    memcpy(opt->params, params, num_params * sizeof(Tensor*));
+
+    if (uses_state1(cfg->type)) {
+        opt->state1 = alloc_state(params, num_params);
+        if (!opt->state1) goto fail;
+    }
+    if (uses_state2(cfg->type)) {
+        opt->state2 = alloc_state(params, num_params);
+        if (!opt->state2) goto fail;
+    }
+    return opt;
+
+fail:
+    fprintf(stderr, "[optimizer_create] failed to allocate state.\n");
+    optimizer_free(opt);
+    return NULL;
+}
+
+void optimizer_free(Optimizer *opt) {
+    if (!opt) return;
+    free_state(opt->state1, opt->num_params);
+    free_state(opt->state2, opt->num_params);
+    free(opt->params);
+    free(opt);
+}
+
+void optimizer_reset(Optimizer *opt) {
+    if (!opt) return;
+    for (size_t i = 0; i < opt->num_params; i++) {
+        if (opt->state1) memset(opt->state1[i]->data, 0, opt->state1[i]->num_elems * sizeof(double));
+        if (opt->state2) memset(opt->state2[i]->data, 0, opt->state2[i]->num_elems * sizeof(double));
+    }
+    opt->step = 0;
+    opt->last_lr = opt->cfg.lr;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                 UPDATE                                    */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Backtracking line search along -g: shrink the trial step until the
+ * Armijo condition loss(p - t*g) <= loss - c * t * ||g||^2 holds.
+ * Each step starts from twice the last accepted step so the step size can
+ * grow back after a series of short steps.
+ */
+static int line_search_step(Optimizer *opt, Tensor *const *grads,
+                            double loss, OptimLossFn loss_fn, void *ctx) {
+    if (!loss_fn) {
+        fprintf(stderr, "[optimizer_step] line search requires a loss callback.\n");
+        return -1;
+    }
+
+    // Remember the starting point and ||g||^2
+    double gnorm2 = 0.0;
+    for (size_t p = 0; p < opt->num_params; p++) {
+        double *start = (double*)opt->state2[p]->data;
+        for (size_t i = 0; i < opt->params[p]->num_elems; i++) {
+            double g = tensor_read_at_offset(grads[p], i);
+            start[i] = tensor_read_at_offset(opt->params[p], i);
+            gnorm2 += g * g;
+        }
+    }
+    if (gnorm2 == 0.0) return 0;
+
+    double t = (opt->step > 0) ? 2.0 * opt->last_lr : opt->cfg.lr;
+    int accepted = 0;
+    for (int it = 0; it < opt->cfg.ls_max_iter; it++) {
+        for (size_t p = 0; p < opt->num_params; p++) {
+            const double *start = (const double*)opt->state2[p]->data;
+            for (size_t i = 0; i < opt->params[p]->num_elems; i++) {
+                double g = tensor_read_at_offset(grads[p], i);
+                tensor_write_at_offset(opt->params[p], i, start[i] - t * g);
+            }
+        }
+        double trial = loss_fn(ctx);
+        if (isfinite(trial) && trial <= loss - opt->cfg.ls_c * t * gnorm2) {
+            accepted = 1;
+            break;
+        }
+        if (it + 1 < opt->cfg.ls_max_iter) t *= opt->cfg.ls_shrink;
+    }
+    opt->last_lr = t;
+    if (accepted) return 0;
+
+    // No trial satisfied Armijo: go back to the starting point
+    for (size_t p = 0; p < opt->num_params; p++) {
+        const double *start = (const double*)opt->state2[p]->data;
+        for (size_t i = 0; i < opt->params[p]->num_elems; i++) {
+            tensor_write_at_offset(opt->params[p], i, start[i]);
+        }
+    }
+    return 1;
+}
+
+int optimizer_step(Optimizer *opt, Tensor *const *grads,
+                   double loss, OptimLossFn loss_fn, void *ctx) {
+    if (!opt || !grads) return -1;
+    for (size_t p = 0; p < opt->num_params; p++) {
+        if (!grads[p] || grads[p]->num_elems != opt->params[p]->num_elems) {
+            fprintf(stderr, "[optimizer_step] gradient %zu does not match parameter.\n", p);
+            return -1;
+        }
+    }
+
+    const OptimizerConfig *c = &opt->cfg;
+    opt->step++;
+
+    if (c->type == OPTIM_LINE_SEARCH) {
+        return line_search_step(opt, grads, loss, loss_fn, ctx);
+    }
+
+    // Adam bias corrections depend only on the step count
+    double bc1 = 1.0 - pow(c->beta1, (double)opt->step);
+    double bc2 = 1.0 - pow(c->beta2, (double)opt->step);
+
+    for (size_t p = 0; p < opt->num_params; p++) {
+        Tensor *param = opt->params[p];
+        double *s1 = opt->state1 ? (double*)opt->state1[p]->data : NULL;
+        double *s2 = opt->state2 ? (double*)opt->state2[p]->data : NULL;
+
+        for (size_t i = 0; i < param->num_elems; i++) {
+            double g = tensor_read_at_offset(grads[p], i);
+            double w = tensor_read_at_offset(param, i);
+            switch (c->type) {
+                case OPTIM_SGD:
+                    w -= c->lr * g;
+                    break;
+                case OPTIM_MOMENTUM:
+                    s1[i] = c->momentum * s1[i] + g;
+                    w -= c->lr * s1[i];
+                    break;
+                case OPTIM_NESTEROV:
+                    s1[i] = c->momentum * s1[i] + g;
+                    w -= c->lr * (g + c->momentum * s1[i]);
+                    break;
+                case OPTIM_ADAM:
+                    s1[i] = c->beta1 * s1[i] + (1.0 - c->beta1) * g;
+                    s2[i] = c->beta2 * s2[i] + (1.0 - c->beta2) * g * g;
+                    w -= c->lr * (s1[i] / bc1) / (sqrt(s2[i] / bc2) + c->eps);
+                    break;
+                default:
+                    fprintf(stderr, "[optimizer_step] unsupported optimizer type.\n");
+                    return -1;
+            }
+            tensor_write_at_offset(param, i, w);
+        }
+    }
+    opt->last_lr = c->lr;
+    return 0;
+}
@@ -0,0 +1,258 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "parallel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/** Upper bound on pool threads. */
+#define PARALLEL_MAX_THREADS 256
+
+/** Chunk indices [head, tail) still to run. Owner pops tail, thieves take head. */
+typedef struct {
+    pthread_mutex_t lock;
+    size_t          head;
+    size_t          tail;
+} Deque;
+
+/** Process-wide pool state; fields below 'lock' are guarded by it. */
+static struct {
+    pthread_once_t  once;
+    int             size;         // threads incl. the caller
+    int             limit;        // threads used per region
+    Deque          *deques;
+    pthread_mutex_t region;       // held by the thread running a region
+
+    pthread_mutex_t lock;
+    pthread_cond_t  start;
+    pthread_cond_t  done;
+    unsigned long   generation;
+    int             active;       // workers still inside the current region
+
+    // Current region
+    ParallelForFn   fn;
+    void           *ctx;
+    size_t          n;
+    size_t          grain;
+    int             participants;
+} pool = { .once = PTHREAD_ONCE_INIT };
+
+/** Set while this thread executes region chunks; nested calls run inline. */
+static _Thread_local int tls_in_region = 0;
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static void run_chunk(size_t c) {
+    size_t lo = c * pool.grain;
+    size_t hi = lo + pool.grain < pool.n ? lo + pool.grain : pool.n;
+    pool.fn(lo, hi, pool.ctx);
+}
+
+/** Take the next chunk from the back of our own deque. */
+static int pop_own(int id, size_t *c) {
+    Deque *dq = &pool.deques[id];
+    int got = 0;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->head < dq->tail) {
+        *c = --dq->tail;
+        got = 1;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return got;
+}
+
+/** Take a chunk from the front of another participant's deque. */
+static int steal(int id, size_t *c) {
+    for (int k = 1; k < pool.participants; k++) {
+        Deque *dq = &pool.deques[(id + k) % pool.participants];
+        pthread_mutex_lock(&dq->lock);
+        if (dq->head < dq->tail) {
+            *c = dq->head++;
+            pthread_mutex_unlock(&dq->lock);
+            return 1;
+        }
+        pthread_mutex_unlock(&dq->lock);
+    }
+    return 0;
+}
+
+/** Run chunks until every deque is empty (no chunks are added mid-region). */
+static void participate(int id) {
+    tls_in_region = 1;
+    size_t c;
+    while (pop_own(id, &c) || steal(id, &c)) {
+        run_chunk(c);
+    }
+    tls_in_region = 0;
+}
+
+static void* worker_main(void *arg) {
+    int id = (int)(size_t)arg;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (pool.generation == seen) {
+            pthread_cond_wait(&pool.start, &pool.lock);
+        }
+        seen = pool.generation;
+        if (id >= pool.participants) continue;
+
+        pthread_mutex_unlock(&pool.lock);
+        participate(id);
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.active == 0) {
+            pthread_cond_signal(&pool.done);
+        }
+    }
+    return NULL;
+}
+
+static void pool_init(void) {
+    long size = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *env = getenv("ML_NUM_THREADS");
+    if (env && atoi(env) > 0) size = atoi(env);
+    if (size < 1) size = 1;
+    if (size > PARALLEL_MAX_THREADS) size = PARALLEL_MAX_THREADS;
+
+    pool.deques = (Deque*)calloc((size_t)size, sizeof(Deque));
+    if (!pool.deques) size = 1;
+    pthread_mutex_init(&pool.region, NULL);
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.start, NULL);
+    pthread_cond_init(&pool.done, NULL);
+
+    // Thread 0 is whichever caller runs the region; start the others
+    pool.size = 1;
+    if (pool.deques) pthread_mutex_init(&pool.deques[0].lock, NULL);
+    for (long i = 1; i < size; i++) {
+        pthread_t tid;
+        pthread_mutex_init(&pool.deques[i].lock, NULL);
+        if (pthread_create(&tid, NULL, worker_main, (void*)(size_t)i) != 0) {
+            fprintf(stderr, "[parallel] started %d of %ld threads.\n", pool.size, size);
+            break;
+        }
+        pthread_detach(tid);
+        pool.size++;
+    }
+    pool.limit = pool.size;
+}
+
+/**
+ * Run fn over [0, n) in grain-sized chunks. With 'chunked' set, fn is
+ * called exactly once per chunk even when running serially.
+ */
+static void run_region(size_t n, size_t grain, ParallelForFn fn, void *ctx, int chunked) {
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+    size_t chunks = (n + grain - 1) / grain;
+
+    pthread_once(&pool.once, pool_init);
+    int parallel = chunks > 1 && !tls_in_region && pthread_mutex_trylock(&pool.region) == 0;
+    if (parallel && pool.limit < 2) {
+        pthread_mutex_unlock(&pool.region);
+        parallel = 0;
+    }
+    if (!parallel) {
+        if (!chunked) {
+            fn(0, n, ctx);
+            return;
+        }
+        for (size_t lo = 0; lo < n; lo += grain) {
+            fn(lo, lo + grain < n ? lo + grain : n, ctx);
+        }
+        return;
+    }
+
+    // Deal chunks out as contiguous runs, one per participant
+    int p = (size_t)pool.limit < chunks ? pool.limit : (int)chunks;
+    for (int i = 0; i < p; i++) {
+        pool.deques[i].head = chunks * (size_t)i / (size_t)p;
+        pool.deques[i].tail = chunks * (size_t)(i + 1) / (size_t)p;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.fn = fn;
+    pool.ctx = ctx;
+    pool.n = n;
+    pool.grain = grain;
+    pool.participants = p;
+    pool.active = p - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+
+    participate(0);
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.active > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.region);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                RUNTIME                                    */
+/* ------------------------------------------------------------------------- */
+
+void parallel_for(size_t n, size_t grain, ParallelForFn fn, void *ctx) {
+    run_region(n, grain, fn, ctx, 0);
+}
+
+/** Adapter: each chunk stores its partial at its own index. */
+typedef struct {
+    ParallelReduceFn fn;
+    void            *ctx;
+    size_t           grain;
+    double          *partials;
+} ReduceContext;
+
+static void reduce_chunk(size_t lo, size_t hi, void *arg) {
+    ReduceContext *rc = (ReduceContext*)arg;
+    rc->partials[lo / rc->grain] = rc->fn(lo, hi, rc->ctx);
+}
+
+double parallel_reduce_sum(size_t n, size_t grain, ParallelReduceFn fn, void *ctx) {
+    if (n == 0) return 0.0;
+    if (grain == 0) grain = 1;
+    size_t chunks = (n + grain - 1) / grain;
+    if (chunks == 1) return fn(0, n, ctx);
+
+    double stack_partials[64];
+    double *partials = chunks <= 64 ? stack_partials : (double*)malloc(chunks * sizeof(double));
+    if (!partials) {
+        // Same chunk order, computed serially
+        double s = 0.0;
+        for (size_t lo = 0; lo < n; lo += grain) {
+            s += fn(lo, lo + grain < n ? lo + grain : n, ctx);
+        }
+        return s;
+    }
+
+    ReduceContext rc = { fn, ctx, grain, partials };
+    run_region(n, grain, reduce_chunk, &rc, 1);
+
+    double s = 0.0;
+    for (size_t c = 0; c < chunks; c++) {
+        s += partials[c];
+    }
+    if (partials != stack_partials) free(partials);
+    return s;
+}
+
+int parallel_num_threads(void) {
+    pthread_once(&pool.once, pool_init);
+    return pool.limit;
+}
+
+void parallel_set_num_threads(int n) {
+    pthread_once(&pool.once, pool_init);
+    pthread_mutex_lock(&pool.region);
+    pool.limit = (n <= 0 || n > pool.size) ? pool.size : n;
+    pthread_mutex_unlock(&pool.region);
+}
@@ -0,0 +1,217 @@
+#include "rng.h"
+#include "parallel.h"
+#include "vmath.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+/** Philox4x32 multipliers and Weyl key increments. */
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+/** Blocks generated side by side; the round loop vectorizes across them. */
+#define RNG_BATCH 16
+
+/** Elements produced per buffer in a fill range (even). */
+#define RNG_CHUNK 256
+
+/** Fills of at least this many elements run on the pool, in even chunks. */
+#define RNG_PARALLEL_MIN (1u << 16)
+#define RNG_GRAIN        (1u << 14)
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+/** RNG_BATCH consecutive blocks starting at 'ctr', as 64-bit draws (2 per block). */
+static void philox_batch(uint64_t seed, uint64_t ctr, uint64_t out[2 * RNG_BATCH]) {
+    uint32_t c0[RNG_BATCH], c1[RNG_BATCH], c2[RNG_BATCH], c3[RNG_BATCH];
+    for (int j = 0; j < RNG_BATCH; j++) {
+        c0[j] = (uint32_t)(ctr + (uint64_t)j);
+        c1[j] = (uint32_t)((ctr + (uint64_t)j) >> 32);
+        c2[j] = 0;
+        c3[j] = 0;
+    }
+    uint32_t k0 = (uint32_t)seed, k1 = (uint32_t)(seed >> 32);
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+        for (int j = 0; j < RNG_BATCH; j++) {
+            uint64_t p0 = (uint64_t)PHILOX_M0 * c0[j];
+            uint64_t p1 = (uint64_t)PHILOX_M1 * c2[j];
+            uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1[j] ^ k0;
+            uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3[j] ^ k1;
+            c1[j] = (uint32_t)p1;
+            c3[j] = (uint32_t)p0;
+            c0[j] = n0;
+            c2[j] = n2;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    for (int j = 0; j < RNG_BATCH; j++) {
+        out[2 * j]     = (uint64_t)c0[j] | ((uint64_t)c1[j] << 32);
+        out[2 * j + 1] = (uint64_t)c2[j] | ((uint64_t)c3[j] << 32);
+    }
+}
+
+/** Draws of blocks [first, first + count) into out[0 .. 2*count). */
+static void philox_draws(uint64_t seed, uint64_t first, size_t count, uint64_t *out) {
+    uint64_t tmp[2 * RNG_BATCH];
+    size_t b = 0;
+    for (; b + RNG_BATCH <= count; b += RNG_BATCH) {
+        philox_batch(seed, first + b, out + 2 * b);
+    }
+    if (b < count) {
+        philox_batch(seed, first + b, tmp);
+        memcpy(out + 2 * b, tmp, 2 * (count - b) * sizeof(uint64_t));
+    }
+}
+
+/** 53-bit uniform in [0, 1). */
+static inline double draw_unit(uint64_t x) {
+    return (double)(x >> 11) * 0x1.0p-53;
+}
+
+/** Offset of logical (row-major) element i. */
+static size_t logical_offset(const Tensor *t, size_t i) {
+    if (t->flags & TENSOR_FLAG_C_CONTIGUOUS) return i;
+    size_t off = 0;
+    for (size_t d = t->ndim; d-- > 0;) {
+        off += (i % t->shape[d]) * t->strides[d];
+        i /= t->shape[d];
+    }
+    return off;
+}
+
+typedef struct {
+    Tensor  *t;
+    uint64_t seed;
+    uint64_t counter;
+    int      normal;
+    double   a;        // lo, or mean
+    double   b;        // hi - lo, or std
+} FillContext;
+
+/** Elements [lo, hi): element i comes from block counter + i / 2. */
+static void fill_range(size_t lo, size_t hi, void *arg) {
+    const FillContext *c = (const FillContext*)arg;
+    uint64_t raw[RNG_CHUNK + 2];
+    double v[RNG_CHUNK + 2];
+    double r[RNG_CHUNK / 2 + 1];
+    for (size_t i0 = lo; i0 < hi; i0 += RNG_CHUNK) {
+        size_t i1 = (hi - i0 < RNG_CHUNK) ? hi : i0 + RNG_CHUNK;
+        size_t b0 = i0 / 2;
+        size_t nb = (i1 - 1) / 2 - b0 + 1;
+        philox_draws(c->seed, c->counter + b0, nb, raw);
+
+        if (c->normal) {
+            // r = sqrt(-2 log u1) with u1 in (0, 1], angle from u2
+            for (size_t k = 0; k < nb; k++) r[k] = 1.0 - draw_unit(raw[2 * k]);
+            vmath_log(r, r, nb);
+            for (size_t k = 0; k < nb; k++) r[k] *= -2.0;
+            vmath_sqrt(r, r, nb);
+            for (size_t k = 0; k < nb; k++) {
+                double theta = 6.283185307179586 * draw_unit(raw[2 * k + 1]);
+                v[2 * k]     = c->a + c->b * (r[k] * cos(theta));
+                v[2 * k + 1] = c->a + c->b * (r[k] * sin(theta));
+            }
+        } else {
+            for (size_t k = 0; k < 2 * nb; k++) v[k] = c->a + c->b * draw_unit(raw[k]);
+        }
+
+        const double *src = v + (i0 - 2 * b0);
+        if (c->t->dtype == TENSOR_FLOAT64 && (c->t->flags & TENSOR_FLAG_C_CONTIGUOUS)) {
+            memcpy((double*)c->t->data + i0, src, (i1 - i0) * sizeof(double));
+        } else {
+            for (size_t i = i0; i < i1; i++) {
+                tensor_write_at_offset(c->t, logical_offset(c->t, i), src[i - i0]);
+            }
+        }
+    }
+}
+
+static int fill(Tensor *t, TensorRng *rng, int normal, double a, double b, const char *fn) {
+    if (!t || !rng || t->layout != TENSOR_LAYOUT_STRIDED) {
+        fprintf(stderr, "[%s] expected a strided tensor and a generator.\n", fn);
+        return -1;
+    }
+    size_t n = t->num_elems;
+    FillContext ctx = { t, rng->seed, rng->counter, normal, a, b };
+    if (n >= RNG_PARALLEL_MIN) {
+        parallel_for(n, RNG_GRAIN, fill_range, &ctx);
+    } else {
+        fill_range(0, n, &ctx);
+    }
+    rng->counter += (n + 1) / 2;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               GENERATOR                                   */
+/* ------------------------------------------------------------------------- */
+
+TensorRng tensor_rng(uint64_t seed) {
+    TensorRng rng = { seed, 0 };
+    return rng;
+}
+
+void tensor_rng_block(uint64_t seed, uint64_t counter, uint32_t out[4]) {
+    uint64_t d[2 * RNG_BATCH];
+    philox_batch(seed, counter, d);
+    out[0] = (uint32_t)d[0];
+    out[1] = (uint32_t)(d[0] >> 32);
+    out[2] = (uint32_t)d[1];
+    out[3] = (uint32_t)(d[1] >> 32);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              RANDOM FILLS                                 */
+/* ------------------------------------------------------------------------- */
+
+int tensor_rand_uniform(Tensor *t, double lo, double hi, TensorRng *rng) {
+    return fill(t, rng, 0, lo, hi - lo, "tensor_rand_uniform");
+}
+
+int tensor_randn(Tensor *t, double mean, double std, TensorRng *rng) {
+    return fill(t, rng, 1, mean, std, "tensor_randn");
+}
+
+int tensor_randperm(Tensor *t, TensorRng *rng) {
+    if (!t || !rng || t->layout != TENSOR_LAYOUT_STRIDED || t->ndim != 1 ||
+        (t->dtype == TENSOR_INT32 && t->num_elems > (size_t)INT_MAX)) {
+        fprintf(stderr, "[tensor_randperm] expected a 1D strided tensor and a generator.\n");
+        return -1;
+    }
+    size_t n = t->num_elems;
+    size_t *perm = (size_t*)malloc((n ? n : 1) * sizeof(size_t));
+    if (!perm) {
+        fprintf(stderr, "[tensor_randperm] allocation failure.\n");
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) perm[i] = i;
+
+    // Step k swaps position i = n-1-k with a draw j in [0, i] (multiply-shift)
+    uint64_t raw[RNG_CHUNK];
+    for (size_t k0 = 0; k0 + 1 < n; k0 += RNG_CHUNK) {
+        size_t m = (n - 1 - k0 < RNG_CHUNK) ? n - 1 - k0 : RNG_CHUNK;
+        philox_draws(rng->seed, rng->counter + k0 / 2, (m + 1) / 2, raw);
+        for (size_t k = 0; k < m; k++) {
+            size_t i = n - 1 - (k0 + k);
+            size_t j = (size_t)(((unsigned __int128)raw[k] * (uint64_t)(i + 1)) >> 64);
+            size_t tmp = perm[i];
+            perm[i] = perm[j];
+            perm[j] = tmp;
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        tensor_write_at_offset(t, i * t->strides[0], (double)perm[i]);
+    }
+    free(perm);
+    rng->counter += n / 2;
+    return 0;
+}
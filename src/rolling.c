@@ -0,0 +1,196 @@
+#include "rolling.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+/** G += sign * z z^T and c += sign * z y for one stored row [z, y]. */
+static void accumulate_row(RollingOLS *r, const double *zy, double sign) {
+    size_t p = r->d + 1;
+    double *G = (double*)r->G->data;
+    double *c = (double*)r->c->data;
+    double y = zy[p];
+    for (size_t i = 0; i < p; i++) {
+        double zi = sign * zy[i];
+        double *Grow = G + i * p;
+        for (size_t j = 0; j < p; j++) {
+            Grow[j] += zi * zy[j];
+        }
+        c[i] += zi * y;
+    }
+}
+
+/** Recompute G and c from the rows currently in the ring buffer. */
+static void rebuild_sums(RollingOLS *r) {
+    size_t p = r->d + 1;
+    memset(r->G->data, 0, p * p * sizeof(double));
+    memset(r->c->data, 0, p * sizeof(double));
+    const double *ring = (const double*)r->ring->data;
+    for (size_t k = 0; k < r->filled; k++) {
+        accumulate_row(r, ring + k * (p + 1), 1.0);
+    }
+    r->pushes = 0;
+}
+
+/**
+ * Solve (G + ridge * I_w) x = c by Cholesky, where the ridge skips the bias.
+ * Returns -1 if the matrix is not positive definite.
+ */
+static int cholesky_solve(RollingOLS *r, double *x) {
+    size_t p = r->d + 1;
+    const double *G = (const double*)r->G->data;
+    const double *c = (const double*)r->c->data;
+    double *L = (double*)r->L->data;
+
+    for (size_t i = 0; i < p; i++) {
+        for (size_t j = 0; j <= i; j++) {
+            double s = G[i * p + j];
+            if (i == j && i < r->d) s += r->cfg.ridge;
+            for (size_t k = 0; k < j; k++) {
+                s -= L[i * p + k] * L[j * p + k];
+            }
+            if (i == j) {
+                // Relative pivot check: tiny pivots mean a rank-deficient window
+                if (!(s > 1e-12 * fabs(G[i * p + i]))) return -1;
+                L[i * p + i] = sqrt(s);
+            } else {
+                L[i * p + j] = s / L[j * p + j];
+            }
+        }
+    }
+
+    // Forward substitution L u = c, then back substitution L^T x = u
+    for (size_t i = 0; i < p; i++) {
+        double s = c[i];
+        for (size_t k = 0; k < i; k++) s -= L[i * p + k] * x[k];
+        x[i] = s / L[i * p + i];
+    }
+    for (size_t i = p; i-- > 0;) {
+        double s = x[i];
+        for (size_t k = i + 1; k < p; k++) s -= L[k * p + i] * x[k];
+        x[i] = s / L[i * p + i];
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                           INCREMENTAL ENGINE                              */
+/* ------------------------------------------------------------------------- */
+
+RollingConfig rolling_default_config(size_t window) {
+    RollingConfig cfg;
+    cfg.window = window;
+    cfg.ridge = 0.0;
+    cfg.refresh = window;
+    return cfg;
+}
+
+RollingOLS* rolling_create(size_t d, const RollingConfig *cfg) {
+    if (d == 0 || !cfg || cfg->window == 0 || cfg->ridge < 0.0) {
+        fprintf(stderr, "[rolling_create] invalid arguments.\n");
+        return NULL;
+    }
+    RollingOLS *r = (RollingOLS*)calloc(1, sizeof(RollingOLS));
+    if (!r) return NULL;
+    r->cfg = *cfg;
+    r->d = d;
+
+    size_t p = d + 1;
+    r->ring = tensor_create(2, (size_t[]){cfg->window, p + 1}, TENSOR_FLOAT64);
+    r->G = tensor_create(2, (size_t[]){p, p}, TENSOR_FLOAT64);
+    r->c = tensor_create(2, (size_t[]){p, 1}, TENSOR_FLOAT64);
+    r->L = tensor_create(2, (size_t[]){p, p}, TENSOR_FLOAT64);
+    if (!r->ring || !r->G || !r->c || !r->L) {
+        fprintf(stderr, "[rolling_create] allocation failure.\n");
+        rolling_free(r);
+        return NULL;
+    }
+    return r;
+}
+
+void rolling_free(RollingOLS *r) {
+    if (!r) return;
+    tensor_free(r->ring);
+    tensor_free(r->G);
+    tensor_free(r->c);
+    tensor_free(r->L);
+    free(r);
+}
+
+int rolling_push(RollingOLS *r, const double *x, double y) {
+    size_t p = r->d + 1;
+    double *slot = (double*)r->ring->data + r->head * (p + 1);
+
+    // Evict the oldest row (the one in this slot) once the window is full
+    if (r->filled == r->cfg.window) {
+        accumulate_row(r, slot, -1.0);
+    } else {
+        r->filled++;
+    }
+
+    memcpy(slot, x, r->d * sizeof(double));
+    slot[r->d] = 1.0;
+    slot[p] = y;
+    accumulate_row(r, slot, 1.0);
+    r->head = (r->head + 1) % r->cfg.window;
+
+    r->pushes++;
+    if (r->cfg.refresh > 0 && r->pushes >= r->cfg.refresh) {
+        rebuild_sums(r);
+    }
+    return r->filled == r->cfg.window;
+}
+
+int rolling_solve(RollingOLS *r, double *coef) {
+    if (!r || !coef || r->filled < r->cfg.window) return -1;
+    return cholesky_solve(r, coef);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              BATCH DRIVER                                 */
+/* ------------------------------------------------------------------------- */
+
+Tensor* rolling_regression(const Tensor *X, const Tensor *y, const RollingConfig *cfg) {
+    if (!X || !y || !cfg || X->ndim != 2 || X->layout != TENSOR_LAYOUT_STRIDED ||
+        y->layout != TENSOR_LAYOUT_STRIDED || y->shape[0] != X->shape[0] ||
+        cfg->window == 0 || cfg->window > X->shape[0]) {
+        fprintf(stderr, "[rolling_regression] invalid arguments.\n");
+        return NULL;
+    }
+    size_t n = X->shape[0];
+    size_t d = X->shape[1];
+    size_t num_windows = n - cfg->window + 1;
+
+    Tensor *out = tensor_empty(2, (size_t[]){num_windows, d + 1}, TENSOR_FLOAT64);
+    RollingOLS *r = rolling_create(d, cfg);
+    double *row = (double*)malloc(d * sizeof(double));
+    if (!out || !r || !row) {
+        tensor_free(out);
+        rolling_free(r);
+        free(row);
+        return NULL;
+    }
+
+    double *coefs = (double*)out->data;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < d; j++) {
+            row[j] = tensor_read_at_offset(X, i * X->strides[0] + j * X->strides[1]);
+        }
+        if (!rolling_push(r, row, tensor_read_at_offset(y, i * y->strides[0]))) {
+            continue;
+        }
+        double *dst = coefs + (i + 1 - cfg->window) * (d + 1);
+        if (rolling_solve(r, dst) != 0) {
+            for (size_t j = 0; j <= d; j++) dst[j] = NAN;
+        }
+    }
+
+    free(row);
+    rolling_free(r);
+    return out;
+}
@@ -0,0 +1,214 @@
+#include "scaler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+/** Check that X is 2D with 'd' columns. */
+static int check_shape(const Scaler *s, const Tensor *X, const char *fn) {
+    if (!s || !X || X->ndim != 2 || X->layout != TENSOR_LAYOUT_STRIDED || X->shape[1] != s->d) {
+        fprintf(stderr, "[%s] expected a strided X of shape [n, %zu].\n", fn, s ? s->d : 0);
+        return -1;
+    }
+    return 0;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/** Linear-interpolated quantile q in [0,1] of a sorted array. */
+static double sorted_quantile(const double *v, size_t n, double q) {
+    double pos = q * (double)(n - 1);
+    size_t lo = (size_t)pos;
+    size_t hi = (lo + 1 < n) ? lo + 1 : lo;
+    double frac = pos - (double)lo;
+    return v[lo] + frac * (v[hi] - v[lo]);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               LIFECYCLE                                   */
+/* ------------------------------------------------------------------------- */
+
+Scaler* scaler_create(ScalerType type, size_t d) {
+    if (d == 0) return NULL;
+    Scaler *s = (Scaler*)calloc(1, sizeof(Scaler));
+    if (!s) return NULL;
+    s->type = type;
+    s->d = d;
+
+    s->center = (double*)calloc(d, sizeof(double));
+    s->scale  = (double*)calloc(d, sizeof(double));
+    s->mean   = (double*)calloc(d, sizeof(double));
+    s->m2     = (double*)calloc(d, sizeof(double));
+    s->min    = (double*)malloc(d * sizeof(double));
+    s->max    = (double*)malloc(d * sizeof(double));
+    if (!s->center || !s->scale || !s->mean || !s->m2 || !s->min || !s->max) {
+        fprintf(stderr, "[scaler_create] allocation failure.\n");
+        scaler_free(s);
+        return NULL;
+    }
+    for (size_t j = 0; j < d; j++) {
+        s->min[j] = INFINITY;
+        s->max[j] = -INFINITY;
+        s->scale[j] = 1.0;
+    }
+    return s;
+}
+
+void scaler_free(Scaler *s) {
+    if (!s) return;
+    free(s->center);
+    free(s->scale);
+    free(s->mean);
+    free(s->m2);
+    free(s->min);
+    free(s->max);
+    free(s);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                FITTING                                    */
+/* ------------------------------------------------------------------------- */
+
+void scaler_observe_row(Scaler *s, const double *row) {
+    if (!s || !row) return;
+    s->count++;
+    double inv_n = 1.0 / (double)s->count;
+    for (size_t j = 0; j < s->d; j++) {
+        double v = row[j];
+        // Welford: numerically stable running mean / sum of squared deviations
+        double delta = v - s->mean[j];
+        s->mean[j] += delta * inv_n;
+        s->m2[j] += delta * (v - s->mean[j]);
+        if (v < s->min[j]) s->min[j] = v;
+        if (v > s->max[j]) s->max[j] = v;
+    }
+}
+
+int scaler_finalize(Scaler *s, const Tensor *X) {
+    if (!s) return -1;
+
+    if (s->type == SCALER_ROBUST) {
+        if (check_shape(s, X, "scaler_finalize") != 0) return -1;
+        size_t n = X->shape[0];
+        if (n == 0) return -1;
+        double *col = (double*)malloc(n * sizeof(double));
+        if (!col) return -1;
+        for (size_t j = 0; j < s->d; j++) {
+            for (size_t i = 0; i < n; i++) {
+                col[i] = tensor_get(X, (size_t[]){i, j});
+            }
+            qsort(col, n, sizeof(double), cmp_double);
+            s->center[j] = sorted_quantile(col, n, 0.5);
+            s->scale[j] = sorted_quantile(col, n, 0.75) - sorted_quantile(col, n, 0.25);
+        }
+        free(col);
+        s->count = n;
+    } else {
+        if (s->count == 0) {
+            fprintf(stderr, "[scaler_finalize] no rows observed.\n");
+            return -1;
+        }
+        for (size_t j = 0; j < s->d; j++) {
+            if (s->type == SCALER_ZSCORE) {
+                s->center[j] = s->mean[j];
+                s->scale[j] = sqrt(s->m2[j] / (double)s->count);
+            } else {
+                s->center[j] = s->min[j];
+                s->scale[j] = s->max[j] - s->min[j];
+            }
+        }
+    }
+
+    // Constant columns are only centered
+    for (size_t j = 0; j < s->d; j++) {
+        if (!(s->scale[j] > 0.0) || !isfinite(s->scale[j])) {
+            s->scale[j] = 1.0;
+        }
+    }
+    s->fitted = 1;
+    return 0;
+}
+
+int scaler_fit(Scaler *s, const Tensor *X) {
+    if (check_shape(s, X, "scaler_fit") != 0) return -1;
+    if (s->type != SCALER_ROBUST) {
+        double *row = (double*)malloc(s->d * sizeof(double));
+        if (!row) return -1;
+        for (size_t i = 0; i < X->shape[0]; i++) {
+            for (size_t j = 0; j < s->d; j++) {
+                row[j] = tensor_get(X, (size_t[]){i, j});
+            }
+            scaler_observe_row(s, row);
+        }
+        free(row);
+    }
+    return scaler_finalize(s, X);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              TRANSFORMS                                   */
+/* ------------------------------------------------------------------------- */
+
+/** Apply x' = (x - center) / scale (or its inverse) column-wise, honoring strides. */
+static void apply_affine(const Scaler *s, Tensor *X, int inverse) {
+    size_t n = X->shape[0];
+    size_t sx0 = X->strides[0], sx1 = X->strides[1];
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < s->d; j++) {
+            size_t off = i * sx0 + j * sx1;
+            double v = tensor_read_at_offset(X, off);
+            v = inverse ? v * s->scale[j] + s->center[j]
+                        : (v - s->center[j]) / s->scale[j];
+            tensor_write_at_offset(X, off, v);
+        }
+    }
+}
+
+int scaler_transform(const Scaler *s, Tensor *X) {
+    if (check_shape(s, X, "scaler_transform") != 0) return -1;
+    if (!s->fitted) {
+        fprintf(stderr, "[scaler_transform] scaler is not fitted.\n");
+        return -1;
+    }
+    apply_affine(s, X, 0);
+    return 0;
+}
+
+int scaler_inverse_transform(const Scaler *s, Tensor *X) {
+    if (check_shape(s, X, "scaler_inverse_transform") != 0) return -1;
+    if (!s->fitted) {
+        fprintf(stderr, "[scaler_inverse_transform] scaler is not fitted.\n");
+        return -1;
+    }
+    apply_affine(s, X, 1);
+    return 0;
+}
+
+int scaler_unscale_params(const Scaler *xs, const Scaler *ys, Tensor *W, Tensor *b) {
+    if (!xs || !xs->fitted || !W || !b || W->num_elems != xs->d || b->num_elems != 1 ||
+        W->layout != TENSOR_LAYOUT_STRIDED || !(W->flags & TENSOR_FLAG_C_CONTIGUOUS) ||
+        b->layout != TENSOR_LAYOUT_STRIDED || (ys && (!ys->fitted || ys->d != 1))) {
+        fprintf(stderr, "[scaler_unscale_params] invalid arguments.\n");
+        return -1;
+    }
+    double sy = ys ? ys->scale[0] : 1.0;
+    double cy = ys ? ys->center[0] : 0.0;
+
+    double bias = tensor_read_at_offset(b, 0);
+    for (size_t j = 0; j < xs->d; j++) {
+        double w = tensor_read_at_offset(W, j) / xs->scale[j];
+        bias -= w * xs->center[j];
+        tensor_write_at_offset(W, j, sy * w);
+    }
+    tensor_write_at_offset(b, 0, sy * bias + cy);
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include "sparse.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static void csr_storage_free(void *storage) {
+    CSRStorage *csr = (CSRStorage*)storage;
+    if (!csr) return;
+    free(csr->indptr);
+    free(csr->indices);
+    free(csr->values);
+    free(csr);
+}
+
+/**
+ * Allocate a CSR tensor with room for 'nnz' entries. indptr is zeroed;
+ * the caller fills indices/values.
+ */
+static Tensor* csr_alloc(size_t rows, size_t cols, size_t nnz) {
+    Tensor *t = (Tensor*)calloc(1, sizeof(Tensor));
+    CSRStorage *csr = (CSRStorage*)calloc(1, sizeof(CSRStorage));
+    if (!t || !csr) {
+        free(t);
+        free(csr);
+        return NULL;
+    }
+    t->shape = (size_t*)malloc(2 * sizeof(size_t));
+    t->strides = (size_t*)calloc(2, sizeof(size_t));   // unused for CSR
+    csr->indptr = (size_t*)calloc(rows + 1, sizeof(size_t));
+    csr->indices = (size_t*)malloc((nnz ? nnz : 1) * sizeof(size_t));
+    csr->values = (double*)malloc((nnz ? nnz : 1) * sizeof(double));
+    if (!t->shape || !t->strides || !csr->indptr || !csr->indices || !csr->values) {
+        fprintf(stderr, "[tensor_csr] allocation failure.\n");
+        free(t->shape);
+        free(t->strides);
+        free(t);
+        csr_storage_free(csr);
+        return NULL;
+    }
+    csr->nnz = nnz;
+
+    t->ndim = 2;
+    t->shape[0] = rows;
+    t->shape[1] = cols;
+    t->data = NULL;
+    t->dtype = TENSOR_FLOAT64;
+    t->ref_count = 1;
+    t->owner = 1;
+    t->num_elems = rows * cols;
+    t->flags = 0;
+    t->base = NULL;
+    t->layout = TENSOR_LAYOUT_CSR;
+    t->storage = csr;
+    t->storage_free = csr_storage_free;
+    return t;
+}
+
+/** Check that 'out' is a contiguous float64 [rows, cols] tensor. */
+static int check_out(const Tensor *out, size_t rows, size_t cols, const char *fn) {
+    if (!out || out->layout != TENSOR_LAYOUT_STRIDED || out->dtype != TENSOR_FLOAT64 ||
+        !tensor_is_contiguous(out) || out->ndim != 2 ||
+        out->shape[0] != rows || out->shape[1] != cols) {
+        fprintf(stderr, "[%s] out must be contiguous float64 of shape [%zu, %zu].\n",
+                fn, rows, cols);
+        return -1;
+    }
+    return 0;
+}
+
+/** (column, value) pair used to sort a row of COO input. */
+typedef struct {
+    size_t col;
+    double val;
+} ColVal;
+
+static int cmp_colval(const void *a, const void *b) {
+    size_t x = ((const ColVal*)a)->col;
+    size_t y = ((const ColVal*)b)->col;
+    return (x > y) - (x < y);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              CONSTRUCTION                                 */
+/* ------------------------------------------------------------------------- */
+
+Tensor* tensor_csr_from_dense(const Tensor *dense) {
+    if (!dense || dense->ndim != 2 || dense->layout != TENSOR_LAYOUT_STRIDED) {
+        fprintf(stderr, "[tensor_csr_from_dense] expected a 2D strided tensor.\n");
+        return NULL;
+    }
+    size_t rows = dense->shape[0];
+    size_t cols = dense->shape[1];
+    size_t s0 = dense->strides[0], s1 = dense->strides[1];
+
+    // Pass 1: count nonzeros
+    size_t nnz = 0;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            if (tensor_read_at_offset(dense, i * s0 + j * s1) != 0.0) nnz++;
+        }
+    }
+
+    // Pass 2: fill
+    Tensor *sp = csr_alloc(rows, cols, nnz);
+    if (!sp) return NULL;
+    CSRStorage *csr = (CSRStorage*)sp->storage;
+    size_t k = 0;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            double v = tensor_read_at_offset(dense, i * s0 + j * s1);
+            if (v != 0.0) {
+                csr->indices[k] = j;
+                csr->values[k] = v;
+                k++;
+            }
+        }
+        csr->indptr[i + 1] = k;
+    }
+    return sp;
+}
+
+Tensor* tensor_csr_from_coo(size_t rows, size_t cols, size_t nnz,
+                            const size_t *row_idx, const size_t *col_idx,
+                            const double *values) {
+    if (nnz > 0 && (!row_idx || !col_idx || !values)) return NULL;
+    for (size_t k = 0; k < nnz; k++) {
+        if (row_idx[k] >= rows || col_idx[k] >= cols) {
+            fprintf(stderr, "[tensor_csr_from_coo] entry %zu out of range.\n", k);
+            return NULL;
+        }
+    }
+
+    // Bucket entries by row (counting sort), then sort each row by column
+    size_t *start = (size_t*)calloc(rows + 1, sizeof(size_t));
+    ColVal *entries = (ColVal*)malloc((nnz ? nnz : 1) * sizeof(ColVal));
+    size_t *fill = (size_t*)malloc((rows ? rows : 1) * sizeof(size_t));
+    if (!start || !entries || !fill) {
+        free(start);
+        free(entries);
+        free(fill);
+        return NULL;
+    }
+    for (size_t k = 0; k < nnz; k++) start[row_idx[k] + 1]++;
+    for (size_t i = 0; i < rows; i++) start[i + 1] += start[i];
+    memcpy(fill, start, rows * sizeof(size_t));
+    for (size_t k = 0; k < nnz; k++) {
+        ColVal cv = { col_idx[k], values[k] };
+        entries[fill[row_idx[k]]++] = cv;
+    }
+
+    // Merge duplicates in place; count surviving entries
+    size_t kept = 0;
+    for (size_t i = 0; i < rows; i++) {
+        size_t lo = start[i], hi = start[i + 1];
+        qsort(entries + lo, hi - lo, sizeof(ColVal), cmp_colval);
+        size_t row_begin = kept;
+        for (size_t k = lo; k < hi; k++) {
+            if (kept > row_begin && entries[kept - 1].col == entries[k].col) {
+                entries[kept - 1].val += entries[k].val;
+            } else {
+                entries[kept++] = entries[k];
+            }
+        }
+        fill[i] = kept - row_begin;
+    }
+
+    Tensor *sp = csr_alloc(rows, cols, kept);
+    if (sp) {
+        CSRStorage *csr = (CSRStorage*)sp->storage;
+        for (size_t i = 0; i < rows; i++) {
+            csr->indptr[i + 1] = csr->indptr[i] + fill[i];
+        }
+        for (size_t k = 0; k < kept; k++) {
+            csr->indices[k] = entries[k].col;
+            csr->values[k] = entries[k].val;
+        }
+    }
+    free(start);
+    free(entries);
+    free(fill);
+    return sp;
+}
+
+Tensor* tensor_csr_to_dense(const Tensor *sp) {
+    const CSRStorage *csr = tensor_csr(sp);
+    if (!csr) return NULL;
+    Tensor *dense = tensor_create(2, sp->shape, TENSOR_FLOAT64);
+    if (!dense) return NULL;
+    double *out = (double*)dense->data;
+    size_t cols = sp->shape[1];
+    for (size_t i = 0; i < sp->shape[0]; i++) {
+        for (size_t k = csr->indptr[i]; k < csr->indptr[i + 1]; k++) {
+            out[i * cols + csr->indices[k]] = csr->values[k];
+        }
+    }
+    return dense;
+}
+
+const CSRStorage* tensor_csr(const Tensor *sp) {
+    if (!sp || sp->layout != TENSOR_LAYOUT_CSR) return NULL;
+    return (const CSRStorage*)sp->storage;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                               KERNELS                                     */
+/* ------------------------------------------------------------------------- */
+
+int tensor_spmm(const Tensor *A, const Tensor *B, Tensor *out) {
+    const CSRStorage *csr = tensor_csr(A);
+    if (!csr || !B || B->layout != TENSOR_LAYOUT_STRIDED || B->ndim != 2 ||
+        B->shape[0] != A->shape[1]) {
+        fprintf(stderr, "[tensor_spmm] expected CSR A [M,K] and dense B [K,N].\n");
+        return -1;
+    }
+    size_t M = A->shape[0];
+    size_t N = B->shape[1];
+    if (check_out(out, M, N, "tensor_spmm") != 0) return -1;
+
+    double *o = (double*)out->data;
+    size_t b0 = B->strides[0], b1 = B->strides[1];
+    int b_direct = (B->dtype == TENSOR_FLOAT64);
+    const double *bd = (const double*)B->data;
+
+    for (size_t i = 0; i < M; i++) {
+        double *orow = o + i * N;
+        if (N == 1) {
+            // SpMV: one dot product per row over its nonzeros
+            double acc = 0.0;
+            for (size_t k = csr->indptr[i]; k < csr->indptr[i + 1]; k++) {
+                size_t off = csr->indices[k] * b0;
+                acc += csr->values[k] * (b_direct ? bd[off] : tensor_read_at_offset(B, off));
+            }
+            orow[0] = acc;
+            continue;
+        }
+        for (size_t j = 0; j < N; j++) orow[j] = 0.0;
+        for (size_t k = csr->indptr[i]; k < csr->indptr[i + 1]; k++) {
+            double v = csr->values[k];
+            size_t brow = csr->indices[k] * b0;
+            for (size_t j = 0; j < N; j++) {
+                size_t off = brow + j * b1;
+                orow[j] += v * (b_direct ? bd[off] : tensor_read_at_offset(B, off));
+            }
+        }
+    }
+    return 0;
+}
+
+int tensor_spmm_t(const Tensor *A, const Tensor *R, Tensor *out) {
+    const CSRStorage *csr = tensor_csr(A);
+    if (!csr || !R || R->layout != TENSOR_LAYOUT_STRIDED || R->ndim != 2 ||
+        R->shape[0] != A->shape[0]) {
+        fprintf(stderr, "[tensor_spmm_t] expected CSR A [M,K] and dense R [M,N].\n");
+        return -1;
+    }
+    size_t M = A->shape[0];
+    size_t K = A->shape[1];
+    size_t N = R->shape[1];
+    if (check_out(out, K, N, "tensor_spmm_t") != 0) return -1;
+
+    // Scatter each row's contribution: out[col, :] += v * R[i, :]
+    double *o = (double*)out->data;
+    memset(o, 0, K * N * sizeof(double));
+    size_t r0 = R->strides[0], r1 = R->strides[1];
+    for (size_t i = 0; i < M; i++) {
+        for (size_t k = csr->indptr[i]; k < csr->indptr[i + 1]; k++) {
+            double v = csr->values[k];
+            double *orow = o + csr->indices[k] * N;
+            for (size_t j = 0; j < N; j++) {
+                orow[j] += v * tensor_read_at_offset(R, i * r0 + j * r1);
+            }
+        }
+    }
+    return 0;
+}
@@ -1,9 +1,45 @@
+#define _DEFAULT_SOURCE   // posix_memalign, MAP_ANONYMOUS, madvise
+
 #include "tensor.h"
+#include "sparse.h"
+#include "compress.h"
+#include "vmath.h"
+#include "parallel.h"
+#include "gemv.h"
+#include "cpu.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <assert.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/** Upper bound on dimensions for stack scratch arrays (matches broadcasting). */
+#define TENSOR_MAX_DIMS 16
+
+/** Buffers of at least this many bytes get huge pages with TENSOR_ALLOC_HUGEPAGE. */
+#define TENSOR_HUGEPAGE_SIZE (2u << 20)
+
+/** Each first-touch thread initializes at least this many bytes. */
+#define FIRST_TOUCH_MIN_BYTES (1u << 20)
+
+/**
+ * Elementwise ops and reductions go parallel from this many elements, in
+ * chunks of TENSOR_GRAIN. Reductions above the threshold always use the
+ * chunked summation order, whatever the thread count.
+ */
+#define TENSOR_PARALLEL_MIN (1u << 16)
+#define TENSOR_GRAIN        (1u << 14)
+
+/** Elements staged per block when a unary op cannot run on t->data directly. */
+#define UNARY_BLOCK 256
+
+/** Rows ahead whose first cache lines gathers and scatters prefetch. */
+#define GATHER_PREFETCH_ROWS  8
+#define GATHER_PREFETCH_LINES 4
 
 /* ------------------------------------------------------------------------- */
 /*                           HELPER FUNCTIONS                                */
@@ -27,6 +63,50 @@ static void compute_strides(size_t ndim, const size_t *shape, size_t *strides) {
     }
 }
 
+/**
+ * Recompute the layout flags from shape/strides. Size-1 dimensions are
+ * ignored since their stride is never used to step between elements.
+ */
+static void update_flags(Tensor *t) {
+    int contiguous = 1;
+    if (t->num_elems > 0) {
+        size_t expected = 1;
+        for (int i = (int)t->ndim - 1; i >= 0; i--) {
+            if (t->shape[i] == 1) continue;
+            if (t->strides[i] != expected) {
+                contiguous = 0;
+                break;
+            }
+            expected *= t->shape[i];
+        }
+    }
+    t->flags = contiguous ? TENSOR_FLAG_C_CONTIGUOUS : 0;
+}
+
+/**
+ * Map a row-major logical element index to an offset into t->data.
+ * Identity for contiguous tensors; otherwise unravels through the strides.
+ */
+static size_t linear_to_offset(const Tensor *t, size_t linear) {
+    if (t->flags & TENSOR_FLAG_C_CONTIGUOUS) return linear;
+    size_t offset = 0;
+    for (int i = (int)t->ndim - 1; i >= 0; i--) {
+        size_t dim = t->shape[i];
+        offset += (linear % dim) * t->strides[i];
+        linear /= dim;
+    }
+    return offset;
+}
+
+/** Report and reject tensors whose elements are not addressable through strides. */
+static int require_strided(const Tensor *t, const char *fn) {
+    if (t->layout != TENSOR_LAYOUT_STRIDED) {
+        fprintf(stderr, "[%s] only strided tensors are supported.\n", fn);
+        return -1;
+    }
+    return 0;
+}
+
 /** Returns the size in bytes for one element of the given data type. */
 static size_t dtype_size(TensorDtype dtype) {
     switch (dtype) {
@@ -43,12 +123,17 @@ static size_t dtype_size(TensorDtype dtype) {
 /*              PUBLIC: Low-Level Offset-Based Read/Write                    */
 /* ------------------------------------------------------------------------- */
 
+size_t tensor_dtype_size(TensorDtype dtype) {
+    return dtype_size(dtype);
+}
+
 /** Convert a value from the tensor's dtype at offset to double. */
 double tensor_read_at_offset(const Tensor *t, size_t offset) {
     if (!t) {
         fprintf(stderr, "[tensor_read_at_offset] Null tensor.\n");
         return 0.0;
     }
+    assert(t->layout == TENSOR_LAYOUT_STRIDED);   // callers validate the layout
     switch (t->dtype) {
         case TENSOR_FLOAT32:
             return (double)((float*)t->data)[offset];
@@ -67,6 +152,7 @@ void tensor_write_at_offset(Tensor *t, size_t offset, double value) {
         fprintf(stderr, "[tensor_write_at_offset] Null tensor.\n");
         return;
     }
+    assert(t->layout == TENSOR_LAYOUT_STRIDED);   // callers validate the layout
     switch (t->dtype) {
         case TENSOR_FLOAT32:
             ((float*)t->data)[offset] = (float)value;
@@ -83,11 +169,88 @@ void tensor_write_at_offset(Tensor *t, size_t offset, double value) {
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/*                          BUFFER ALLOCATION                                */
+/* ------------------------------------------------------------------------- */
+
+static void touch_range(size_t lo, size_t hi, void *p) {
+    memset((char*)p + lo, 0, hi - lo);
+}
+
+/**
+ * Zero 'bytes' at 'p' as one contiguous share per pool thread. With
+ * first-touch page placement each thread's pages land on its own NUMA
+ * node, matching later parallel loops that split the buffer the same way.
+ */
+static void first_touch(void *p, size_t bytes) {
+    size_t threads = (size_t)parallel_num_threads();
+    size_t share = (bytes + threads - 1) / threads;
+    if (share < FIRST_TOUCH_MIN_BYTES) share = FIRST_TOUCH_MIN_BYTES;
+    parallel_for(bytes, share, touch_range, p);
+}
+
+/**
+ * Allocate t->data according to TENSOR_ALLOC_* flags and record how it was
+ * obtained, so tensor_decref() can release it the same way.
+ */
+static int alloc_buffer(Tensor *t, size_t bytes, int flags) {
+    size_t padded = (bytes + TENSOR_ALIGNMENT - 1) / TENSOR_ALIGNMENT * TENSOR_ALIGNMENT;
+    if (padded == 0) padded = TENSOR_ALIGNMENT;
+
+#ifdef __linux__
+    // Huge pages: explicit (hugetlbfs pool) if reserved, else transparent.
+    // Anonymous mappings arrive zeroed, so TENSOR_ALLOC_ZERO is free here.
+    if ((flags & TENSOR_ALLOC_HUGEPAGE) && bytes >= TENSOR_HUGEPAGE_SIZE) {
+        size_t len = (bytes + TENSOR_HUGEPAGE_SIZE - 1) / TENSOR_HUGEPAGE_SIZE * TENSOR_HUGEPAGE_SIZE;
+        void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (p == MAP_FAILED) {
+            p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (p != MAP_FAILED) madvise(p, len, MADV_HUGEPAGE);
+#endif
+        }
+        if (p != MAP_FAILED) {
+            t->data = p;
+            t->buffer_kind = TENSOR_BUFFER_MAPPED;
+            t->buffer_bytes = len;
+            if (flags & TENSOR_ALLOC_FIRST_TOUCH) first_touch(p, bytes);
+            return 0;
+        }
+    }
+#endif
+
+    void *p = NULL;
+    if (posix_memalign(&p, TENSOR_ALIGNMENT, padded) != 0) return -1;
+    t->data = p;
+    t->buffer_kind = TENSOR_BUFFER_HEAP;
+    t->buffer_bytes = padded;
+    if (flags & TENSOR_ALLOC_FIRST_TOUCH) {
+        first_touch(p, bytes);
+    } else if (flags & TENSOR_ALLOC_ZERO) {
+        memset(p, 0, bytes);
+    }
+    return 0;
+}
+
+/** Release a buffer obtained by alloc_buffer(). */
+static void free_buffer(Tensor *t) {
+#ifdef __linux__
+    if (t->buffer_kind == TENSOR_BUFFER_MAPPED) {
+        munmap(t->data, t->buffer_bytes);
+        return;
+    }
+#endif
+    free(t->data);
+}
+
 /* ------------------------------------------------------------------------- */
 /*                        BASIC TENSOR LIFECYCLE                             */
 /* ------------------------------------------------------------------------- */
 
-Tensor* tensor_create(size_t ndim, const size_t *shape, TensorDtype dtype) {
+Tensor* tensor_create_ex(size_t ndim, const size_t *shape, TensorDtype dtype, int alloc_flags) {
     // Allocate the Tensor struct
     Tensor *t = (Tensor*)malloc(sizeof(Tensor));
     if (!t) {
@@ -99,6 +262,12 @@ Tensor* tensor_create(size_t ndim, const size_t *shape, TensorDtype dtype) {
     t->dtype = dtype;
     t->owner = 1;      // By default, this tensor owns its data
     t->ref_count = 1;  // new tensor has ref_count=1
+    t->base = NULL;
+    t->layout = TENSOR_LAYOUT_STRIDED;
+    t->storage = NULL;
+    t->storage_free = NULL;
+    t->buffer_kind = TENSOR_BUFFER_NONE;
+    t->buffer_bytes = 0;
 
     // Copy shape
     t->shape = (size_t*)malloc(ndim * sizeof(size_t));
@@ -115,6 +284,7 @@ Tensor* tensor_create(size_t ndim, const size_t *shape, TensorDtype dtype) {
     // Compute strides & total elements
     compute_strides(ndim, shape, t->strides);
     t->num_elems = compute_num_elems(ndim, shape);
+    t->flags = TENSOR_FLAG_C_CONTIGUOUS;
 
     // Allocate data buffer
     size_t elem_sz = dtype_size(dtype);
@@ -127,8 +297,7 @@ Tensor* tensor_create(size_t ndim, const size_t *shape, TensorDtype dtype) {
     }
     size_t total_bytes = t->num_elems * elem_sz;
 
-    t->data = calloc(1, total_bytes); // zero-initialized
-    if (!t->data) {
+    if (alloc_buffer(t, total_bytes, alloc_flags) != 0) {
         fprintf(stderr, "Failed to allocate data buffer.\n");
         free(t->shape);
         free(t->strides);
@@ -139,41 +308,123 @@ Tensor* tensor_create(size_t ndim, const size_t *shape, TensorDtype dtype) {
     return t;
 }
 
-/** Decrement ref_count if this is an owner; free data if it hits 0. */
+Tensor* tensor_create(size_t ndim, const size_t *shape, TensorDtype dtype) {
+    return tensor_create_ex(ndim, shape, dtype, TENSOR_ALLOC_ZERO);
+}
+
+Tensor* tensor_empty(size_t ndim, const size_t *shape, TensorDtype dtype) {
+    return tensor_create_ex(ndim, shape, dtype, 0);
+}
+
+/**
+ * Drop one reference on an owning tensor. The owner's own handle and every
+ * view each hold one; when the last goes away the buffer and struct are freed.
+ */
 static void tensor_decref(Tensor *t) {
     if (!t) return;
-    if (t->owner) {
-        t->ref_count--;
-        if (t->ref_count == 0) {
-            // Free data buffer
-            free(t->data);
-            t->data = NULL;
+    t->ref_count--;
+    if (t->ref_count == 0) {
+        if (t->storage && t->storage_free) {
+            t->storage_free(t->storage);
         }
+        free_buffer(t);
+        free(t->shape);
+        free(t->strides);
+        free(t);
     }
 }
 
 void tensor_free(Tensor *t) {
     if (!t) return;
-    // Decrement ref_count if this is an owner
-    tensor_decref(t);
+    if (t->owner) {
+        tensor_decref(t);
+        return;
+    }
 
-    // Free shape/strides and the struct itself
+    // A view: free its own shape/strides and release the owner
+    Tensor *base = t->base;
     free(t->shape);
     free(t->strides);
     free(t);
+    tensor_decref(base);
+}
+
+/**
+ * Allocate a view struct over 'src' with room for 'ndim' dimensions.
+ * The caller fills shape/strides/num_elems and calls update_flags().
+ * The view takes a reference on the owning tensor.
+ */
+static Tensor* tensor_alloc_view(Tensor *src, size_t ndim, void *data) {
+    if (require_strided(src, "tensor view") != 0) return NULL;
+    Tensor *v = (Tensor*)malloc(sizeof(Tensor));
+    if (!v) return NULL;
+
+    size_t alloc_dims = ndim ? ndim : 1;
+    v->shape = (size_t*)malloc(alloc_dims * sizeof(size_t));
+    v->strides = (size_t*)malloc(alloc_dims * sizeof(size_t));
+    if (!v->shape || !v->strides) {
+        free(v->shape);
+        free(v->strides);
+        free(v);
+        return NULL;
+    }
+
+    v->ndim = ndim;
+    v->data = data;
+    v->dtype = src->dtype;
+    v->owner = 0;      // doesn't own the data
+    v->ref_count = 1;  // new struct
+    v->num_elems = 0;
+    v->flags = 0;
+    v->layout = TENSOR_LAYOUT_STRIDED;
+    v->storage = NULL;
+    v->storage_free = NULL;
+    v->buffer_kind = TENSOR_BUFFER_NONE;
+    v->buffer_bytes = 0;
+
+    // Reference the owner of the buffer, not an intermediate view
+    v->base = src->owner ? src : src->base;
+    if (v->base) {
+        v->base->ref_count++;
+    }
+    return v;
+}
+
+typedef struct {
+    const Tensor *src;
+    Tensor       *dst;
+    size_t        elem_sz;
+} CopyContext;
+
+static void copy_range(size_t lo, size_t hi, void *arg) {
+    CopyContext *c = (CopyContext*)arg;
+    const char *in = (const char*)c->src->data;
+    char *out = (char*)c->dst->data;
+    size_t es = c->elem_sz;
+    if (c->src->flags & TENSOR_FLAG_C_CONTIGUOUS) {
+        memcpy(out + lo * es, in + lo * es, (hi - lo) * es);
+        return;
+    }
+    for (size_t i = lo; i < hi; i++) {
+        memcpy(out + i * es, in + linear_to_offset(c->src, i) * es, es);
+    }
 }
 
 Tensor* tensor_copy(const Tensor *src) {
     if (!src) return NULL;
+    if (require_strided(src, "tensor_copy") != 0) return NULL;
 
     // Create a new tensor with the same shape & dtype
-    Tensor *dst = tensor_create(src->ndim, src->shape, src->dtype);
+    Tensor *dst = tensor_empty(src->ndim, src->shape, src->dtype);
     if (!dst) return NULL;
 
-    // Copy the data
-    size_t elem_sz = dtype_size(src->dtype);
-    memcpy(dst->data, src->data, src->num_elems * elem_sz);
-
+    // Copy the data (flat memcpy when the source has no gaps)
+    CopyContext ctx = { src, dst, dtype_size(src->dtype) };
+    if (src->num_elems >= TENSOR_PARALLEL_MIN) {
+        parallel_for(src->num_elems, TENSOR_GRAIN, copy_range, &ctx);
+    } else {
+        copy_range(0, src->num_elems, &ctx);
+    }
     return dst;
 }
 
@@ -183,6 +434,7 @@ Tensor* tensor_copy(const Tensor *src) {
 
 int tensor_reshape(Tensor *t, size_t ndim, const size_t *new_shape) {
     if (!t || !new_shape) return -1;
+    if (require_strided(t, "tensor_reshape") != 0) return -1;
 
     // Check total elements
     size_t new_num = compute_num_elems(ndim, new_shape);
@@ -191,6 +443,12 @@ int tensor_reshape(Tensor *t, size_t ndim, const size_t *new_shape) {
         return -1;
     }
 
+    // Recomputing contiguous strides is only valid for a gap-free layout
+    if (!(t->flags & TENSOR_FLAG_C_CONTIGUOUS)) {
+        fprintf(stderr, "[tensor_reshape] tensor is not contiguous.\n");
+        return -1;
+    }
+
     // Freed old shape/strides
     free(t->shape);
     free(t->strides);
@@ -206,62 +464,249 @@ int tensor_reshape(Tensor *t, size_t ndim, const size_t *new_shape) {
     memcpy(t->shape, new_shape, ndim * sizeof(size_t));
     t->ndim = ndim;
     compute_strides(ndim, t->shape, t->strides);
+    update_flags(t);
 
     return 0;
 }
 
-Tensor* tensor_slice(Tensor *src, const size_t *start, const size_t *end) {
-    if (!src || !start || !end) return NULL;
+int tensor_is_contiguous(const Tensor *t) {
+    return t && (t->flags & TENSOR_FLAG_C_CONTIGUOUS);
+}
 
-    // Create a new Tensor struct that references the same data
-    Tensor *slice_t = (Tensor*)malloc(sizeof(Tensor));
-    if (!slice_t) return NULL;
+Tensor* tensor_contiguous(Tensor *t) {
+    if (!t) return NULL;
+    if (!(t->flags & TENSOR_FLAG_C_CONTIGUOUS)) {
+        return tensor_copy(t);
+    }
+
+    // Already contiguous => same layout as a view
+    Tensor *v = tensor_alloc_view(t, t->ndim, t->data);
+    if (!v) return NULL;
+    memcpy(v->shape, t->shape, t->ndim * sizeof(size_t));
+    memcpy(v->strides, t->strides, t->ndim * sizeof(size_t));
+    v->num_elems = t->num_elems;
+    update_flags(v);
+    return v;
+}
+
+/**
+ * Try to express 'new_shape' over the existing strides of 't' without
+ * copying. Old dimensions are grouped with new dimensions whose products
+ * match; each old group must itself be laid out contiguously.
+ * Returns 0 and fills 'new_strides' on success, -1 if a copy is needed.
+ */
+static int nocopy_reshape_strides(const Tensor *t, size_t ndim,
+                                  const size_t *new_shape, size_t *new_strides) {
+    // Size-1 dimensions carry no layout information; drop them
+    size_t old_shape[TENSOR_MAX_DIMS];
+    size_t old_strides[TENSOR_MAX_DIMS];
+    size_t old_nd = 0;
+    for (size_t i = 0; i < t->ndim; i++) {
+        if (t->shape[i] != 1) {
+            old_shape[old_nd] = t->shape[i];
+            old_strides[old_nd] = t->strides[i];
+            old_nd++;
+        }
+    }
+
+    size_t oi = 0, oj = 1, ni = 0, nj = 1;
+    while (ni < ndim && oi < old_nd) {
+        size_t np = new_shape[ni];
+        size_t op = old_shape[oi];
+        while (np != op) {
+            if (np < op) {
+                np *= new_shape[nj++];
+            } else {
+                op *= old_shape[oj++];
+            }
+        }
+
+        // The merged old dimensions must be contiguous among themselves
+        for (size_t ok = oi; ok + 1 < oj; ok++) {
+            if (old_strides[ok] != old_shape[ok + 1] * old_strides[ok + 1]) {
+                return -1;
+            }
+        }
+
+        // Lay the new dimensions of this group over the group's innermost stride
+        new_strides[nj - 1] = old_strides[oj - 1];
+        for (size_t nk = nj - 1; nk > ni; nk--) {
+            new_strides[nk - 1] = new_strides[nk] * new_shape[nk];
+        }
+
+        ni = nj++;
+        oi = oj++;
+    }
+
+    // Any remaining new dimensions have size 1; their stride is irrelevant
+    size_t last = (ni > 0) ? new_strides[ni - 1] : 1;
+    for (size_t nk = ni; nk < ndim; nk++) {
+        new_strides[nk] = last;
+    }
+    return 0;
+}
+
+Tensor* tensor_view_reshape(Tensor *t, size_t ndim, const size_t *new_shape) {
+    if (!t || !new_shape) return NULL;
+    if (ndim > TENSOR_MAX_DIMS || t->ndim > TENSOR_MAX_DIMS) {
+        fprintf(stderr, "[tensor_view_reshape] too many dimensions.\n");
+        return NULL;
+    }
+    if (compute_num_elems(ndim, new_shape) != t->num_elems) {
+        fprintf(stderr, "[tensor_view_reshape] total elements mismatch.\n");
+        return NULL;
+    }
+
+    size_t new_strides[TENSOR_MAX_DIMS];
+    if ((t->flags & TENSOR_FLAG_C_CONTIGUOUS) || t->num_elems == 0) {
+        compute_strides(ndim, new_shape, new_strides);
+    } else if (nocopy_reshape_strides(t, ndim, new_shape, new_strides) != 0) {
+        return NULL;  // layout cannot express the new shape; caller must copy
+    }
+
+    Tensor *v = tensor_alloc_view(t, ndim, t->data);
+    if (!v) return NULL;
+    memcpy(v->shape, new_shape, ndim * sizeof(size_t));
+    memcpy(v->strides, new_strides, ndim * sizeof(size_t));
+    v->num_elems = t->num_elems;
+    update_flags(v);
+    return v;
+}
+
+Tensor* tensor_expand(Tensor *t, size_t ndim, const size_t *new_shape) {
+    if (!t || !new_shape) return NULL;
+    if (ndim < t->ndim) {
+        fprintf(stderr, "[tensor_expand] cannot expand to fewer dimensions.\n");
+        return NULL;
+    }
+
+    // Validate before allocating: aligned from the right, like broadcasting
+    size_t lead = ndim - t->ndim;
+    for (size_t i = 0; i < t->ndim; i++) {
+        if (t->shape[i] != new_shape[lead + i] && t->shape[i] != 1) {
+            fprintf(stderr, "[tensor_expand] shape mismatch at dim %zu.\n", i);
+            return NULL;
+        }
+    }
+
+    Tensor *v = tensor_alloc_view(t, ndim, t->data);
+    if (!v) return NULL;
+    for (size_t i = 0; i < ndim; i++) {
+        v->shape[i] = new_shape[i];
+        if (i < lead) {
+            v->strides[i] = 0;
+        } else {
+            size_t si = i - lead;
+            v->strides[i] = (t->shape[si] == new_shape[i]) ? t->strides[si] : 0;
+        }
+    }
+    v->num_elems = compute_num_elems(ndim, new_shape);
+    update_flags(v);
+    return v;
+}
+
+Tensor* tensor_squeeze(Tensor *t, int dim) {
+    if (!t) return NULL;
+    if (dim >= (int)t->ndim || (dim >= 0 && t->shape[dim] != 1)) {
+        fprintf(stderr, "[tensor_squeeze] dim %d is not a size-1 dimension.\n", dim);
+        return NULL;
+    }
+
+    size_t keep = 0;
+    for (size_t i = 0; i < t->ndim; i++) {
+        int drop = (dim < 0) ? (t->shape[i] == 1) : ((int)i == dim);
+        if (!drop) keep++;
+    }
+
+    Tensor *v = tensor_alloc_view(t, keep, t->data);
+    if (!v) return NULL;
+    size_t k = 0;
+    for (size_t i = 0; i < t->ndim; i++) {
+        int drop = (dim < 0) ? (t->shape[i] == 1) : ((int)i == dim);
+        if (!drop) {
+            v->shape[k] = t->shape[i];
+            v->strides[k] = t->strides[i];
+            k++;
+        }
+    }
+    v->num_elems = t->num_elems;
+    update_flags(v);
+    return v;
+}
+
+Tensor* tensor_unsqueeze(Tensor *t, size_t dim) {
+    if (!t) return NULL;
+    if (dim > t->ndim) {
+        fprintf(stderr, "[tensor_unsqueeze] dim %zu out of range.\n", dim);
+        return NULL;
+    }
 
-    slice_t->dtype = src->dtype;
-    slice_t->owner = 0;  // doesn't own the data
-    slice_t->ref_count = 1; // new struct
-    slice_t->ndim = src->ndim;
-
-    // Allocate shape & strides
-    slice_t->shape = (size_t*)malloc(slice_t->ndim * sizeof(size_t));
-    slice_t->strides = (size_t*)malloc(slice_t->ndim * sizeof(size_t));
-    if (!slice_t->shape || !slice_t->strides) {
-        free(slice_t->shape);
-        free(slice_t->strides);
-        free(slice_t);
+    Tensor *v = tensor_alloc_view(t, t->ndim + 1, t->data);
+    if (!v) return NULL;
+    for (size_t i = 0, k = 0; i < t->ndim + 1; i++) {
+        if (i == dim) {
+            v->shape[i] = 1;
+            // Any stride works for size 1; pick the one a contiguous layout would use
+            v->strides[i] = (dim < t->ndim) ? t->strides[dim] * t->shape[dim] : 1;
+        } else {
+            v->shape[i] = t->shape[k];
+            v->strides[i] = t->strides[k];
+            k++;
+        }
+    }
+    v->num_elems = t->num_elems;
+    update_flags(v);
+    return v;
+}
+
+Tensor* tensor_transpose(Tensor *t) {
+    if (!t) return NULL;
+    if (t->ndim != 2) {
+        fprintf(stderr, "[tensor_transpose] only supports 2D.\n");
         return NULL;
     }
 
-    // Compute new shape
+    Tensor *v = tensor_alloc_view(t, 2, t->data);
+    if (!v) return NULL;
+    v->shape[0] = t->shape[1];
+    v->shape[1] = t->shape[0];
+    v->strides[0] = t->strides[1];
+    v->strides[1] = t->strides[0];
+    v->num_elems = t->num_elems;
+    update_flags(v);
+    return v;
+}
+
+Tensor* tensor_slice(Tensor *src, const size_t *start, const size_t *end) {
+    if (!src || !start || !end) return NULL;
+
+    // Validate the range before allocating anything
     for (size_t i = 0; i < src->ndim; i++) {
         if (end[i] <= start[i] || end[i] > src->shape[i]) {
             fprintf(stderr, "[tensor_slice] invalid slice range.\n");
-            free(slice_t->shape);
-            free(slice_t->strides);
-            free(slice_t);
             return NULL;
         }
-        slice_t->shape[i] = end[i] - start[i];
     }
-    slice_t->num_elems = compute_num_elems(slice_t->ndim, slice_t->shape);
-
-    // Copy strides from the parent
-    memcpy(slice_t->strides, src->strides, src->ndim * sizeof(size_t));
 
-    // Compute the offset (in elements)
+    // Compute the offset (in elements), then convert to a byte offset
     size_t offset = 0;
     for (size_t i = 0; i < src->ndim; i++) {
         offset += start[i] * src->strides[i];
     }
-
-    // Convert element offset to byte offset
     size_t elem_sz = dtype_size(src->dtype);
-    slice_t->data = (char*)src->data + (offset * elem_sz);
 
-    // If src is an owner, increment ref_count
-    if (src->owner) {
-        src->ref_count++;
+    // Create a new Tensor struct that references the same data
+    Tensor *slice_t = tensor_alloc_view(src, src->ndim,
+                                        (char*)src->data + (offset * elem_sz));
+    if (!slice_t) return NULL;
+
+    // Compute new shape; strides are inherited from the parent
+    for (size_t i = 0; i < src->ndim; i++) {
+        slice_t->shape[i] = end[i] - start[i];
     }
+    memcpy(slice_t->strides, src->strides, src->ndim * sizeof(size_t));
+    slice_t->num_elems = compute_num_elems(slice_t->ndim, slice_t->shape);
+    update_flags(slice_t);
 
     return slice_t;
 }
@@ -292,13 +737,22 @@ void tensor_print(const Tensor *t, const char *name) {
         default:             printf("unknown\n"); break;
     }
     printf("  num_elems = %zu\n", t->num_elems);
-    printf("  owner = %d, ref_count = %d\n", t->owner, t->ref_count);
+    printf("  owner = %d, ref_count = %d, contiguous = %d\n",
+           t->owner, t->ref_count, (t->flags & TENSOR_FLAG_C_CONTIGUOUS) ? 1 : 0);
+    if (t->layout == TENSOR_LAYOUT_CSR) {
+        printf("  layout = csr, nnz = %zu\n", tensor_csr(t)->nnz);
+        return;
+    }
+    if (t->layout == TENSOR_LAYOUT_COMPRESSED) {
+        printf("  layout = compressed, bytes = %zu\n", tensor_compressed(t)->num_bytes);
+        return;
+    }
 
     // Print the first few elements
     size_t max_print = (t->num_elems < 10) ? t->num_elems : 10;
     printf("  data[0..%zu]: ", max_print - 1);
     for (size_t i = 0; i < max_print; i++) {
-        double val = tensor_read_at_offset(t, i);
+        double val = tensor_read_at_offset(t, linear_to_offset(t, i));
         printf("%.3g ", val);
     }
     if (max_print < t->num_elems) {
@@ -312,7 +766,7 @@ void tensor_print(const Tensor *t, const char *name) {
 /* ------------------------------------------------------------------------- */
 
 double tensor_get(const Tensor *t, const size_t *indices) {
-    if (!t || !indices) return 0.0;
+    if (!t || !indices || require_strided(t, "tensor_get") != 0) return 0.0;
     // Compute the linear offset
     size_t offset = 0;
     for (size_t i = 0; i < t->ndim; i++) {
@@ -322,7 +776,7 @@ double tensor_get(const Tensor *t, const size_t *indices) {
 }
 
 void tensor_set(Tensor *t, const size_t *indices, double value) {
-    if (!t || !indices) return;
+    if (!t || !indices || require_strided(t, "tensor_set") != 0) return;
     size_t offset = 0;
     for (size_t i = 0; i < t->ndim; i++) {
         offset += indices[i] * t->strides[i];
@@ -341,9 +795,8 @@ void tensor_set(Tensor *t, const size_t *indices, double value) {
 static int broadcast_shapes(const Tensor *a, const Tensor *b,
                             size_t *out_ndim, size_t *out_shape) {
     // We'll handle up to 16 dims for demonstration. Real code might do dynamic allocation.
-    const size_t MAX_DIMS = 16;
-    size_t rev_shape_a[MAX_DIMS] = {0};
-    size_t rev_shape_b[MAX_DIMS] = {0};
+    size_t rev_shape_a[TENSOR_MAX_DIMS] = {0};
+    size_t rev_shape_b[TENSOR_MAX_DIMS] = {0};
 
     // Copy shapes in reverse order for easier handling
     for (size_t i = 0; i < a->ndim; i++) {
@@ -438,10 +891,37 @@ static void broadcast_recursive(const Tensor *a, const Tensor *b, Tensor *out,
     }
 }
 
+/** Flat elementwise loop over [lo, hi); 'b' is either same-shape or a scalar. */
+typedef struct {
+    const Tensor *a;
+    const Tensor *b;
+    Tensor       *out;
+    double      (*f)(double, double);
+    CpuBinaryOp   op;
+    int           b_scalar;
+    double        vb;
+} FlatOpContext;
+
+static void flat_op_range(size_t lo, size_t hi, void *arg) {
+    FlatOpContext *c = (FlatOpContext*)arg;
+    if (c->a->dtype == TENSOR_FLOAT64 && c->out->dtype == TENSOR_FLOAT64 &&
+        (c->b_scalar || c->b->dtype == TENSOR_FLOAT64)) {
+        const double *b = c->b_scalar ? &c->vb : (const double*)c->b->data + lo;
+        cpu_kernels()->binary_f64(c->op, (const double*)c->a->data + lo, b, c->b_scalar,
+                                  (double*)c->out->data + lo, hi - lo);
+        return;
+    }
+    for (size_t i = lo; i < hi; i++) {
+        double vb = c->b_scalar ? c->vb : tensor_read_at_offset(c->b, i);
+        tensor_write_at_offset(c->out, i, c->f(tensor_read_at_offset(c->a, i), vb));
+    }
+}
+
 static Tensor* tensor_broadcast_op(const Tensor *a, const Tensor *b,
-                                   double (*f)(double, double),
+                                   double (*f)(double, double), CpuBinaryOp op,
                                    const char *op_name) {
     if (!a || !b) return NULL;
+    if (require_strided(a, op_name) != 0 || require_strided(b, op_name) != 0) return NULL;
 
     // 1) Compute broadcasted shape
     size_t out_ndim = 0;
@@ -452,10 +932,25 @@ static Tensor* tensor_broadcast_op(const Tensor *a, const Tensor *b,
     }
 
     // 2) Create output tensor
-    Tensor *out = tensor_create(out_ndim, out_shape, a->dtype);
+    Tensor *out = tensor_empty(out_ndim, out_shape, a->dtype);
     if (!out) return NULL;
 
-    // 3) Fill out with recursive broadcast
+    // 3) Flat loops when neither operand needs index arithmetic:
+    //    same-shape contiguous operands, or a contiguous 'a' with scalar 'b'
+    int flat_a = (a->flags & TENSOR_FLAG_C_CONTIGUOUS) && a->num_elems == out->num_elems;
+    int flat_b = (b->flags & TENSOR_FLAG_C_CONTIGUOUS) && b->num_elems == out->num_elems;
+    if (flat_a && (flat_b || b->num_elems == 1)) {
+        double vb = flat_b ? 0.0 : tensor_read_at_offset(b, 0);
+        FlatOpContext ctx = { a, b, out, f, op, !flat_b, vb };
+        if (out->num_elems >= TENSOR_PARALLEL_MIN) {
+            parallel_for(out->num_elems, TENSOR_GRAIN, flat_op_range, &ctx);
+        } else {
+            flat_op_range(0, out->num_elems, &ctx);
+        }
+        return out;
+    }
+
+    // 4) Otherwise fill out with recursive broadcast
     size_t idx[16] = {0};
     broadcast_recursive(a, b, out, 0, idx, f);
     return out;
@@ -464,53 +959,619 @@ static Tensor* tensor_broadcast_op(const Tensor *a, const Tensor *b,
 /* ----------------------- Actual Public Eltwise Ops ------------------------ */
 
 Tensor* tensor_add(const Tensor *a, const Tensor *b) {
-    return tensor_broadcast_op(a, b, add_op, "tensor_add");
+    return tensor_broadcast_op(a, b, add_op, CPU_OP_ADD, "tensor_add");
 }
 Tensor* tensor_sub(const Tensor *a, const Tensor *b) {
-    return tensor_broadcast_op(a, b, sub_op, "tensor_sub");
+    return tensor_broadcast_op(a, b, sub_op, CPU_OP_SUB, "tensor_sub");
 }
 Tensor* tensor_mul(const Tensor *a, const Tensor *b) {
-    return tensor_broadcast_op(a, b, mul_op, "tensor_mul");
+    return tensor_broadcast_op(a, b, mul_op, CPU_OP_MUL, "tensor_mul");
 }
 Tensor* tensor_div(const Tensor *a, const Tensor *b) {
-    return tensor_broadcast_op(a, b, div_op, "tensor_div");
+    return tensor_broadcast_op(a, b, div_op, CPU_OP_DIV, "tensor_div");
+}
+
+/* ------------------------------------------------------------------------- */
+/*                          ELEMENTWISE UNARY OPS                            */
+/* ------------------------------------------------------------------------- */
+
+typedef void (*UnaryKernel)(const double *x, double *y, size_t n);
+
+static UnaryKernel unary_kernel(TensorUnaryOp op) {
+    switch (op) {
+        case TENSOR_OP_ABS:     return vmath_abs;
+        case TENSOR_OP_NEG:     return vmath_neg;
+        case TENSOR_OP_SQUARE:  return vmath_square;
+        case TENSOR_OP_SQRT:    return vmath_sqrt;
+        case TENSOR_OP_EXP:     return vmath_exp;
+        case TENSOR_OP_LOG:     return vmath_log;
+        case TENSOR_OP_SIGMOID: return vmath_sigmoid;
+        case TENSOR_OP_TANH:    return vmath_tanh;
+        default:                return NULL;
+    }
+}
+
+typedef struct {
+    const Tensor *t;
+    Tensor       *out;
+    UnaryKernel   k;
+} UnaryContext;
+
+static void unary_range(size_t lo, size_t hi, void *arg) {
+    UnaryContext *c = (UnaryContext*)arg;
+    const Tensor *t = c->t;
+    Tensor *out = c->out;
+
+    // Fast path: kernel runs straight over the buffers
+    if (t->dtype == TENSOR_FLOAT64 && out->dtype == TENSOR_FLOAT64 &&
+        (t->flags & TENSOR_FLAG_C_CONTIGUOUS) && (out->flags & TENSOR_FLAG_C_CONTIGUOUS)) {
+        c->k((const double*)t->data + lo, (double*)out->data + lo, hi - lo);
+        return;
+    }
+
+    // Otherwise gather a block into doubles, run the kernel, scatter back
+    // (contiguous float32 converts with the dispatched kernels)
+    const CpuKernels *ck = cpu_kernels();
+    int f32_in = t->dtype == TENSOR_FLOAT32 && (t->flags & TENSOR_FLAG_C_CONTIGUOUS);
+    int f32_out = out->dtype == TENSOR_FLOAT32 && (out->flags & TENSOR_FLAG_C_CONTIGUOUS);
+    double buf[UNARY_BLOCK];
+    for (size_t i0 = lo; i0 < hi; i0 += UNARY_BLOCK) {
+        size_t m = hi - i0 < UNARY_BLOCK ? hi - i0 : UNARY_BLOCK;
+        if (f32_in) {
+            ck->f32_to_f64((const float*)t->data + i0, buf, m);
+        } else {
+            for (size_t i = 0; i < m; i++) {
+                buf[i] = tensor_read_at_offset(t, linear_to_offset(t, i0 + i));
+            }
+        }
+        c->k(buf, buf, m);
+        if (f32_out) {
+            ck->f64_to_f32(buf, (float*)out->data + i0, m);
+        } else {
+            for (size_t i = 0; i < m; i++) {
+                tensor_write_at_offset(out, linear_to_offset(out, i0 + i), buf[i]);
+            }
+        }
+    }
+}
+
+int tensor_unary_out(const Tensor *t, TensorUnaryOp op, Tensor *out) {
+    if (!t || !out) return -1;
+    if (require_strided(t, "tensor_unary") != 0 || require_strided(out, "tensor_unary") != 0) {
+        return -1;
+    }
+    UnaryKernel k = unary_kernel(op);
+    if (!k) {
+        fprintf(stderr, "[tensor_unary] unknown op %d.\n", (int)op);
+        return -1;
+    }
+    if (t->ndim != out->ndim || memcmp(t->shape, out->shape, t->ndim * sizeof(size_t)) != 0) {
+        fprintf(stderr, "[tensor_unary] out shape does not match input.\n");
+        return -1;
+    }
+
+    UnaryContext ctx = { t, out, k };
+    if (t->num_elems >= TENSOR_PARALLEL_MIN) {
+        parallel_for(t->num_elems, TENSOR_GRAIN, unary_range, &ctx);
+    } else {
+        unary_range(0, t->num_elems, &ctx);
+    }
+    return 0;
+}
+
+int tensor_unary_inplace(Tensor *t, TensorUnaryOp op) {
+    return tensor_unary_out(t, op, t);
+}
+
+Tensor* tensor_unary(const Tensor *t, TensorUnaryOp op) {
+    if (!t || require_strided(t, "tensor_unary") != 0) return NULL;
+    TensorDtype dtype = (t->dtype == TENSOR_FLOAT32) ? TENSOR_FLOAT32 : TENSOR_FLOAT64;
+    Tensor *out = tensor_empty(t->ndim, t->shape, dtype);
+    if (!out) return NULL;
+    if (tensor_unary_out(t, op, out) != 0) {
+        tensor_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/* ------------------------------------------------------------------------- */
+/*                        GATHER, SCATTER & JOIN                             */
+/* ------------------------------------------------------------------------- */
+
+/** Index k of a 1D index tensor; negative values map to SIZE_MAX. */
+static inline size_t index_at(const Tensor *idx, size_t k) {
+    if (idx->dtype == TENSOR_INT32) {
+        int v = ((const int*)idx->data)[k * idx->strides[0]];
+        return v >= 0 ? (size_t)v : SIZE_MAX;
+    }
+    double v = tensor_read_at_offset(idx, k * idx->strides[0]);
+    return v >= 0.0 ? (size_t)v : SIZE_MAX;
+}
+
+/** Check a row-index tensor against 'rows'; returns its length or SIZE_MAX. */
+static size_t check_indices(const Tensor *idx, size_t rows, const char *fn) {
+    if (!idx || idx->layout != TENSOR_LAYOUT_STRIDED || idx->ndim != 1) {
+        fprintf(stderr, "[%s] indices must be a 1D strided tensor.\n", fn);
+        return SIZE_MAX;
+    }
+    for (size_t k = 0; k < idx->shape[0]; k++) {
+        if (index_at(idx, k) >= rows) {
+            fprintf(stderr, "[%s] index %zu out of range.\n", fn, k);
+            return SIZE_MAX;
+        }
+    }
+    return idx->shape[0];
+}
+
+/** 1 if every row (dims 1..) of t is one contiguous run of elements. */
+static int rows_contiguous(const Tensor *t) {
+    size_t expected = 1;
+    for (size_t d = t->ndim; d-- > 1;) {
+        if (t->shape[d] != 1 && t->strides[d] != expected) return 0;
+        expected *= t->shape[d];
+    }
+    return 1;
+}
+
+/** Offset of element j within a row (dims 1..) of t. */
+static size_t row_offset(const Tensor *t, size_t j) {
+    size_t off = 0;
+    for (size_t d = t->ndim; d-- > 1;) {
+        off += (j % t->shape[d]) * t->strides[d];
+        j /= t->shape[d];
+    }
+    return off;
+}
+
+/** Same shape in dims 1..; dim 0 may differ. */
+static int same_row_shape(const Tensor *a, const Tensor *b) {
+    if (a->ndim != b->ndim || a->ndim == 0) return 0;
+    return memcmp(a->shape + 1, b->shape + 1, (a->ndim - 1) * sizeof(size_t)) == 0;
+}
+
+static inline void prefetch_row(const char *row, size_t bytes, int write) {
+    for (size_t b = 0; b < bytes && b < GATHER_PREFETCH_LINES * 64; b += 64) {
+        if (write) {
+            __builtin_prefetch(row + b, 1);
+        } else {
+            __builtin_prefetch(row + b, 0);
+        }
+    }
+}
+
+typedef struct {
+    const Tensor *src;
+    const Tensor *idx;
+    Tensor       *out;
+    size_t        row_elems;
+    int           fast;
+} GatherContext;
+
+static void gather_range(size_t lo, size_t hi, void *arg) {
+    const GatherContext *g = (const GatherContext*)arg;
+    const Tensor *src = g->src;
+    Tensor *out = g->out;
+    size_t re = g->row_elems;
+    if (g->fast) {
+        size_t es = dtype_size(src->dtype);
+        const char *in = (const char*)src->data;
+        char *o = (char*)out->data;
+        for (size_t k = lo; k < hi; k++) {
+            if (k + GATHER_PREFETCH_ROWS < hi) {
+                prefetch_row(in + index_at(g->idx, k + GATHER_PREFETCH_ROWS) * src->strides[0] * es,
+                             re * es, 0);
+            }
+            memcpy(o + k * out->strides[0] * es, in + index_at(g->idx, k) * src->strides[0] * es,
+                   re * es);
+        }
+        return;
+    }
+    for (size_t k = lo; k < hi; k++) {
+        size_t r = index_at(g->idx, k);
+        for (size_t j = 0; j < re; j++) {
+            double v = tensor_read_at_offset(src, r * src->strides[0] + row_offset(src, j));
+            tensor_write_at_offset(out, k * out->strides[0] + row_offset(out, j), v);
+        }
+    }
+}
+
+int tensor_index_select_out(const Tensor *src, const Tensor *indices, Tensor *out) {
+    if (!src || !out) return -1;
+    if (require_strided(src, "tensor_index_select") != 0 ||
+        require_strided(out, "tensor_index_select") != 0) {
+        return -1;
+    }
+    size_t count = check_indices(indices, src->ndim ? src->shape[0] : 0, "tensor_index_select");
+    if (count == SIZE_MAX) return -1;
+    if (!same_row_shape(src, out) || out->shape[0] != count) {
+        fprintf(stderr, "[tensor_index_select] out must be [len(indices), src->shape[1..]].\n");
+        return -1;
+    }
+    size_t row_elems = src->shape[0] ? src->num_elems / src->shape[0] : 0;
+    GatherContext g = { src, indices, out, row_elems,
+                        src->dtype == out->dtype && rows_contiguous(src) && rows_contiguous(out) };
+    if (count * row_elems >= TENSOR_PARALLEL_MIN) {
+        parallel_for(count, TENSOR_GRAIN / (row_elems ? row_elems : 1) + 1, gather_range, &g);
+    } else {
+        gather_range(0, count, &g);
+    }
+    return 0;
+}
+
+Tensor* tensor_index_select(Tensor *src, const Tensor *indices) {
+    if (!src || require_strided(src, "tensor_index_select") != 0 || src->ndim == 0) return NULL;
+    size_t count = check_indices(indices, src->shape[0], "tensor_index_select");
+    if (count == SIZE_MAX) return NULL;
+
+    // Contiguous ascending range: a view, no copy
+    size_t first = count ? index_at(indices, 0) : 0;
+    int range = count > 0;
+    for (size_t k = 1; k < count && range; k++) {
+        range = index_at(indices, k) == first + k;
+    }
+    if (range) {
+        size_t start[TENSOR_MAX_DIMS] = { 0 }, end[TENSOR_MAX_DIMS];
+        if (src->ndim > TENSOR_MAX_DIMS) return NULL;
+        memcpy(end, src->shape, src->ndim * sizeof(size_t));
+        start[0] = first;
+        end[0] = first + count;
+        return tensor_slice(src, start, end);
+    }
+
+    size_t shape[TENSOR_MAX_DIMS];
+    if (src->ndim > TENSOR_MAX_DIMS) return NULL;
+    memcpy(shape, src->shape, src->ndim * sizeof(size_t));
+    shape[0] = count;
+    Tensor *out = tensor_empty(src->ndim, shape, src->dtype);
+    if (out && tensor_index_select_out(src, indices, out) != 0) {
+        tensor_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+int tensor_scatter_add(Tensor *dst, const Tensor *indices, const Tensor *src) {
+    if (!dst || !src) return -1;
+    if (require_strided(dst, "tensor_scatter_add") != 0 ||
+        require_strided(src, "tensor_scatter_add") != 0) {
+        return -1;
+    }
+    size_t count = check_indices(indices, dst->ndim ? dst->shape[0] : 0, "tensor_scatter_add");
+    if (count == SIZE_MAX) return -1;
+    if (!same_row_shape(dst, src) || src->shape[0] != count) {
+        fprintf(stderr, "[tensor_scatter_add] src must be [len(indices), dst->shape[1..]].\n");
+        return -1;
+    }
+    size_t re = dst->shape[0] ? dst->num_elems / dst->shape[0] : 0;
+
+    // Float64 contiguous rows: one vector add per row, in order of k
+    if (dst->dtype == TENSOR_FLOAT64 && src->dtype == TENSOR_FLOAT64 &&
+        rows_contiguous(dst) && rows_contiguous(src)) {
+        const CpuKernels *ck = cpu_kernels();
+        double *d = (double*)dst->data;
+        const double *s = (const double*)src->data;
+        for (size_t k = 0; k < count; k++) {
+            if (k + GATHER_PREFETCH_ROWS < count) {
+                prefetch_row((const char*)(d + index_at(indices, k + GATHER_PREFETCH_ROWS) * dst->strides[0]),
+                             re * sizeof(double), 1);
+            }
+            double *row = d + index_at(indices, k) * dst->strides[0];
+            ck->binary_f64(CPU_OP_ADD, row, s + k * src->strides[0], 0, row, re);
+        }
+        return 0;
+    }
+    for (size_t k = 0; k < count; k++) {
+        size_t r = index_at(indices, k);
+        for (size_t j = 0; j < re; j++) {
+            size_t od = r * dst->strides[0] + row_offset(dst, j);
+            double v = tensor_read_at_offset(src, k * src->strides[0] + row_offset(src, j));
+            tensor_write_at_offset(dst, od, tensor_read_at_offset(dst, od) + v);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Join viewed as [outer, mid_i, inner] blocks: input i contributes
+ * mid_i * inner contiguous elements of the output for each outer index.
+ * Units are (outer index, input) pairs.
+ */
+typedef struct {
+    const Tensor *const *ts;
+    size_t               count;
+    const size_t        *mid;
+    const size_t        *mid_off;
+    size_t               total_mid;
+    size_t               inner;
+    Tensor              *out;
+} JoinContext;
+
+static void join_range(size_t lo, size_t hi, void *arg) {
+    const JoinContext *c = (const JoinContext*)arg;
+    size_t es = dtype_size(c->out->dtype);
+    for (size_t u = lo; u < hi; u++) {
+        size_t o = u / c->count, i = u % c->count;
+        const Tensor *t = c->ts[i];
+        size_t n = c->mid[i] * c->inner;
+        size_t src0 = o * n;
+        size_t dst0 = (o * c->total_mid + c->mid_off[i]) * c->inner;
+        if (t->dtype == c->out->dtype && (t->flags & TENSOR_FLAG_C_CONTIGUOUS)) {
+            memcpy((char*)c->out->data + dst0 * es, (const char*)t->data + src0 * es, n * es);
+        } else {
+            for (size_t e = 0; e < n; e++) {
+                tensor_write_at_offset(c->out, dst0 + e,
+                                       tensor_read_at_offset(t, linear_to_offset(t, src0 + e)));
+            }
+        }
+    }
+}
+
+static Tensor* tensor_join(const Tensor *const *ts, size_t count, size_t dim, int stack,
+                           const char *fn) {
+    if (!ts || count == 0 || !ts[0]) {
+        fprintf(stderr, "[%s] no input tensors.\n", fn);
+        return NULL;
+    }
+    const Tensor *t0 = ts[0];
+    size_t nd = t0->ndim;
+    if (dim > nd || (!stack && dim == nd) || nd + (size_t)stack > TENSOR_MAX_DIMS) {
+        fprintf(stderr, "[%s] invalid dim %zu.\n", fn, dim);
+        return NULL;
+    }
+    size_t *mid = (size_t*)malloc(2 * count * sizeof(size_t));
+    if (!mid) {
+        fprintf(stderr, "[%s] allocation failure.\n", fn);
+        return NULL;
+    }
+    size_t *mid_off = mid + count;
+
+    size_t total_mid = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Tensor *t = ts[i];
+        int ok = t && t->layout == TENSOR_LAYOUT_STRIDED && t->ndim == nd;
+        for (size_t d = 0; ok && d < nd; d++) {
+            ok = (t->shape[d] == t0->shape[d]) || (!stack && d == dim);
+        }
+        if (!ok) {
+            fprintf(stderr, "[%s] tensor %zu does not match the first one.\n", fn, i);
+            free(mid);
+            return NULL;
+        }
+        mid[i] = stack ? 1 : t->shape[dim];
+        mid_off[i] = total_mid;
+        total_mid += mid[i];
+    }
+
+    size_t outer = 1, inner = 1;
+    for (size_t d = 0; d < dim; d++) outer *= t0->shape[d];
+    for (size_t d = dim + (size_t)!stack; d < nd; d++) inner *= t0->shape[d];
+
+    size_t shape[TENSOR_MAX_DIMS];
+    size_t out_nd = 0;
+    for (size_t d = 0; d <= nd; d++) {
+        if (d == dim) {
+            shape[out_nd++] = total_mid;
+            if (!stack) continue;
+        }
+        if (d < nd) shape[out_nd++] = t0->shape[d];
+    }
+
+    Tensor *out = tensor_empty(out_nd, shape, t0->dtype);
+    if (out) {
+        JoinContext c = { ts, count, mid, mid_off, total_mid, inner, out };
+        size_t units = outer * count;
+        if (out->num_elems >= TENSOR_PARALLEL_MIN && units > 1) {
+            size_t per_unit = out->num_elems / units + 1;
+            parallel_for(units, TENSOR_GRAIN / per_unit + 1, join_range, &c);
+        } else {
+            join_range(0, units, &c);
+        }
+    }
+    free(mid);
+    return out;
+}
+
+Tensor* tensor_concat(const Tensor *const *ts, size_t count, size_t dim) {
+    return tensor_join(ts, count, dim, 0, "tensor_concat");
+}
+
+Tensor* tensor_stack(const Tensor *const *ts, size_t count, size_t dim) {
+    return tensor_join(ts, count, dim, 1, "tensor_stack");
 }
 
 /* ------------------------------------------------------------------------- */
 /*                       REDUCTIONS & LINEAR ALGEBRA                         */
 /* ------------------------------------------------------------------------- */
 
-double tensor_sum(const Tensor *t) {
-    if (!t) return 0.0;
+static double sum_range(size_t lo, size_t hi, void *arg) {
+    const Tensor *t = (const Tensor*)arg;
     double s = 0.0;
-    for (size_t i = 0; i < t->num_elems; i++) {
-        s += tensor_read_at_offset(t, i);
+    if ((t->flags & TENSOR_FLAG_C_CONTIGUOUS) && t->dtype == TENSOR_FLOAT64) {
+        return cpu_kernels()->sum_f64((const double*)t->data + lo, hi - lo);
+    }
+    if (t->flags & TENSOR_FLAG_C_CONTIGUOUS) {
+        for (size_t i = lo; i < hi; i++) {
+            s += tensor_read_at_offset(t, i);
+        }
+    } else {
+        for (size_t i = lo; i < hi; i++) {
+            s += tensor_read_at_offset(t, linear_to_offset(t, i));
+        }
     }
     return s;
 }
 
+double tensor_sum(const Tensor *t) {
+    if (!t) return 0.0;
+    if (t->layout == TENSOR_LAYOUT_CSR) {
+        const CSRStorage *csr = tensor_csr(t);
+        double s = 0.0;
+        for (size_t i = 0; i < csr->nnz; i++) {
+            s += csr->values[i];
+        }
+        return s;
+    }
+    if (t->layout == TENSOR_LAYOUT_COMPRESSED) {
+        return tensor_compressed_sum(t);
+    }
+    if (t->num_elems >= TENSOR_PARALLEL_MIN) {
+        return parallel_reduce_sum(t->num_elems, TENSOR_GRAIN, sum_range, (void*)t);
+    }
+    return sum_range(0, t->num_elems, (void*)t);
+}
+
 double tensor_mean(const Tensor *t) {
     if (!t || t->num_elems == 0) return 0.0;
     double s = tensor_sum(t);
     return s / (double)t->num_elems;
 }
 
+static double dot_range(size_t lo, size_t hi, void *arg) {
+    const Tensor *const *pair = (const Tensor *const*)arg;
+    const Tensor *v1 = pair[0], *v2 = pair[1];
+    if (v1->dtype == TENSOR_FLOAT64 && v2->dtype == TENSOR_FLOAT64 &&
+        v1->strides[0] == 1 && v2->strides[0] == 1) {
+        return cpu_kernels()->dot_f64((const double*)v1->data + lo, (const double*)v2->data + lo,
+                                      hi - lo);
+    }
+    double sum = 0.0;
+    for (size_t i = lo; i < hi; i++) {
+        double a = tensor_read_at_offset(v1, i * v1->strides[0]);
+        double b = tensor_read_at_offset(v2, i * v2->strides[0]);
+        sum += (a * b);
+    }
+    return sum;
+}
+
 double tensor_dot(const Tensor *v1, const Tensor *v2) {
     if (!v1 || !v2) {
         fprintf(stderr, "[tensor_dot] NULL input.\n");
         return 0.0;
     }
+    if (require_strided(v1, "tensor_dot") != 0 || require_strided(v2, "tensor_dot") != 0) {
+        return 0.0;
+    }
     if (v1->ndim != 1 || v2->ndim != 1 || v1->shape[0] != v2->shape[0]) {
         fprintf(stderr, "[tensor_dot] both tensors must be 1D of same length.\n");
         return 0.0;
     }
-    double sum = 0.0;
-    for (size_t i = 0; i < v1->shape[0]; i++) {
-        double a = tensor_read_at_offset(v1, i);
-        double b = tensor_read_at_offset(v2, i);
-        sum += (a * b);
+    const Tensor *pair[2] = { v1, v2 };
+    if (v1->shape[0] >= TENSOR_PARALLEL_MIN) {
+        return parallel_reduce_sum(v1->shape[0], TENSOR_GRAIN, dot_range, pair);
     }
-    return sum;
+    return dot_range(0, v1->shape[0], pair);
+}
+
+/**
+ * y = bias + A x over a float64 matrix given by raw strides: element
+ * (i, k) of A is a[i*s0 + k*s1], x[k] is x[k*sx]. Rows [lo, hi) only.
+ */
+typedef struct {
+    const double *a;
+    size_t        K;
+    size_t        s0, s1;
+    const double *x;       // contiguous, length K
+    double        bias;
+    double       *y;
+} GemvContext;
+
+static void gemv_range(size_t lo, size_t hi, void *arg) {
+    const GemvContext *g = (const GemvContext*)arg;
+    if (g->s1 == 1 || g->K == 1) {
+        // Rows contiguous: one dot product per output
+        gemv_f64(hi - lo, g->K, g->a + lo * g->s0, g->s0, g->x, g->bias, g->y + lo);
+    } else if (g->s0 == 1 || hi - lo == 1) {
+        // Columns contiguous (a transposed view): accumulate row by row of A^T
+        for (size_t i = lo; i < hi; i++) g->y[i] = g->bias;
+        gevm_f64(g->K, hi - lo, g->a + lo * g->s0, g->s1, g->x, g->y + lo);
+    } else {
+        for (size_t i = lo; i < hi; i++) {
+            const double *row = g->a + i * g->s0;
+            double s = g->bias;
+            for (size_t k = 0; k < g->K; k++) {
+                s += row[k * g->s1] * g->x[k];
+            }
+            g->y[i] = s;
+        }
+    }
+}
+
+/** Run gemv_range over M outputs, gathering x first if it is strided. */
+static int gemv_strided(const double *a, size_t M, size_t K, size_t s0, size_t s1,
+                        const double *x, size_t sx, double bias, double *y) {
+    double *xbuf = NULL;
+    if (sx != 1 && K > 1) {
+        xbuf = (double*)malloc(K * sizeof(double));
+        if (!xbuf) return -1;
+        for (size_t k = 0; k < K; k++) {
+            xbuf[k] = x[k * sx];
+        }
+        x = xbuf;
+    }
+
+    GemvContext g = { a, K, s0, s1, x, bias, y };
+    if (M * K >= TENSOR_PARALLEL_MIN) {
+        size_t grain = TENSOR_GRAIN / K ? TENSOR_GRAIN / K : 1;
+        parallel_for(M, grain, gemv_range, &g);
+    } else {
+        gemv_range(0, M, &g);
+    }
+    free(xbuf);
+    return 0;
+}
+
+Tensor* tensor_gemv(const Tensor *A, const Tensor *x, double bias) {
+    if (!A || !x) {
+        fprintf(stderr, "[tensor_gemv] NULL input.\n");
+        return NULL;
+    }
+    if (A->layout == TENSOR_LAYOUT_COMPRESSED) {
+        Tensor *c_out = tensor_empty(2, (size_t[]){ A->shape[0], 1 }, TENSOR_FLOAT64);
+        if (c_out && tensor_compressed_gemv(A, x, bias, c_out) != 0) {
+            tensor_free(c_out);
+            return NULL;
+        }
+        return c_out;
+    }
+    if (require_strided(A, "tensor_gemv") != 0 || require_strided(x, "tensor_gemv") != 0) {
+        return NULL;
+    }
+    if (A->dtype != TENSOR_FLOAT64 || x->dtype != TENSOR_FLOAT64) {
+        fprintf(stderr, "[tensor_gemv] only supports float64.\n");
+        return NULL;
+    }
+    if (A->ndim != 2 || x->ndim < 1 || x->ndim > 2 ||
+        x->shape[0] != A->shape[1] || (x->ndim == 2 && x->shape[1] != 1)) {
+        fprintf(stderr, "[tensor_gemv] shape mismatch.\n");
+        return NULL;
+    }
+
+    size_t M = A->shape[0];
+    size_t K = A->shape[1];
+    Tensor *out = tensor_empty(2, (size_t[]){ M, 1 }, TENSOR_FLOAT64);
+    if (!out) return NULL;
+    if (gemv_strided((const double*)A->data, M, K, A->strides[0], A->strides[1],
+                     (const double*)x->data, x->strides[0], bias,
+                     (double*)out->data) != 0) {
+        tensor_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/** Rows [lo, hi) of C = A B through the dispatched GEMM kernel. */
+typedef struct {
+    const double *a;
+    const double *b;
+    double       *c;
+    size_t        N, K, lda, ldb;
+} GemmContext;
+
+static void gemm_range(size_t lo, size_t hi, void *arg) {
+    const GemmContext *g = (const GemmContext*)arg;
+    cpu_kernels()->gemm_f64(hi - lo, g->N, g->K, g->a + lo * g->lda, g->lda,
+                            g->b, g->ldb, g->c + lo * g->N, g->N);
 }
 
 Tensor* tensor_matmul(const Tensor *A, const Tensor *B) {
@@ -527,12 +1588,66 @@ Tensor* tensor_matmul(const Tensor *A, const Tensor *B) {
         fprintf(stderr, "[tensor_matmul] shape mismatch.\n");
         return NULL;
     }
+    if (require_strided(B, "tensor_matmul") != 0) return NULL;
+
+    // Sparse A: SpMM over the nonzeros only
+    if (A->layout == TENSOR_LAYOUT_CSR) {
+        Tensor *sp_out = tensor_empty(2, (size_t[]){ M, N }, TENSOR_FLOAT64);
+        if (sp_out && tensor_spmm(A, B, sp_out) != 0) {
+            tensor_free(sp_out);
+            return NULL;
+        }
+        return sp_out;
+    }
+
+    // Compressed A: decode block by block for GEMV, else expand it
+    if (A->layout == TENSOR_LAYOUT_COMPRESSED) {
+        if (N == 1) {
+            return tensor_gemv(A, B, 0.0);
+        }
+        Tensor *dense = tensor_decompress(A);
+        Tensor *c_out = dense ? tensor_matmul(dense, B) : NULL;
+        tensor_free(dense);
+        return c_out;
+    }
+
+    // Matrix-vector shapes: dedicated GEMV kernels
+    if (A->dtype == TENSOR_FLOAT64 && B->dtype == TENSOR_FLOAT64) {
+        if (N == 1) {
+            return tensor_gemv(A, B, 0.0);
+        }
+        if (M == 1) {
+            // out^T = B^T a^T: B^T is [N, K] with strides swapped
+            Tensor *row = tensor_empty(2, (size_t[]){ 1, N }, TENSOR_FLOAT64);
+            if (row && gemv_strided((const double*)B->data, N, K1, B->strides[1], B->strides[0],
+                                    (const double*)A->data, A->strides[1], 0.0,
+                                    (double*)row->data) != 0) {
+                tensor_free(row);
+                return NULL;
+            }
+            return row;
+        }
+    }
 
     // Create output
     size_t out_shape[2] = { M, N };
-    Tensor *out = tensor_create(2, out_shape, A->dtype);
+    Tensor *out = tensor_empty(2, out_shape, A->dtype);
     if (!out) return NULL;
 
+    // Float64 with unit-stride rows: dispatched GEMM kernel, row-parallel
+    if (A->dtype == TENSOR_FLOAT64 && B->dtype == TENSOR_FLOAT64 &&
+        (A->strides[1] == 1 || K1 == 1) && (B->strides[1] == 1 || N == 1)) {
+        GemmContext g = { (const double*)A->data, (const double*)B->data, (double*)out->data,
+                          N, K1, A->strides[0], B->strides[0] };
+        if (M * N * K1 >= TENSOR_PARALLEL_MIN) {
+            size_t grain = TENSOR_GRAIN / (N * K1) + 1;
+            parallel_for(M, grain, gemm_range, &g);
+        } else {
+            gemm_range(0, M, &g);
+        }
+        return out;
+    }
+
     // Naive triple loop
     for (size_t i = 0; i < M; i++) {
         for (size_t j = 0; j < N; j++) {
@@ -0,0 +1,208 @@
+#include "vmath.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef double  vdouble __attribute__((vector_size(VMATH_WIDTH * sizeof(double))));
+typedef int64_t vint    __attribute__((vector_size(VMATH_WIDTH * sizeof(int64_t))));
+
+#define SIGN_MASK   ((int64_t)0x8000000000000000LL)
+#define LOG2E       1.44269504088896338700e+00
+#define LN2_HI      6.93147180369123816490e-01   // ln2 with 21 trailing zero bits
+#define LN2_LO      1.90821492927058770002e-10   // ln2 - LN2_HI
+#define ROUND_SHIFT 6755399441055744.0           // 1.5 * 2^52: x + c - c rounds to int
+#define ROUND_BITS  ((int64_t)0x4338000000000000LL)  // bit pattern of ROUND_SHIFT
+#define SQRT2       1.41421356237309514547e+00
+
+/* ------------------------------------------------------------------------- */
+/*                           HELPER FUNCTIONS                                */
+/* ------------------------------------------------------------------------- */
+
+static inline vdouble vsplat(double a) {
+    vdouble v = { 0 };
+    return v + a;
+}
+
+/** Lane-wise mask ? a : b, where mask lanes are all-ones or all-zeros. */
+static inline vdouble vselect(vint mask, vdouble a, vdouble b) {
+    return (vdouble)((mask & (vint)a) | (~mask & (vint)b));
+}
+
+/*
+ * Integer lanes to double through the 1.5 * 2^52 shifter: for |k| < 2^51
+ * the low mantissa bits of (k + ROUND_SHIFT) hold k. Unlike
+ * __builtin_convertvector this stays in vector registers without AVX-512.
+ */
+static inline vdouble vto_double(vint k) {
+    return (vdouble)(k + ROUND_BITS) - ROUND_SHIFT;
+}
+
+/** 2^k for integer lanes k in [-1022, 1023]. */
+static inline vdouble vpow2i(vint k) {
+    return (vdouble)((k + 1023) << 52);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                             LANE KERNELS                                  */
+/* ------------------------------------------------------------------------- */
+
+static inline vdouble k_abs(vdouble x) {
+    return (vdouble)((vint)x & ~SIGN_MASK);
+}
+
+static inline vdouble k_neg(vdouble x) {
+    return -x;
+}
+
+static inline vdouble k_square(vdouble x) {
+    return x * x;
+}
+
+/** Hardware square root per lane (correctly rounded). */
+static inline vdouble k_sqrt(vdouble x) {
+    vdouble r = vsplat(0.0);
+    for (int k = 0; k < VMATH_WIDTH; k++) {
+        r[k] = sqrt(x[k]);
+    }
+    return r;
+}
+
+/**
+ * exp(x) = 2^k * e^r with k = round(x / ln2) and |r| <= ln2 / 2.
+ * e^r is a degree-13 Taylor polynomial (truncation < 5e-18 relative).
+ * 2^k is applied in two halves so subnormal and near-overflow results
+ * need no special path.
+ */
+static inline vdouble k_exp(vdouble x) {
+    vint is_num = (vint)(x == x);
+    vdouble xc = vselect(is_num, x, vsplat(0.0));
+    xc = vselect((vint)(xc > 710.0), vsplat(710.0), xc);
+    xc = vselect((vint)(xc < -746.0), vsplat(-746.0), xc);
+
+    vdouble t = xc * LOG2E + ROUND_SHIFT;      // low bits of t hold k
+    vdouble kd = t - ROUND_SHIFT;
+    vdouble r = (xc - kd * LN2_HI) - kd * LN2_LO;
+
+    vdouble p = vsplat(1.0 / 6227020800.0);    // 1/13!
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    vint k = (vint)t - ROUND_BITS;
+    vint k1 = k >> 1;
+    vdouble y = (p * vpow2i(k1)) * vpow2i(k - k1);
+    return vselect(is_num, y, x);
+}
+
+/**
+ * log(x) = e * ln2 + log(m) with x = m * 2^e, m in [sqrt(1/2), sqrt(2)).
+ * log(m) = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.172, as an odd series
+ * through s^19 (truncation < 1e-17 relative).
+ */
+static inline vdouble k_log(vdouble x) {
+    // Rescale subnormals into the normal range first
+    vint sub = (vint)(x < 2.2250738585072014e-308);
+    vdouble xs = vselect(sub, x * 4503599627370496.0, x);    // * 2^52
+    vint bits = (vint)xs;
+
+    vint e = ((bits >> 52) & 0x7ff) - 1023 - (sub & 52);
+    vdouble m = (vdouble)((bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL);
+    vint big = (vint)(m > SQRT2);
+    m = vselect(big, m * 0.5, m);
+    e = e - big;                                // big lanes are -1
+
+    vdouble f = m - 1.0;
+    vdouble s = f / (f + 2.0);
+    vdouble z = s * s;
+    vdouble R = vsplat(1.0 / 19.0);
+    R = R * z + 1.0 / 17.0;
+    R = R * z + 1.0 / 15.0;
+    R = R * z + 1.0 / 13.0;
+    R = R * z + 1.0 / 11.0;
+    R = R * z + 1.0 / 9.0;
+    R = R * z + 1.0 / 7.0;
+    R = R * z + 1.0 / 5.0;
+    R = R * z + 1.0 / 3.0;
+    vdouble logm = (s + s) + (s + s) * (z * R);
+
+    vdouble ed = vto_double(e);
+    vdouble y = ed * LN2_HI + (logm + ed * LN2_LO);
+
+    y = vselect((vint)(x == INFINITY), x, y);
+    y = vselect((vint)(x == 0.0), vsplat(-INFINITY), y);
+    return vselect(~(vint)(x >= 0.0), vsplat(NAN), y);    // x < 0 or NaN
+}
+
+static inline vdouble k_sigmoid(vdouble x) {
+    return 1.0 / (1.0 + k_exp(-x));
+}
+
+/**
+ * tanh(|x|) = 1 - 2 / (e^(2|x|) + 1) for |x| >= 0.2; below that, where the
+ * subtraction would cancel, the Taylor series through x^19.
+ */
+static inline vdouble k_tanh(vdouble x) {
+    vdouble ax = k_abs(x);
+    vdouble big = 1.0 - 2.0 / (k_exp(ax + ax) + 1.0);
+
+    vdouble z = ax * ax;
+    vdouble p = vsplat(443861162.0 / 1856156927625.0);
+    p = p * z - 6404582.0 / 10854718875.0;
+    p = p * z + 929569.0 / 638512875.0;
+    p = p * z - 21844.0 / 6081075.0;
+    p = p * z + 1382.0 / 155925.0;
+    p = p * z - 62.0 / 2835.0;
+    p = p * z + 17.0 / 315.0;
+    p = p * z - 2.0 / 15.0;
+    p = p * z + 1.0 / 3.0;
+    vdouble small = ax - ax * (z * p);
+
+    vdouble t = vselect((vint)(ax < 0.2), small, big);
+    return (vdouble)((vint)t | ((vint)x & SIGN_MASK));
+}
+
+/* ------------------------------------------------------------------------- */
+/*                              ARRAY DRIVERS                                */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Full vectors straight from memory; the tail goes through a padded vector
+ * so every element sees the same kernel. 'pad' is a harmless input (e.g. 1
+ * for log) for the unused lanes.
+ */
+#define VMATH_MAP(name, kernel, pad)                                 \
+    void name(const double *x, double *y, size_t n) {                \
+        size_t i = 0;                                                \
+        for (; i + VMATH_WIDTH <= n; i += VMATH_WIDTH) {             \
+            vdouble v;                                               \
+            memcpy(&v, x + i, sizeof(v));                            \
+            v = kernel(v);                                           \
+            memcpy(y + i, &v, sizeof(v));                            \
+        }                                                            \
+        if (i < n) {                                                 \
+            vdouble v = vsplat(pad);                                 \
+            memcpy(&v, x + i, (n - i) * sizeof(double));             \
+            v = kernel(v);                                           \
+            memcpy(y + i, &v, (n - i) * sizeof(double));             \
+        }                                                            \
+    }
+
+VMATH_MAP(vmath_abs, k_abs, 0.0)
+VMATH_MAP(vmath_neg, k_neg, 0.0)
+VMATH_MAP(vmath_square, k_square, 0.0)
+VMATH_MAP(vmath_sqrt, k_sqrt, 1.0)
+VMATH_MAP(vmath_exp, k_exp, 0.0)
+VMATH_MAP(vmath_log, k_log, 1.0)
+VMATH_MAP(vmath_sigmoid, k_sigmoid, 0.0)
+VMATH_MAP(vmath_tanh, k_tanh, 0.0)
@@ -12,6 +12,71 @@ extern "C" {
  */
 int test_linear_regression(void);
 
+/**
+ * @brief Fits synthetic data with every optimizer type and checks that
+ *        early stopping triggers well before the epoch limit
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_optimizers(void);
+
+/**
+ * @brief Streams rows into the recursive-least-squares regressor, checks
+ *        the fit, forgetting and a save/load round trip
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_online_rls(void);
+
+/**
+ * @brief Fits rolling windows over a series with a regime change and
+ *        checks the per-window coefficients
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_rolling_regression(void);
+
+/**
+ * @brief Trains a batch of models with different targets, learning rates
+ *        and L2 penalties and checks them against single-model training
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_batched_training(void);
+
+/**
+ * @brief Interrupts an Adam run with background checkpoints, resumes it and
+ *        checks it matches an uninterrupted run; reports the per-checkpoint
+ *        stall on the training thread
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_checkpoint_resume(void);
+
+/**
+ * @brief Checks k-fold and forward-chaining CV over zero-copy fold views
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_cross_validation(void);
+
+/**
+ * @brief Streams a dataset file and a callback source through the
+ *        prefetching loader; checks full-batch streaming matches in-memory
+ *        training exactly, mini-batch converges and source errors surface
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_streaming_loader(void);
+
+/**
+ * @brief Fits lasso, ridge and elastic-net paths from one Gram matrix and
+ *        checks the optimality conditions against the raw rows
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_elastic_net(void);
+
 #ifdef __cplusplus
 }
 #endif
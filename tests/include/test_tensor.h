@@ -0,0 +1,90 @@
+#ifndef TEST_TENSOR_H
+#define TEST_TENSOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Checks view semantics: contiguity flags, reshape/expand/squeeze views
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_tensor_views(void);
+
+/**
+ * @brief Checks CSR tensors against dense: construction, matmul, forward, training
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_sparse_csr(void);
+
+/**
+ * @brief Checks unary ops against libm (error bounds, specials, dtypes, strides)
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_unary_ops(void);
+
+/**
+ * @brief Checks allocation policies: alignment, zeroing, huge pages, first touch
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_tensor_alloc(void);
+
+/**
+ * @brief Checks the parallel runtime: coverage, deterministic reductions, nesting
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_parallel_runtime(void);
+
+/**
+ * @brief Check the GEMV/GEVM kernels behind tensor_gemv, tensor_matmul
+ *        and linear_forward against element-wise references (every
+ *        unrolled width, transposed and strided operands).
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_gemv_kernels(void);
+
+/**
+ * @brief Check XOR-compressed columnar storage: exact roundtrip, ratio on
+ *        price-like series, and sum/GEMV/matmul/training on compressed X
+ *        against the dense results.
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_compressed_storage(void);
+
+/**
+ * @brief Check CPU kernel dispatch: the ML_CPU_LEVEL override, the query
+ *        API, and bit-identical results from every supported level.
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_cpu_dispatch(void);
+
+/**
+ * @brief Check the Philox generator and random fills: known answer,
+ *        reproducibility across thread counts and split fills, moments,
+ *        strided fills and permutations.
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_random_tensors(void);
+
+/**
+ * @brief Check row gather (copy and zero-copy range), scatter-add with
+ *        repeated indices, and concat/stack against element-wise access.
+ *
+ * @return 0 on success, non-zero on error
+ */
+int test_gather_scatter(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEST_TENSOR_H */
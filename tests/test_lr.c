@@ -2,11 +2,19 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <time.h>
 
 #include "test_lr.h"
 #include "dataframe.h"   // your DataFrame library
 #include "tensor.h"      // your Tensor module
 #include "lr.h"          // linear regression functions
+#include "scaler.h"      // feature standardization
+#include "online.h"      // recursive least squares
+#include "rolling.h"     // rolling-window regression
+#include "cv.h"          // cross-validation
+#include "enet.h"        // elastic-net paths
 
 int test_linear_regression(void)
 {
@@ -48,7 +56,10 @@ int test_linear_regression(void)
         return 1;
     }
 
-    // 4) Fill X, y from columns open(1), close(2)
+    // 4) Fill X, y from columns open(1), close(2), collecting z-score
+    //    statistics in the same pass
+    Scaler *xs = scaler_create(SCALER_ZSCORE, 1);
+    Scaler *ys = scaler_create(SCALER_ZSCORE, 1);
     size_t openColIndex  = 1;
     size_t closeColIndex = 2;
     for (size_t i = 0; i < n; i++) {
@@ -72,6 +83,8 @@ int test_linear_regression(void)
         size_t idx[2] = { i, 0 };
         tensor_set(X, idx, openVal);
         tensor_set(y, idx, closeVal);
+        scaler_observe_row(xs, &openVal);
+        scaler_observe_row(ys, &closeVal);
 
         // if your DataFrame wants you to free rowBuf, do so
         // but only if the library explicitly instructs it
@@ -84,11 +97,26 @@ int test_linear_regression(void)
     Tensor *W = tensor_create(2, shapeW, TENSOR_FLOAT64);
     Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
 
-    // 6) Train
-    double lr = 1e-5;  // small LR to avoid inf/nan
-    int epochs = 2000;
-    printf("Training linear regressor with %d epochs, LR=%.4f...\n", epochs, lr);
-    train_linear_regression(X, y, W, b, lr, epochs, /*verbose=*/1);
+    // 6) Train on standardized data, then map W,b back to price units
+    scaler_finalize(xs, NULL);
+    scaler_finalize(ys, NULL);
+    scaler_transform(xs, X);
+    scaler_transform(ys, y);
+
+    TrainConfig cfg = train_default_config();
+    cfg.optim.lr = 0.5;
+    cfg.max_epochs = 200;
+    cfg.loss_tol = 1e-10;
+    cfg.verbose = 1;
+    printf("Training linear regressor (max %d epochs, LR=%.4f)...\n",
+           cfg.max_epochs, cfg.optim.lr);
+    TrainResult res;
+    train_linear_regression_ex(X, y, W, b, &cfg, &res);
+    printf("Stopped after %d epochs (converged=%d).\n", res.epochs_run, res.converged);
+
+    scaler_unscale_params(xs, ys, W, b);
+    scaler_inverse_transform(xs, X);
+    scaler_inverse_transform(ys, y);
 
     // 7) Print final W,b
     double W_val = tensor_get(W, (size_t[]){0,0});
@@ -108,7 +136,913 @@ int test_linear_regression(void)
     tensor_free(y);
     tensor_free(W);
     tensor_free(b);
+    scaler_free(xs);
+    scaler_free(ys);
     DataFrame_Destroy(&df);
 
+    if (!res.converged) {
+        fprintf(stderr, "Training did not converge.\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Fill X [n,d] with deterministic values in [-1, 1] and y = X*w_true + b_true.
+ */
+static void make_synthetic(Tensor *X, Tensor *y, const double *w_true, double b_true)
+{
+    size_t n = X->shape[0];
+    size_t d = X->shape[1];
+    unsigned int state = 12345u;
+    for (size_t i = 0; i < n; i++) {
+        double target = b_true;
+        for (size_t j = 0; j < d; j++) {
+            state = state * 1103515245u + 12345u;
+            double v = (double)((state >> 8) & 0xffff) / 32767.5 - 1.0;
+            tensor_set(X, (size_t[]){i, j}, v);
+            target += w_true[j] * v;
+        }
+        tensor_set(y, (size_t[]){i, 0}, target);
+    }
+}
+
+/** Loss callback with no descent anywhere: NaN at odd calls, larger loss otherwise. */
+static double no_descent_loss(void *ctx)
+{
+    int *calls = (int*)ctx;
+    return ((*calls)++ % 2) ? NAN : 100.0;
+}
+
+int test_optimizers(void)
+{
+    const size_t n = 500, d = 3;
+    const double w_true[3] = { 3.0, -2.0, 0.5 };
+    const double b_true = 1.5;
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, b_true);
+
+    const OptimizerType types[] = {
+        OPTIM_SGD, OPTIM_MOMENTUM, OPTIM_NESTEROV, OPTIM_ADAM, OPTIM_LINE_SEARCH
+    };
+    const char *names[] = { "sgd", "momentum", "nesterov", "adam", "line_search" };
+    const double lrs[] = { 0.5, 0.1, 0.1, 0.1, 1.0 };
+
+    int failures = 0;
+    for (size_t k = 0; k < sizeof(types) / sizeof(types[0]); k++) {
+        Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+        Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+
+        TrainConfig cfg = train_default_config();
+        cfg.optim = optimizer_default_config(types[k]);
+        cfg.optim.lr = lrs[k];
+        cfg.max_epochs = 5000;
+        cfg.grad_tol = 1e-6;
+
+        TrainResult res;
+        int rc = train_linear_regression_ex(X, y, W, b, &cfg, &res);
+
+        double err = fabs(tensor_read_at_offset(b, 0) - b_true);
+        for (size_t j = 0; j < d; j++) {
+            err = fmax(err, fabs(tensor_read_at_offset(W, j) - w_true[j]));
+        }
+        printf("  %-12s epochs=%4d loss=%.3e max|err|=%.3e\n",
+               names[k], res.epochs_run, res.final_loss, err);
+        if (rc != 0 || !res.converged || res.epochs_run >= cfg.max_epochs || err > 1e-4) {
+            fprintf(stderr, "Optimizer %s did not converge.\n", names[k]);
+            failures++;
+        }
+
+        tensor_free(W);
+        tensor_free(b);
+    }
+
+    // Line search without an Armijo step leaves the parameters where they were
+    Tensor *p = tensor_create(1, (size_t[]){2}, TENSOR_FLOAT64);
+    Tensor *gp = tensor_create(1, (size_t[]){2}, TENSOR_FLOAT64);
+    tensor_write_at_offset(p, 0, 1.0);
+    tensor_write_at_offset(p, 1, -2.0);
+    tensor_write_at_offset(gp, 0, 0.5);
+    tensor_write_at_offset(gp, 1, 0.25);
+    OptimizerConfig lc = optimizer_default_config(OPTIM_LINE_SEARCH);
+    lc.ls_max_iter = 5;
+    Optimizer *opt = optimizer_create(&lc, &p, 1);
+    int calls = 0;
+    int rc = opt ? optimizer_step(opt, &gp, 1.0, no_descent_loss, &calls) : -1;
+    if (rc != 1 || calls != 5 || tensor_read_at_offset(p, 0) != 1.0 ||
+        tensor_read_at_offset(p, 1) != -2.0) {
+        fprintf(stderr, "Failed line search did not restore the parameters (rc=%d).\n", rc);
+        failures++;
+    }
+    optimizer_free(opt);
+    tensor_free(gp);
+    tensor_free(p);
+
+    tensor_free(X);
+    tensor_free(y);
+    return failures;
+}
+
+int test_online_rls(void)
+{
+    const size_t n = 400, d = 3;
+    const double w_true[3] = { 3.0, -2.0, 0.5 };
+    const double b_true = 1.5;
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, b_true);
+
+    int failures = 0;
+
+    // 1) Row-by-row and micro-batch updates recover the exact solution
+    OnlineRLS *m = rls_create(d, 1.0, 1e6);
+    double row[3];
+    for (size_t i = 0; i < n / 2; i++) {
+        for (size_t j = 0; j < d; j++) row[j] = tensor_get(X, (size_t[]){i, j});
+        rls_update(m, row, tensor_get(y, (size_t[]){i, 0}));
+    }
+    Tensor *Xb = tensor_slice(X, (size_t[]){n / 2, 0}, (size_t[]){n, d});
+    Tensor *yb = tensor_slice(y, (size_t[]){n / 2, 0}, (size_t[]){n, 1});
+    rls_update_batch(m, Xb, yb);
+
+    Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    rls_get_params(m, W, b);
+
+    // Non-contiguous output columns are rejected, not written at flat offsets
+    Tensor *W2 = tensor_create(2, (size_t[]){d, 2}, TENSOR_FLOAT64);
+    Tensor *col = tensor_slice(W2, (size_t[]){0, 1}, (size_t[]){d, 2});
+    Scaler *xs = scaler_create(SCALER_ZSCORE, d);
+    if (rls_get_params(m, col, b) != -1 || scaler_fit(xs, X) != 0 ||
+        scaler_unscale_params(xs, NULL, col, b) != -1) {
+        fprintf(stderr, "Non-contiguous W was accepted.\n");
+        failures++;
+    }
+    scaler_free(xs);
+    tensor_free(col);
+    tensor_free(W2);
+    double err = fabs(tensor_read_at_offset(b, 0) - b_true);
+    for (size_t j = 0; j < d; j++) {
+        err = fmax(err, fabs(tensor_read_at_offset(W, j) - w_true[j]));
+    }
+    printf("  rls rows=%zu max|err|=%.3e\n", m->count, err);
+    if (m->count != n || err > 1e-5) {
+        fprintf(stderr, "RLS did not recover coefficients.\n");
+        failures++;
+    }
+
+    // 2) Save/load round trip preserves predictions
+    const char *path = "rls_state.bin";
+    OnlineRLS *loaded = NULL;
+    if (rls_save(m, path) == 0) {
+        loaded = rls_load(path);
+    }
+    remove(path);
+    if (!loaded || loaded->count != m->count || rls_predict(loaded, row) != rls_predict(m, row)) {
+        fprintf(stderr, "RLS save/load mismatch.\n");
+        failures++;
+    }
+
+    // Corrupt headers (d = 0, d near 2^64, truncated payload) are rejected
+    const uint64_t bad_d[3] = { 0, UINT64_MAX - 1, (uint64_t)d };
+    for (int k = 0; k < 3; k++) {
+        FILE *bf = fopen(path, "wb");
+        if (!bf) break;
+        uint64_t zero = 0;
+        double lam = 1.0, pad[4] = { 0.0 };
+        fwrite("RLS1", 1, 4, bf);
+        fwrite(&bad_d[k], sizeof(uint64_t), 1, bf);
+        fwrite(&lam, sizeof(double), 1, bf);
+        fwrite(&zero, sizeof(uint64_t), 1, bf);
+        fwrite(pad, sizeof(double), 4, bf);
+        fclose(bf);
+        OnlineRLS *bad = rls_load(path);
+        remove(path);
+        if (bad) {
+            fprintf(stderr, "RLS loaded a corrupt state file (case %d).\n", k);
+            rls_free(bad);
+            failures++;
+        }
+    }
+
+    // 3) With forgetting, the model tracks a regime change
+    OnlineRLS *f = rls_create(d, 0.95, 1e6);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < d; j++) row[j] = tensor_get(X, (size_t[]){i, j});
+        double target = tensor_get(y, (size_t[]){i, 0});
+        if (i >= n / 2) target += 4.0 * row[0];  // slope on x0 jumps 3 -> 7
+        rls_update(f, row, target);
+    }
+    double w0 = tensor_read_at_offset(f->theta, 0);
+    printf("  rls forgetting w0=%.4f (expected 7)\n", w0);
+    if (fabs(w0 - 7.0) > 1e-3) {
+        fprintf(stderr, "RLS with forgetting did not adapt.\n");
+        failures++;
+    }
+
+    rls_free(m);
+    rls_free(loaded);
+    rls_free(f);
+    tensor_free(Xb);
+    tensor_free(yb);
+    tensor_free(W);
+    tensor_free(b);
+    tensor_free(X);
+    tensor_free(y);
+    return failures;
+}
+
+int test_rolling_regression(void)
+{
+    const size_t n = 1000, d = 2, window = 100;
+    const double w_true[2] = { 3.0, -2.0 };
+    const double b_true = 1.5;
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, b_true);
+
+    // Second half: intercept shifts by +10
+    for (size_t i = n / 2; i < n; i++) {
+        double v = tensor_get(y, (size_t[]){i, 0});
+        tensor_set(y, (size_t[]){i, 0}, v + 10.0);
+    }
+
+    RollingConfig cfg = rolling_default_config(window);
+    Tensor *coefs = rolling_regression(X, y, &cfg);
+    if (!coefs || coefs->shape[0] != n - window + 1 || coefs->shape[1] != d + 1) {
+        fprintf(stderr, "rolling_regression returned wrong shape.\n");
+        tensor_free(coefs);
+        tensor_free(X);
+        tensor_free(y);
+        return 1;
+    }
+
+    // Windows entirely before / after the change must be exact
+    double err = 0.0;
+    for (size_t t = 0; t < coefs->shape[0]; t++) {
+        size_t last = t + window - 1;
+        if (t < n / 2 && last >= n / 2) continue;  // straddles the change
+        double b_expect = (t >= n / 2) ? b_true + 10.0 : b_true;
+        err = fmax(err, fabs(tensor_get(coefs, (size_t[]){t, 0}) - w_true[0]));
+        err = fmax(err, fabs(tensor_get(coefs, (size_t[]){t, 1}) - w_true[1]));
+        err = fmax(err, fabs(tensor_get(coefs, (size_t[]){t, 2}) - b_expect));
+    }
+    printf("  rolling windows=%zu max|err|=%.3e\n", coefs->shape[0], err);
+
+    tensor_free(coefs);
+    tensor_free(X);
+    tensor_free(y);
+    if (err > 1e-8) {
+        fprintf(stderr, "Rolling coefficients are wrong.\n");
+        return 1;
+    }
     return 0;
 }
+
+int test_batched_training(void)
+{
+    const size_t n = 300, d = 3, K = 4;
+    const double w_true[3] = { 3.0, -2.0, 0.5 };
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, 1.5);
+
+    // Targets: models 0,1,3 fit y; model 2 fits 2*y
+    Tensor *Y = tensor_create(2, (size_t[]){n, K}, TENSOR_FLOAT64);
+    for (size_t i = 0; i < n; i++) {
+        double v = tensor_get(y, (size_t[]){i, 0});
+        for (size_t k = 0; k < K; k++) {
+            tensor_set(Y, (size_t[]){i, k}, (k == 2) ? 2.0 * v : v);
+        }
+    }
+
+    const double lrs[4] = { 0.5, 0.1, 0.5, 0.5 };
+    const double l2s[4] = { 0.0, 0.0, 0.0, 0.1 };
+    BatchTrainConfig bcfg = { lrs, l2s, 3000, 0.0, 1e-7, 0 };
+
+    Tensor *W = tensor_create(2, (size_t[]){d, K}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(2, (size_t[]){1, K}, TENSOR_FLOAT64);
+    Tensor *hist = tensor_create(2, (size_t[]){(size_t)bcfg.max_epochs, K}, TENSOR_FLOAT64);
+    TrainResult res[4];
+    int failures = 0;
+    if (train_linear_regression_batched(X, Y, W, b, &bcfg, res, hist) != 0) {
+        failures++;
+    }
+
+    // Unregularized models must match independent single-model runs
+    for (size_t k = 0; k < K && failures == 0; k++) {
+        if (l2s[k] != 0.0) continue;
+        Tensor *yk = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+        for (size_t i = 0; i < n; i++) {
+            tensor_set(yk, (size_t[]){i, 0}, tensor_get(Y, (size_t[]){i, k}));
+        }
+        Tensor *Wk = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+        Tensor *bk = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+        TrainConfig cfg = train_default_config();
+        cfg.optim.lr = lrs[k];
+        cfg.max_epochs = bcfg.max_epochs;
+        cfg.grad_tol = bcfg.grad_tol;
+        TrainResult single;
+        train_linear_regression_ex(X, yk, Wk, bk, &cfg, &single);
+
+        double diff = fabs(tensor_read_at_offset(bk, 0) - tensor_read_at_offset(b, k));
+        for (size_t j = 0; j < d; j++) {
+            diff = fmax(diff, fabs(tensor_get(Wk, (size_t[]){j, 0}) - tensor_get(W, (size_t[]){j, k})));
+        }
+        printf("  batched model %zu epochs=%d (single %d) max|diff|=%.3e\n",
+               k, res[k].epochs_run, single.epochs_run, diff);
+        if (diff > 1e-10 || res[k].epochs_run != single.epochs_run || !res[k].converged) {
+            fprintf(stderr, "Batched model %zu disagrees with single-model training.\n", k);
+            failures++;
+        }
+        tensor_free(yk);
+        tensor_free(Wk);
+        tensor_free(bk);
+    }
+
+    // Strided X (generic row copy) and a transposed loss_history view give
+    // the same fit and history as the contiguous run
+    Tensor *XT = tensor_create(2, (size_t[]){d, n}, TENSOR_FLOAT64);
+    Tensor *histT = tensor_create(2, (size_t[]){K, (size_t)bcfg.max_epochs}, TENSOR_FLOAT64);
+    Tensor *W2 = tensor_create(2, (size_t[]){d, K}, TENSOR_FLOAT64);
+    Tensor *b2 = tensor_create(2, (size_t[]){1, K}, TENSOR_FLOAT64);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < d; j++) {
+            tensor_set(XT, (size_t[]){j, i}, tensor_get(X, (size_t[]){i, j}));
+        }
+    }
+    Tensor *Xv = tensor_transpose(XT);
+    Tensor *hv = tensor_transpose(histT);
+    if (train_linear_regression_batched(Xv, Y, W2, b2, &bcfg, NULL, hv) != 0) {
+        failures++;
+    } else {
+        double diff = 0.0;
+        for (size_t j = 0; j < d; j++) {
+            for (size_t k = 0; k < K; k++) {
+                diff = fmax(diff, fabs(tensor_get(W2, (size_t[]){j, k}) - tensor_get(W, (size_t[]){j, k})));
+            }
+        }
+        for (size_t k = 0; k < K; k++) {
+            for (size_t e = 0; e <= (size_t)res[k].epochs_run && e < (size_t)bcfg.max_epochs; e++) {
+                double h = tensor_get(hist, (size_t[]){e, k});
+                double h2 = tensor_get(hv, (size_t[]){e, k});
+                if (!(h == h2 || (isnan(h) && isnan(h2)))) diff = INFINITY;
+            }
+        }
+        if (diff > 1e-12) {
+            fprintf(stderr, "Batched training on strided views disagrees (%.3e).\n", diff);
+            failures++;
+        }
+    }
+    tensor_free(hv);
+    tensor_free(Xv);
+    tensor_free(b2);
+    tensor_free(W2);
+    tensor_free(histT);
+    tensor_free(XT);
+
+    // L2 shrinks the weights of model 3 relative to model 0
+    double n0 = 0.0, n3 = 0.0;
+    for (size_t j = 0; j < d; j++) {
+        n0 += pow(tensor_get(W, (size_t[]){j, 0}), 2);
+        n3 += pow(tensor_get(W, (size_t[]){j, 3}), 2);
+    }
+    if (!(n3 < n0) || !res[3].converged) {
+        fprintf(stderr, "L2 model did not shrink weights.\n");
+        failures++;
+    }
+
+    // History is NaN after a model stops
+    size_t after = (size_t)res[1].epochs_run + 1;
+    if (after < (size_t)bcfg.max_epochs && !isnan(tensor_get(hist, (size_t[]){after, 1}))) {
+        fprintf(stderr, "Loss history not NaN-filled after stop.\n");
+        failures++;
+    }
+
+    tensor_free(X);
+    tensor_free(y);
+    tensor_free(Y);
+    tensor_free(W);
+    tensor_free(b);
+    tensor_free(hist);
+    return failures;
+}
+
+int test_checkpoint_resume(void)
+{
+    const size_t n = 2000, d = 3;
+    const double w_true[3] = { 3.0, -2.0, 0.5 };
+    const char *path = "train_ckpt.bin";
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, 1.5);
+
+    TrainConfig cfg = train_default_config();
+    cfg.optim = optimizer_default_config(OPTIM_ADAM);
+    cfg.optim.lr = 0.05;
+    cfg.max_epochs = 200;
+
+    // 1) Reference: uninterrupted run
+    Tensor *W_ref = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b_ref = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    train_linear_regression_ex(X, y, W_ref, b_ref, &cfg, NULL);
+
+    // 2) "Crash" after 120 epochs, checkpointing every epoch
+    remove(path);
+    Checkpointer *ck = checkpoint_create(path);
+    Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    TrainConfig first = cfg;
+    first.max_epochs = 120;
+    first.checkpoint = ck;
+    first.checkpoint_every = 1;
+    train_linear_regression_ex(X, y, W, b, &first, NULL);
+    checkpoint_flush(ck);
+
+    CheckpointStats st;
+    checkpoint_get_stats(ck, &st);
+    checkpoint_free(ck);
+    printf("  checkpoints submitted=%ld written=%ld superseded=%ld "
+           "stall mean=%.2f us max=%.2f us\n",
+           st.submitted, st.written, st.superseded,
+           st.stall_total_ns / 1e3 / (double)(st.submitted ? st.submitted : 1),
+           st.stall_max_ns / 1e3);
+
+    // 3) Resume into fresh tensors and finish the run
+    tensor_free(W);
+    tensor_free(b);
+    W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    TrainConfig second = cfg;
+    second.resume_path = path;
+    TrainResult res;
+    train_linear_regression_ex(X, y, W, b, &second, &res);
+    remove(path);
+
+    double diff = fabs(tensor_read_at_offset(b, 0) - tensor_read_at_offset(b_ref, 0));
+    for (size_t j = 0; j < d; j++) {
+        diff = fmax(diff, fabs(tensor_read_at_offset(W, j) - tensor_read_at_offset(W_ref, j)));
+    }
+    printf("  resumed epochs=%d max|diff| vs uninterrupted=%.3e\n", res.epochs_run, diff);
+
+    int failures = 0;
+    if (st.submitted != 121 || st.written < 1 || diff != 0.0 || res.epochs_run != cfg.max_epochs) {
+        fprintf(stderr, "Checkpoint/resume mismatch.\n");
+        failures++;
+    }
+
+    // 4) A snapshot with bytes appended after the last payload is rejected
+    Tensor *pair[2] = { W, b };
+    long ep = -1;
+    ck = checkpoint_create(path);
+    checkpoint_submit(ck, 7, pair, 2);
+    checkpoint_flush(ck);
+    checkpoint_free(ck);
+    int clean = checkpoint_load(path, &ep, pair, 2) == 0 && ep == 7;
+    FILE *tf = fopen(path, "ab");
+    if (tf) {
+        fputc(0, tf);
+        fclose(tf);
+    }
+    if (!clean || checkpoint_load(path, &ep, pair, 2) != -1) {
+        fprintf(stderr, "Checkpoint with trailing bytes was not rejected.\n");
+        failures++;
+    }
+    remove(path);
+
+    tensor_free(X);
+    tensor_free(y);
+    tensor_free(W_ref);
+    tensor_free(b_ref);
+    tensor_free(W);
+    tensor_free(b);
+    return failures;
+}
+
+int test_cross_validation(void)
+{
+    const size_t n = 1200, d = 3, k = 4;
+    const double w_true[3] = { 3.0, -2.0, 0.5 };
+    const double b_true = 1.5;
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, b_true);
+
+    CVConfig cfg = cv_default_config(CV_KFOLD, k);
+    cfg.train.optim.lr = 0.5;
+    cfg.train.max_epochs = 3000;
+    cfg.train.grad_tol = 1e-9;
+
+    // 1) K-fold: every fold recovers the generating model
+    CVFoldResult res[4];
+    Tensor *coefs = tensor_create(2, (size_t[]){k, d + 1}, TENSOR_FLOAT64);
+    if (cross_validate(X, y, &cfg, res, coefs) != 0) {
+        fprintf(stderr, "cross_validate failed.\n");
+        return 1;
+    }
+    for (size_t f = 0; f < k; f++) {
+        if (res[f].test_rows != n / k || res[f].train_rows != n - n / k ||
+            res[f].test_start != f * n / k || !res[f].converged || res[f].test_mse > 1e-12 ||
+            fabs(tensor_get(coefs, (size_t[]){f, d}) - b_true) > 1e-5) {
+            fprintf(stderr, "k-fold result %zu wrong (mse %.3e).\n", f, res[f].test_mse);
+            return 1;
+        }
+    }
+
+    // 2) Fold 1 trains on two views; a copied train set must give the same model
+    size_t t0 = n / k, t1 = 2 * n / k;
+    Tensor *Xc = tensor_create(2, (size_t[]){n - (t1 - t0), d}, TENSOR_FLOAT64);
+    Tensor *yc = tensor_create(2, (size_t[]){n - (t1 - t0), 1}, TENSOR_FLOAT64);
+    for (size_t i = 0, r = 0; i < n; i++) {
+        if (i >= t0 && i < t1) continue;
+        for (size_t j = 0; j < d; j++) {
+            tensor_set(Xc, (size_t[]){r, j}, tensor_get(X, (size_t[]){i, j}));
+        }
+        tensor_set(yc, (size_t[]){r, 0}, tensor_get(y, (size_t[]){i, 0}));
+        r++;
+    }
+    Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    train_linear_regression_ex(Xc, yc, W, b, &cfg.train, NULL);
+    for (size_t j = 0; j < d; j++) {
+        if (tensor_get(W, (size_t[]){j, 0}) != tensor_get(coefs, (size_t[]){1, j})) {
+            fprintf(stderr, "fold views disagree with copied split.\n");
+            return 1;
+        }
+    }
+
+    // 3) Forward chaining: growing train prefix, next block as test
+    cfg.scheme = CV_FORWARD_CHAINING;
+    for (size_t f = 0; f < k; f++) res[f].test_rows = 0;
+    if (cross_validate(X, y, &cfg, res, NULL) != 0) {
+        fprintf(stderr, "forward chaining failed.\n");
+        return 1;
+    }
+    size_t block = n / (k + 1);
+    for (size_t f = 0; f < k; f++) {
+        if (res[f].train_rows != (f + 1) * block || res[f].test_start != (f + 1) * block ||
+            res[f].test_rows != block || res[f].test_mse > 1e-12) {
+            fprintf(stderr, "forward chaining fold %zu wrong.\n", f);
+            return 1;
+        }
+    }
+
+    // 4) Serial vs pooled wall time
+    cfg.scheme = CV_KFOLD;
+    cfg.train.grad_tol = 0.0;
+    cfg.train.max_epochs = 400;
+    double fold_sum = 0.0;
+    cfg.num_threads = 1;
+    clock_t c0 = clock();
+    cross_validate(X, y, &cfg, res, NULL);
+    for (size_t f = 0; f < k; f++) fold_sum += res[f].seconds;
+    cfg.num_threads = 0;
+    cross_validate(X, y, &cfg, res, NULL);
+    double slowest = 0.0;
+    for (size_t f = 0; f < k; f++) slowest = fmax(slowest, res[f].seconds);
+    printf("Cross-validation: %zu folds, serial %.3f s, slowest fold %.3f s (cpu %.3f s)\n",
+           k, fold_sum, slowest, (double)(clock() - c0) / CLOCKS_PER_SEC);
+
+    tensor_free(W);
+    tensor_free(b);
+    tensor_free(Xc);
+    tensor_free(yc);
+    tensor_free(coefs);
+    tensor_free(X);
+    tensor_free(y);
+    return 0;
+}
+
+/** In-memory LoaderSource over X/y; fails once asked for row 'fail_at'. */
+typedef struct {
+    const Tensor *X;
+    const Tensor *y;
+    size_t        fail_at;
+} MemSource;
+
+static int mem_fill(void *ctx, size_t row0, size_t max_rows, double *X, double *y, size_t *rows)
+{
+    MemSource *ms = (MemSource*)ctx;
+    if (row0 >= ms->fail_at) return -1;
+    size_t n = ms->X->shape[0], d = ms->X->shape[1];
+    size_t k = (row0 + max_rows < n) ? max_rows : n - row0;
+    for (size_t i = 0; i < k; i++) {
+        for (size_t j = 0; j < d; j++) {
+            X[i * d + j] = tensor_get(ms->X, (size_t[]){row0 + i, j});
+        }
+        y[i] = tensor_get(ms->y, (size_t[]){row0 + i, 0});
+    }
+    *rows = k;
+    return 0;
+}
+
+int test_streaming_loader(void)
+{
+    const size_t n = 5000, d = 3;
+    const double w_true[3] = { 3.0, -2.0, 0.5 };
+    const char *path = "stream_ds.bin";
+    int failures = 0;
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, 1.5);
+
+    // 1) Dataset file written in two appends
+    Tensor *Xa = tensor_slice(X, (size_t[]){0, 0}, (size_t[]){3000, d});
+    Tensor *ya = tensor_slice(y, (size_t[]){0, 0}, (size_t[]){3000, 1});
+    Tensor *Xb = tensor_slice(X, (size_t[]){3000, 0}, (size_t[]){n, d});
+    Tensor *yb = tensor_slice(y, (size_t[]){3000, 0}, (size_t[]){n, 1});
+    if (loader_write_file(path, Xa, ya, TENSOR_FLOAT64, 0) != 0 ||
+        loader_write_file(path, Xb, yb, TENSOR_FLOAT64, 1) != 0 ||
+        loader_write_file(path, Xb, yb, TENSOR_FLOAT32, 1) == 0) {
+        fprintf(stderr, "Dataset write/append failed.\n");
+        failures++;
+    }
+
+    // 2) Two passes read back every row, in order
+    DataLoader *L = loader_open_file(path, 512, 3);
+    if (!L || loader_num_features(L) != d) {
+        fprintf(stderr, "loader_open_file failed.\n");
+        return 1;
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        const Tensor *Xc, *yc;
+        size_t row = 0;
+        int rc;
+        while ((rc = loader_next(L, &Xc, &yc)) == 1) {
+            for (size_t i = 0; i < Xc->shape[0]; i++, row++) {
+                int same = tensor_get(Xc, (size_t[]){i, 0}) == tensor_get(X, (size_t[]){row, 0}) &&
+                           tensor_get(Xc, (size_t[]){i, d - 1}) == tensor_get(X, (size_t[]){row, d - 1}) &&
+                           tensor_get(yc, (size_t[]){i, 0}) == tensor_get(y, (size_t[]){row, 0});
+                if (!same) {
+                    fprintf(stderr, "Loader row %zu differs.\n", row);
+                    failures++;
+                    break;
+                }
+            }
+        }
+        if (rc != 0 || row != n) {
+            fprintf(stderr, "Loader pass %d: rc=%d rows=%zu.\n", pass, rc, row);
+            failures++;
+        }
+    }
+
+    // 3) Full-batch streaming reproduces in-memory training exactly
+    TrainConfig cfg = train_default_config();
+    cfg.optim = optimizer_default_config(OPTIM_ADAM);
+    cfg.optim.lr = 0.05;
+    cfg.max_epochs = 100;
+    Tensor *W_ref = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b_ref = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    TrainResult ref, res;
+    train_linear_regression_ex(X, y, W_ref, b_ref, &cfg, &ref);
+    int rc = train_linear_regression_stream(L, TRAIN_FULL_BATCH, W, b, &cfg, &res);
+    double diff = fabs(tensor_read_at_offset(b, 0) - tensor_read_at_offset(b_ref, 0));
+    for (size_t j = 0; j < d; j++) {
+        diff = fmax(diff, fabs(tensor_read_at_offset(W, j) - tensor_read_at_offset(W_ref, j)));
+    }
+    LoaderStats st;
+    loader_get_stats(L, &st);
+    printf("  stream full-batch: passes=%ld chunks=%ld load=%.2f ms stall=%.2f ms max|diff|=%.3e\n",
+           st.passes, st.chunks, st.load_ns / 1e6, st.stall_ns / 1e6, diff);
+    if (rc != 0 || diff != 0.0 || res.epochs_run != ref.epochs_run || res.final_loss != ref.final_loss) {
+        fprintf(stderr, "Full-batch streaming differs from in-memory training.\n");
+        failures++;
+    }
+    loader_free(L);
+
+    // 4) Mini-batch SGD over a callback source, 250-row batches
+    MemSource ms = { X, y, (size_t)-1 };
+    LoaderSource src = { mem_fill, NULL, &ms, d };
+    L = loader_create(&src, 250, 0);
+    TrainConfig mb = train_default_config();
+    mb.optim.lr = 0.1;
+    mb.max_epochs = 50;
+    mb.loss_tol = 1e-12;
+    for (size_t j = 0; j < d; j++) tensor_write_at_offset(W, j, 0.0);
+    tensor_write_at_offset(b, 0, 0.0);
+    rc = train_linear_regression_stream(L, TRAIN_MINI_BATCH, W, b, &mb, &res);
+    double err = fabs(tensor_read_at_offset(b, 0) - 1.5);
+    for (size_t j = 0; j < d; j++) {
+        err = fmax(err, fabs(tensor_read_at_offset(W, j) - w_true[j]));
+    }
+    printf("  stream mini-batch: epochs=%d loss=%.3e max|w - w_true|=%.3e\n",
+           res.epochs_run, res.final_loss, err);
+    if (rc != 0 || err > 1e-4) {
+        fprintf(stderr, "Mini-batch streaming did not converge.\n");
+        failures++;
+    }
+    loader_free(L);
+
+    // 5) A failing source stops training with an error
+    ms.fail_at = 1000;
+    L = loader_create(&src, 250, 2);
+    if (train_linear_regression_stream(L, TRAIN_FULL_BATCH, W, b, &cfg, NULL) != -1) {
+        fprintf(stderr, "Source failure was not reported.\n");
+        failures++;
+    }
+    loader_free(L);
+
+    // 6) Malformed files: a trailing partial record, and a header whose d
+    //    would overflow the record size
+    FILE *tf = fopen(path, "ab");
+    if (tf) {
+        fputc(0, tf);
+        fclose(tf);
+    }
+    if (loader_open_file(path, 512, 2) != NULL) {
+        fprintf(stderr, "Dataset with a partial record was accepted.\n");
+        failures++;
+    }
+    tf = fopen(path, "wb");
+    if (tf) {
+        uint32_t version = 1, dt = TENSOR_FLOAT64;
+        uint64_t huge = UINT64_MAX / 4;
+        fwrite("MLDS", 1, 4, tf);
+        fwrite(&version, sizeof(version), 1, tf);
+        fwrite(&dt, sizeof(dt), 1, tf);
+        fwrite(&huge, sizeof(huge), 1, tf);
+        fclose(tf);
+    }
+    if (loader_open_file(path, 512, 2) != NULL) {
+        fprintf(stderr, "Dataset with an oversized feature count was accepted.\n");
+        failures++;
+    }
+    remove(path);
+
+    tensor_free(Xa);
+    tensor_free(ya);
+    tensor_free(Xb);
+    tensor_free(yb);
+    tensor_free(X);
+    tensor_free(y);
+    tensor_free(W_ref);
+    tensor_free(b_ref);
+    tensor_free(W);
+    tensor_free(b);
+    return failures;
+}
+
+/**
+ * Largest violation of the elastic-net optimality conditions at row k of
+ * 'coefs', measured on the raw rows: g = (1/n) X^T (y - X w - b) must
+ * equal lambda * (alpha * sign(w) + (1 - alpha) * w) on nonzero weights
+ * and stay within lambda * alpha in magnitude on zero weights.
+ */
+static double enet_kkt_violation(const Tensor *X, const Tensor *y, const Tensor *coefs,
+                                 size_t k, double lambda, double alpha)
+{
+    size_t n = X->shape[0], d = X->shape[1];
+    double *g = (double*)calloc(d, sizeof(double));
+    double b = tensor_get(coefs, (size_t[]){k, d});
+    for (size_t i = 0; i < n; i++) {
+        double r = tensor_get(y, (size_t[]){i, 0}) - b;
+        for (size_t j = 0; j < d; j++) {
+            r -= tensor_get(X, (size_t[]){i, j}) * tensor_get(coefs, (size_t[]){k, j});
+        }
+        for (size_t j = 0; j < d; j++) {
+            g[j] += tensor_get(X, (size_t[]){i, j}) * r / (double)n;
+        }
+    }
+    double worst = 0.0;
+    for (size_t j = 0; j < d; j++) {
+        double wj = tensor_get(coefs, (size_t[]){k, j});
+        if (wj != 0.0) {
+            double want = lambda * (alpha * (wj > 0 ? 1.0 : -1.0) + (1.0 - alpha) * wj);
+            worst = fmax(worst, fabs(g[j] - want));
+        } else {
+            worst = fmax(worst, fabs(g[j]) - lambda * alpha);
+        }
+    }
+    free(g);
+    return worst;
+}
+
+int test_elastic_net(void)
+{
+    const size_t n = 2000, d = 12;
+    double w_true[12] = { 3.0, -2.0, 0.0, 0.0, 1.5, 0.0, 0.0, 0.0, 0.0, 0.7, 0.0, 0.0 };
+    int failures = 0;
+
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    make_synthetic(X, y, w_true, 1.0);
+    unsigned int state = 4242u;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1103515245u + 12345u;
+        double noise = ((double)((state >> 8) & 0xffff) / 65535.0 - 0.5) * 0.2;
+        tensor_set(y, (size_t[]){i, 0}, tensor_get(y, (size_t[]){i, 0}) + noise);
+    }
+
+    struct timespec t0, t1, t2;
+    timespec_get(&t0, TIME_UTC);
+    ENetGram *g = enet_gram_create(X, y);
+    timespec_get(&t1, TIME_UTC);
+    if (!g) return 1;
+    double gram_ms = 1e3 * (double)(t1.tv_sec - t0.tv_sec) + 1e-6 * (double)(t1.tv_nsec - t0.tv_nsec);
+
+    // 1) Lasso, ridge and an even mix along 100-point paths
+    double alphas[3] = { 1.0, 0.0, 0.5 };
+    ENetPathPoint pts[100];
+    Tensor *coefs = tensor_create(2, (size_t[]){100, d + 1}, TENSOR_FLOAT64);
+    int sweeps = 0;
+    double path_ms = 0.0;
+    for (int a = 0; a < 3; a++) {
+        ENetConfig cfg = enet_default_config(alphas[a]);
+        cfg.tol = 1e-14;
+        timespec_get(&t1, TIME_UTC);
+        if (enet_path(g, &cfg, coefs, pts) != 0) return 1;
+        timespec_get(&t2, TIME_UTC);
+        path_ms += 1e3 * (double)(t2.tv_sec - t1.tv_sec) + 1e-6 * (double)(t2.tv_nsec - t1.tv_nsec);
+        double worst = 0.0;
+        for (size_t k = 0; k < cfg.num_lambdas; k += 11) {
+            worst = fmax(worst, enet_kkt_violation(X, y, coefs, k, pts[k].lambda, alphas[a]));
+        }
+        int ok = worst < 1e-6;
+        for (size_t k = 0; k < cfg.num_lambdas; k++) {
+            ok &= pts[k].converged && (k == 0 || pts[k].lambda < pts[k - 1].lambda);
+            sweeps += pts[k].sweeps;
+        }
+        if (alphas[a] == 1.0) {
+            // Lasso: empty at lambda_max; the true support at the end of the path
+            ok &= pts[0].nonzero == 0;
+            for (size_t j = 0; j < d; j++) {
+                double wj = tensor_get(coefs, (size_t[]){99, j});
+                ok &= fabs(wj - w_true[j]) < 0.02;
+            }
+            ok &= fabs(pts[99].intercept - 1.0) < 0.02;
+        }
+        printf("  enet alpha=%.1f: max KKT violation %.2e, nonzero %zu -> %zu, mse %.4f\n",
+               alphas[a], worst, pts[0].nonzero, pts[99].nonzero, pts[99].train_mse);
+        if (!ok) {
+            fprintf(stderr, "Elastic-net path check failed (alpha=%.1f).\n", alphas[a]);
+            failures++;
+        }
+    }
+    printf("  enet: Gram of [%zu x %zu] %.2f ms, 3 paths x 100 lambdas (%d sweeps) %.2f ms\n",
+           n, d, gram_ms, sweeps, path_ms);
+
+    // 2) Explicit lambdas: ridge at lambda = 0 is ordinary least squares
+    double lambdas[2] = { 0.5, 0.0 };
+    ENetConfig ols = enet_default_config(0.0);
+    ols.lambdas = lambdas;
+    ols.num_lambdas = 2;
+    ols.tol = 1e-14;
+    Tensor *two = tensor_create(2, (size_t[]){2, d + 1}, TENSOR_FLOAT64);
+    if (enet_path(g, &ols, two, pts) != 0 ||
+        enet_kkt_violation(X, y, two, 0, 0.5, 0.0) > 1e-6 ||
+        enet_kkt_violation(X, y, two, 1, 0.0, 0.0) > 1e-6) {
+        fprintf(stderr, "Explicit-lambda ridge path failed.\n");
+        failures++;
+    }
+
+    // 3) A KKT violator added after the last allowed sweep is not converged:
+    //    x2 = 4.6 z - 3 x1 is left out by the strong rule at lambda = 0.9,
+    //    then violates once x1 enters (orthogonal +-1 patterns for x1, z)
+    const size_t m2 = 400;
+    Tensor *X2 = tensor_create(2, (size_t[]){m2, 2}, TENSOR_FLOAT64);
+    Tensor *y2 = tensor_create(2, (size_t[]){m2, 1}, TENSOR_FLOAT64);
+    for (size_t i = 0; i < m2; i++) {
+        double x1 = (i % 2) ? -1.0 : 1.0, z = ((i / 2) % 2) ? -1.0 : 1.0;
+        tensor_set(X2, (size_t[]){i, 0}, x1);
+        tensor_set(X2, (size_t[]){i, 1}, 4.6 * z - 3.0 * x1);
+        tensor_set(y2, (size_t[]){i, 0}, 1.5 * x1 + z);
+    }
+    ENetGram *g2 = enet_gram_create(X2, y2);
+    double lam = 0.9;
+    ENetConfig one = enet_default_config(1.0);
+    one.lambdas = &lam;
+    one.num_lambdas = 1;
+    one.max_sweeps = 1;
+    one.tol = 1e6;
+    Tensor *c2 = tensor_create(2, (size_t[]){1, 3}, TENSOR_FLOAT64);
+    ENetPathPoint p1, p2;
+    int ok = g2 && enet_path(g2, &one, c2, &p1) == 0 && !p1.converged;
+    one.max_sweeps = 1000;
+    one.tol = 1e-14;
+    ok &= g2 && enet_path(g2, &one, c2, &p2) == 0 && p2.converged && p2.nonzero == 2;
+    if (!ok) {
+        fprintf(stderr, "Elastic-net reported convergence with unswept KKT violators.\n");
+        failures++;
+    }
+    tensor_free(c2);
+    enet_gram_free(g2);
+    tensor_free(y2);
+    tensor_free(X2);
+
+    tensor_free(two);
+    tensor_free(coefs);
+    enet_gram_free(g);
+    tensor_free(X);
+    tensor_free(y);
+    return failures;
+}
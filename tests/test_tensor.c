@@ -0,0 +1,1166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdint.h>
+
+#include "test_tensor.h"
+#include "tensor.h"      // your Tensor module
+#include "sparse.h"
+#include "compress.h"
+#include "lr.h"
+#include "parallel.h"
+#include "cpu.h"
+#include "rng.h"
+#include "scaler.h"
+#include "online.h"
+#include "rolling.h"
+
+#define CHECK(cond, msg)                                        \
+    do {                                                        \
+        if (!(cond)) {                                          \
+            fprintf(stderr, "[%s] FAILED: %s\n", __func__, msg); \
+            return 1;                                           \
+        }                                                       \
+    } while (0)
+
+int test_tensor_views(void)
+{
+    // 1) Base tensor [4,6] filled with 0..23
+    size_t shape[2] = { 4, 6 };
+    Tensor *t = tensor_create(2, shape, TENSOR_FLOAT64);
+    CHECK(t, "create");
+    for (size_t i = 0; i < t->num_elems; i++) {
+        tensor_write_at_offset(t, i, (double)i);
+    }
+    CHECK(tensor_is_contiguous(t), "fresh tensor is contiguous");
+
+    // 2) Column slice [:, 1:4] is strided: in-place reshape must refuse it
+    Tensor *s = tensor_slice(t, (size_t[]){0, 1}, (size_t[]){4, 4});
+    CHECK(s && !tensor_is_contiguous(s), "column slice is non-contiguous");
+    CHECK(tensor_reshape(s, 1, (size_t[]){12}) != 0, "reshape rejects slice");
+    CHECK(tensor_view_reshape(s, 1, (size_t[]){12}) == NULL, "view reshape needs copy");
+    CHECK(fabs(tensor_sum(s) - 132.0) < 1e-12, "strided sum");
+
+    // 3) Row slice [1:3, :] stays contiguous and can be viewed as [3,4]
+    Tensor *rows = tensor_slice(t, (size_t[]){1, 0}, (size_t[]){3, 6});
+    CHECK(rows && tensor_is_contiguous(rows), "row slice is contiguous");
+    Tensor *r34 = tensor_view_reshape(rows, 2, (size_t[]){3, 4});
+    CHECK(r34 && r34->data == rows->data, "row slice reshape is a view");
+    CHECK(tensor_get(r34, (size_t[]){2, 3}) == 17.0, "reshape view value");
+
+    // 4) Splitting a strided dim is expressible without a copy
+    Tensor *split = tensor_view_reshape(s, 3, (size_t[]){2, 2, 3});
+    CHECK(split, "split strided rows");
+    CHECK(tensor_get(split, (size_t[]){1, 1, 2}) == 21.0, "split value");
+
+    // 5) tensor_contiguous copies only when needed
+    Tensor *c1 = tensor_contiguous(rows);
+    Tensor *c2 = tensor_contiguous(s);
+    CHECK(c1 && c1->data == rows->data, "contiguous input is not copied");
+    CHECK(c2 && c2->data != s->data && tensor_is_contiguous(c2), "strided input is copied");
+    CHECK(tensor_read_at_offset(c2, 3) == 7.0, "copied values in row-major order");
+
+    // 6) Expand a [1,3] row to [4,3] with stride 0
+    Tensor *row = tensor_slice(t, (size_t[]){0, 0}, (size_t[]){1, 3});
+    Tensor *e = tensor_expand(row, 2, (size_t[]){4, 3});
+    CHECK(e && e->strides[0] == 0 && !tensor_is_contiguous(e), "expand stride 0");
+    CHECK(fabs(tensor_sum(e) - 12.0) < 1e-12, "expanded sum");
+    Tensor *ec = tensor_copy(e);
+    CHECK(ec && tensor_read_at_offset(ec, 10) == 1.0, "expanded copy");
+
+    // 7) Squeeze / unsqueeze round trip
+    Tensor *u = tensor_unsqueeze(t, 1);
+    CHECK(u && u->ndim == 3 && u->shape[1] == 1 && tensor_is_contiguous(u), "unsqueeze");
+    Tensor *q = tensor_squeeze(u, -1);
+    CHECK(q && q->ndim == 2 && q->shape[0] == 4 && q->shape[1] == 6, "squeeze all");
+    CHECK(tensor_squeeze(t, 0) == NULL, "squeeze rejects non-unit dim");
+
+    // 8) Freeing the owner first keeps the buffer alive for views
+    tensor_free(t);
+    CHECK(tensor_get(q, (size_t[]){3, 5}) == 23.0, "view outlives owner");
+
+    tensor_free(s);
+    tensor_free(rows);
+    tensor_free(r34);
+    tensor_free(split);
+    tensor_free(c1);
+    tensor_free(c2);
+    tensor_free(row);
+    tensor_free(e);
+    tensor_free(ec);
+    tensor_free(u);
+    tensor_free(q);
+
+    printf("test_tensor_views passed.\n");
+    return 0;
+}
+
+int test_sparse_csr(void)
+{
+    // 1) ~10% dense [200,8] design with a known linear target
+    size_t n = 200, d = 8;
+    Tensor *Xd = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    CHECK(Xd && y, "create");
+    double *x = (double*)Xd->data;
+    unsigned int state = 7u;
+    for (size_t i = 0; i < n; i++) {
+        x[i * d + (i % d)] = 1.0 + (double)(i % 5);   // every row has a nonzero
+        state = state * 1103515245u + 12345u;
+        if ((state >> 16) % 4 == 0) x[i * d + ((state >> 8) % d)] += 0.5;
+        double target = 0.3;
+        for (size_t j = 0; j < d; j++) target += x[i * d + j] * (double)(j + 1) * 0.1;
+        tensor_write_at_offset(y, i, target);
+    }
+
+    Tensor *Xs = tensor_csr_from_dense(Xd);
+    CHECK(Xs && Xs->layout == TENSOR_LAYOUT_CSR, "from_dense");
+    CHECK(tensor_csr(Xs)->nnz < n * d / 4, "stores only nonzeros");
+    CHECK(fabs(tensor_sum(Xs) - tensor_sum(Xd)) < 1e-9, "sum");
+
+    // 2) Round trip and COO construction with duplicates
+    Tensor *back = tensor_csr_to_dense(Xs);
+    CHECK(back && memcmp(back->data, Xd->data, n * d * sizeof(double)) == 0, "to_dense");
+    tensor_free(back);
+
+    size_t ri[4] = { 1, 0, 1, 1 }, ci[4] = { 2, 1, 0, 2 };
+    double vv[4] = { 1.0, 2.0, 3.0, 4.0 };
+    Tensor *coo = tensor_csr_from_coo(2, 3, 4, ri, ci, vv);
+    CHECK(coo && tensor_csr(coo)->nnz == 3, "coo merges duplicates");
+    const CSRStorage *c = tensor_csr(coo);
+    CHECK(c->indices[1] == 0 && c->indices[2] == 2 && c->values[2] == 5.0, "coo sorted/summed");
+    tensor_free(coo);
+
+    // 3) matmul: SpMV and SpMM agree with the dense kernel
+    Tensor *B = tensor_create(2, (size_t[]){d, 3}, TENSOR_FLOAT64);
+    for (size_t i = 0; i < B->num_elems; i++) tensor_write_at_offset(B, i, 0.25 * (double)i - 1.0);
+    Tensor *Pd = tensor_matmul(Xd, B);
+    Tensor *Ps = tensor_matmul(Xs, B);
+    CHECK(Pd && Ps, "matmul");
+    for (size_t i = 0; i < Pd->num_elems; i++) {
+        CHECK(fabs(tensor_read_at_offset(Pd, i) - tensor_read_at_offset(Ps, i)) < 1e-12, "spmm");
+    }
+    tensor_free(Pd);
+    tensor_free(Ps);
+    tensor_free(B);
+
+    Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    for (size_t j = 0; j < d; j++) tensor_write_at_offset(W, j, 0.1 * (double)j);
+    tensor_write_at_offset(b, 0, 0.5);
+    Tensor *fd = linear_forward(Xd, W, b);
+    Tensor *fs = linear_forward(Xs, W, b);
+    CHECK(fd && fs, "linear_forward");
+    for (size_t i = 0; i < n; i++) {
+        CHECK(fabs(tensor_read_at_offset(fd, i) - tensor_read_at_offset(fs, i)) < 1e-12, "spmv");
+    }
+    tensor_free(fd);
+    tensor_free(fs);
+
+    // 4) Training on CSR follows the dense run step for step
+    Tensor *Wd = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *bd = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    TrainConfig cfg = train_default_config();
+    cfg.optim.lr = 0.02;
+    cfg.max_epochs = 300;
+    cfg.verbose = 0;
+    TrainResult rd, rs;
+    for (size_t j = 0; j < d; j++) tensor_write_at_offset(W, j, 0.0);
+    tensor_write_at_offset(b, 0, 0.0);
+    CHECK(train_linear_regression_ex(Xd, y, Wd, bd, &cfg, &rd) == 0, "dense train");
+    CHECK(train_linear_regression_ex(Xs, y, W, b, &cfg, &rs) == 0, "sparse train");
+    CHECK(rd.epochs_run == rs.epochs_run, "same epoch count");
+    for (size_t j = 0; j < d; j++) {
+        CHECK(fabs(tensor_read_at_offset(Wd, j) - tensor_read_at_offset(W, j)) < 1e-9, "same weights");
+    }
+    printf("Sparse CSR: nnz=%zu of %zu, train loss %.3e after %d epochs (dense %.3e)\n",
+           tensor_csr(Xs)->nnz, n * d, rs.final_loss, rs.epochs_run, rd.final_loss);
+
+    // 5) Strided-only entry points reject CSR instead of reading NULL data
+    Tensor *ys = tensor_csr_from_dense(y);
+    Scaler *sc = scaler_create(SCALER_ZSCORE, d);
+    OnlineRLS *rls = rls_create(d, 1.0, 100.0);
+    RollingConfig rc = rolling_default_config(20);
+    CHECK(ys && sc && rls, "create");
+    CHECK(tensor_get(Xs, (size_t[]){0, 0}) == 0.0, "tensor_get rejects CSR");
+    tensor_set(Xs, (size_t[]){0, 0}, 1.0);
+    CHECK(scaler_fit(sc, Xs) == -1, "scaler_fit rejects CSR");
+    CHECK(scaler_transform(sc, Xs) == -1, "scaler_transform rejects CSR");
+    CHECK(rls_update_batch(rls, Xs, y) == -1 && rls_update_batch(rls, Xd, ys) == -1, "rls rejects CSR");
+    CHECK(rolling_regression(Xs, y, &rc) == NULL && rolling_regression(Xd, ys, &rc) == NULL,
+          "rolling rejects CSR");
+    CHECK(train_linear_regression_ex(Xd, ys, W, b, &cfg, &rs) == -1, "trainer rejects CSR y");
+    rls_free(rls);
+    scaler_free(sc);
+    tensor_free(ys);
+
+    tensor_free(Wd);
+    tensor_free(bd);
+    tensor_free(W);
+    tensor_free(b);
+    tensor_free(Xs);
+    tensor_free(Xd);
+    tensor_free(y);
+    return 0;
+}
+
+static double sigmoid_ref(double x) { return 1.0 / (1.0 + exp(-x)); }
+static double square_ref(double x) { return x * x; }
+static double neg_ref(double x) { return -x; }
+
+int test_unary_ops(void)
+{
+    // 1) Accuracy of every op against libm on a dense grid
+    struct { TensorUnaryOp op; double (*ref)(double); double lo, hi, tol; } cases[] = {
+        { TENSOR_OP_ABS,     fabs,        -10.0,  10.0,  0.0 },
+        { TENSOR_OP_NEG,     neg_ref,     -10.0,  10.0,  0.0 },
+        { TENSOR_OP_SQUARE,  square_ref,  -10.0,  10.0,  0.0 },
+        { TENSOR_OP_SQRT,    sqrt,          0.0, 1e6,    0.0 },
+        { TENSOR_OP_EXP,     exp,        -700.0, 700.0,  1e-15 },
+        { TENSOR_OP_LOG,     log,        1e-300, 1e300,  1e-15 },
+        { TENSOR_OP_SIGMOID, sigmoid_ref, -40.0,  40.0,  2e-15 },
+        { TENSOR_OP_TANH,    tanh,        -40.0,  40.0,  4e-15 },
+    };
+    size_t n = 100003;   // odd length exercises the vector tail
+    Tensor *x = tensor_create(1, &n, TENSOR_FLOAT64);
+    CHECK(x, "create");
+    double *xv = (double*)x->data;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        for (size_t i = 0; i < n; i++) {
+            double u = (double)i / (double)(n - 1);
+            xv[i] = (cases[c].op == TENSOR_OP_LOG)
+                  ? exp(log(cases[c].lo) + u * (log(cases[c].hi) - log(cases[c].lo)))
+                  : cases[c].lo + u * (cases[c].hi - cases[c].lo);
+        }
+        Tensor *y = tensor_unary(x, cases[c].op);
+        CHECK(y, "tensor_unary");
+        double max_rel = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            double want = cases[c].ref(xv[i]);
+            double err = fabs(((double*)y->data)[i] - want);
+            double rel = want != 0.0 ? err / fabs(want) : err;
+            if (rel > max_rel) max_rel = rel;
+        }
+        tensor_free(y);
+        CHECK(max_rel <= cases[c].tol, "error bound");
+    }
+
+    // 2) IEEE special values
+    double sp[6] = { 0.0, -1.0, INFINITY, -INFINITY, NAN, -745.0 };
+    Tensor *s = tensor_create(1, (size_t[]){6}, TENSOR_FLOAT64);
+    memcpy(s->data, sp, sizeof(sp));
+    Tensor *e = tensor_unary(s, TENSOR_OP_EXP);
+    Tensor *l = tensor_unary(s, TENSOR_OP_LOG);
+    const double *ev = (const double*)e->data, *lv = (const double*)l->data;
+    CHECK(ev[0] == 1.0 && ev[2] == INFINITY && ev[3] == 0.0 && isnan(ev[4]), "exp specials");
+    CHECK(ev[5] == exp(-745.0), "exp subnormal");
+    CHECK(lv[0] == -INFINITY && isnan(lv[1]) && lv[2] == INFINITY && isnan(lv[3]), "log specials");
+    tensor_free(e);
+    tensor_free(l);
+    tensor_free(s);
+
+    // 3) Strided input, out-param into float32, in-place on int32
+    Tensor *m = tensor_create(2, (size_t[]){4, 6}, TENSOR_FLOAT64);
+    for (size_t i = 0; i < m->num_elems; i++) tensor_write_at_offset(m, i, 0.1 * (double)i - 1.0);
+    Tensor *col = tensor_slice(m, (size_t[]){0, 2}, (size_t[]){4, 5});
+    Tensor *o32 = tensor_create(2, (size_t[]){4, 3}, TENSOR_FLOAT32);
+    CHECK(tensor_unary_out(col, TENSOR_OP_TANH, o32) == 0, "unary_out");
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            double want = tanh(0.1 * (double)(i * 6 + j + 2) - 1.0);
+            CHECK(fabs(tensor_get(o32, (size_t[]){i, j}) - want) < 1e-6, "strided -> float32");
+        }
+    }
+    CHECK(tensor_unary_out(m, TENSOR_OP_EXP, o32) != 0, "shape mismatch rejected");
+    Tensor *iv = tensor_create(1, (size_t[]){3}, TENSOR_INT32);
+    tensor_write_at_offset(iv, 0, -3.0);
+    tensor_write_at_offset(iv, 1, 4.0);
+    tensor_write_at_offset(iv, 2, -7.0);
+    CHECK(tensor_unary_inplace(iv, TENSOR_OP_ABS) == 0, "inplace");
+    CHECK(tensor_read_at_offset(iv, 0) == 3.0 && tensor_read_at_offset(iv, 2) == 7.0, "int abs");
+    tensor_free(iv);
+    tensor_free(o32);
+    tensor_free(col);
+    tensor_free(m);
+
+    // 4) Throughput against the scalar libm loop this replaces
+    for (size_t i = 0; i < n; i++) xv[i] = -5.0 + 10.0 * (double)i / (double)n;
+    Tensor *y = tensor_create(1, &n, TENSOR_FLOAT64);
+    int reps = 20;
+    clock_t t0 = clock();
+    for (int r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) {
+            tensor_write_at_offset(y, i, exp(tensor_read_at_offset(x, i)));
+        }
+    }
+    clock_t t1 = clock();
+    for (int r = 0; r < reps; r++) {
+        tensor_unary_out(x, TENSOR_OP_EXP, y);
+    }
+    clock_t t2 = clock();
+    double scalar_s = (double)(t1 - t0) / CLOCKS_PER_SEC;
+    double vector_s = (double)(t2 - t1) / CLOCKS_PER_SEC;
+    printf("Unary exp: libm loop %.1f Melem/s, tensor_unary %.1f Melem/s\n",
+           reps * (double)n / 1e6 / (scalar_s > 0 ? scalar_s : 1e-9),
+           reps * (double)n / 1e6 / (vector_s > 0 ? vector_s : 1e-9));
+
+    tensor_free(y);
+    tensor_free(x);
+    return 0;
+}
+
+/** Allocate with 'flags', write every element once, free; returns seconds. */
+static double time_alloc_fill(size_t n, int flags)
+{
+    clock_t t0 = clock();
+    Tensor *t = tensor_create_ex(1, &n, TENSOR_FLOAT64, flags);
+    if (!t) return -1.0;
+    double *v = (double*)t->data;
+    for (size_t i = 0; i < n; i++) v[i] = (double)i;
+    tensor_free(t);
+    return (double)(clock() - t0) / CLOCKS_PER_SEC;
+}
+
+int test_tensor_alloc(void)
+{
+    // 1) Every policy returns 64-byte aligned buffers; zeroing is honoured
+    size_t small = 37;
+    Tensor *e = tensor_empty(1, &small, TENSOR_FLOAT32);
+    Tensor *z = tensor_create(1, &small, TENSOR_FLOAT64);
+    CHECK(e && z, "create");
+    CHECK((uintptr_t)e->data % TENSOR_ALIGNMENT == 0, "empty aligned");
+    CHECK((uintptr_t)z->data % TENSOR_ALIGNMENT == 0, "create aligned");
+    CHECK(tensor_sum(z) == 0.0 && z->buffer_kind == TENSOR_BUFFER_HEAP, "create zeroed");
+    tensor_free(e);
+    tensor_free(z);
+
+    size_t big = (size_t)1 << 20;   // 8 MiB of float64
+    int policies[3] = {
+        TENSOR_ALLOC_HUGEPAGE,
+        TENSOR_ALLOC_FIRST_TOUCH,
+        TENSOR_ALLOC_HUGEPAGE | TENSOR_ALLOC_FIRST_TOUCH,
+    };
+    for (int p = 0; p < 3; p++) {
+        Tensor *t = tensor_create_ex(1, &big, TENSOR_FLOAT64, policies[p]);
+        CHECK(t, "create_ex");
+        CHECK((uintptr_t)t->data % TENSOR_ALIGNMENT == 0, "create_ex aligned");
+        CHECK(tensor_sum(t) == 0.0, "create_ex zeroed");
+#ifdef __linux__
+        if (policies[p] & TENSOR_ALLOC_HUGEPAGE) {
+            CHECK(t->buffer_kind == TENSOR_BUFFER_MAPPED, "huge-page buffer is mapped");
+        }
+#endif
+        // Views share the mapping; the buffer outlives the owner handle
+        Tensor *s = tensor_slice(t, (size_t[]){big - 4}, (size_t[]){big});
+        tensor_write_at_offset(t, big - 1, 7.0);
+        tensor_free(t);
+        CHECK(tensor_read_at_offset(s, 3) == 7.0, "view keeps buffer alive");
+        tensor_free(s);
+    }
+
+    // 2) Allocate-and-fill cost per policy
+    size_t n = (size_t)8 << 20;   // 64 MiB of float64
+    printf("Alloc+fill 64 MiB: zeroed %.1f ms, empty %.1f ms, hugepage %.1f ms, first-touch %.1f ms\n",
+           1e3 * time_alloc_fill(n, TENSOR_ALLOC_ZERO),
+           1e3 * time_alloc_fill(n, 0),
+           1e3 * time_alloc_fill(n, TENSOR_ALLOC_HUGEPAGE),
+           1e3 * time_alloc_fill(n, TENSOR_ALLOC_FIRST_TOUCH));
+    return 0;
+}
+
+static void fill_index(size_t lo, size_t hi, void *ctx)
+{
+    double *v = (double*)ctx;
+    for (size_t i = lo; i < hi; i++) v[i] += (double)i;
+}
+
+/** Region body that itself calls a parallel op: must run inline, not deadlock. */
+static void nested_sum(size_t lo, size_t hi, void *ctx)
+{
+    Tensor **ts = (Tensor**)ctx;
+    for (size_t i = lo; i < hi; i++) {
+        tensor_write_at_offset(ts[1], i, tensor_sum(ts[0]));
+    }
+}
+
+int test_parallel_runtime(void)
+{
+    // 1) parallel_for covers every index exactly once
+    size_t n = 1000003;
+    Tensor *t = tensor_create(1, &n, TENSOR_FLOAT64);
+    CHECK(t, "create");
+    parallel_for(n, 4096, fill_index, t->data);
+    for (size_t i = 0; i < n; i++) {
+        CHECK(((double*)t->data)[i] == (double)i, "parallel_for coverage");
+    }
+
+    // 2) Reductions are bit-identical for any thread count
+    unsigned int state = 99u;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1103515245u + 12345u;
+        ((double*)t->data)[i] = (double)(state >> 8) * 1e-7 - 800.0;
+    }
+    Tensor *col = tensor_slice(t, (size_t[]){1}, (size_t[]){n});   // odd length view
+    int threads = parallel_num_threads();
+    double ref_sum = 0.0, ref_dot = 0.0;
+    for (int k = 1; k <= threads; k++) {
+        parallel_set_num_threads(k);
+        double s = tensor_sum(t);
+        double d = tensor_dot(col, col);
+        if (k == 1) {
+            ref_sum = s;
+            ref_dot = d;
+        }
+        CHECK(s == ref_sum && d == ref_dot, "deterministic reduction");
+    }
+    parallel_set_num_threads(0);
+
+    // 3) Elementwise ops match the serial result
+    Tensor *two = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    tensor_write_at_offset(two, 0, 2.0);
+    Tensor *m = tensor_mul(t, two);
+    Tensor *c = tensor_copy(col);
+    CHECK(m && c, "ops");
+    for (size_t i = 0; i + 1 < n; i++) {
+        CHECK(((double*)m->data)[i + 1] == 2.0 * ((double*)t->data)[i + 1], "mul");
+        CHECK(((double*)c->data)[i] == ((double*)t->data)[i + 1], "copy");
+    }
+
+    // 4) Nested parallel calls run inline on the worker
+    Tensor *sums = tensor_create(1, (size_t[]){8}, TENSOR_FLOAT64);
+    Tensor *ctx[2] = { t, sums };
+    parallel_for(8, 1, nested_sum, ctx);
+    for (size_t i = 0; i < 8; i++) {
+        CHECK(tensor_read_at_offset(sums, i) == ref_sum, "nested sum");
+    }
+
+    // 5) Serial vs pooled reduction wall time
+    struct timespec w0, w1, w2;
+    parallel_set_num_threads(1);
+    timespec_get(&w0, TIME_UTC);
+    for (int r = 0; r < 20; r++) tensor_sum(t);
+    timespec_get(&w1, TIME_UTC);
+    parallel_set_num_threads(0);
+    for (int r = 0; r < 20; r++) tensor_sum(t);
+    timespec_get(&w2, TIME_UTC);
+    printf("Parallel runtime: %d threads, sum of %zu x20: 1 thread %.1f ms, pool %.1f ms\n",
+           threads, n,
+           1e3 * (double)(w1.tv_sec - w0.tv_sec) + 1e-6 * (double)(w1.tv_nsec - w0.tv_nsec),
+           1e3 * (double)(w2.tv_sec - w1.tv_sec) + 1e-6 * (double)(w2.tv_nsec - w1.tv_nsec));
+
+    tensor_free(sums);
+    tensor_free(m);
+    tensor_free(c);
+    tensor_free(two);
+    tensor_free(col);
+    tensor_free(t);
+    return 0;
+}
+
+/** Reference A x + bias via element reads, summed in the kernels' order. */
+static double ref_gemv_row(const Tensor *A, const Tensor *x, size_t i, double bias)
+{
+    double s = bias;
+    for (size_t k = 0; k < A->shape[1]; k++) {
+        s += tensor_read_at_offset(A, i * A->strides[0] + k * A->strides[1]) *
+             tensor_read_at_offset(x, k * x->strides[0]);
+    }
+    return s;
+}
+
+int test_gemv_kernels(void)
+{
+    unsigned int state = 7u;
+
+    // 1) Every unrolled width, the generic width past it, and large M (pooled)
+    size_t widths[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 40 };
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+        size_t d = widths[w];
+        size_t n = (d == 8) ? 20000 : 301;
+        Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+        Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+        Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+        Tensor *r = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+        CHECK(X && W && b && r, "create");
+        for (size_t i = 0; i < X->num_elems; i++) {
+            state = state * 1103515245u + 12345u;
+            tensor_write_at_offset(X, i, (double)(state >> 8) * 1e-6 - 8.0);
+        }
+        for (size_t j = 0; j < d; j++) tensor_write_at_offset(W, j, 0.25 * (double)j - 1.0);
+        for (size_t i = 0; i < n; i++) tensor_write_at_offset(r, i, (double)(i % 7) - 3.0);
+        tensor_write_at_offset(b, 0, 0.5);
+
+        // Forward: matmul (bias 0) and linear_forward (bias folded in)
+        Tensor *xw = tensor_matmul(X, W);
+        Tensor *pred = linear_forward(X, W, b);
+        CHECK(xw && pred && pred->shape[0] == n && pred->shape[1] == 1, "forward shapes");
+        for (size_t i = 0; i < n; i++) {
+            CHECK(tensor_read_at_offset(xw, i) == ref_gemv_row(X, W, i, 0.0), "matmul gemv");
+            CHECK(tensor_read_at_offset(pred, i) == ref_gemv_row(X, W, i, 0.5), "linear_forward");
+        }
+
+        // Gradient shape: X^T r through a transposed view, and r^T X as [1, d]
+        Tensor *Xt = tensor_transpose(X);
+        Tensor *rt = tensor_transpose(r);
+        Tensor *g = tensor_matmul(Xt, r);
+        Tensor *gt = tensor_matmul(rt, X);
+        CHECK(Xt && rt && g && gt && g->shape[0] == d && gt->shape[1] == d, "gradient shapes");
+        for (size_t j = 0; j < d; j++) {
+            double ref = ref_gemv_row(Xt, r, j, 0.0);
+            CHECK(tensor_read_at_offset(g, j) == ref, "transposed gemv");
+            CHECK(tensor_read_at_offset(gt, j) == ref, "row-vector gemv");
+        }
+
+        tensor_free(gt);
+        tensor_free(g);
+        tensor_free(rt);
+        tensor_free(Xt);
+        tensor_free(pred);
+        tensor_free(xw);
+        tensor_free(r);
+        tensor_free(b);
+        tensor_free(W);
+        tensor_free(X);
+    }
+
+    // 2) Strided operands: column slices of A and of a [5,2] x
+    Tensor *A = tensor_create(2, (size_t[]){50, 12}, TENSOR_FLOAT64);
+    Tensor *v = tensor_create(2, (size_t[]){5, 2}, TENSOR_FLOAT64);
+    CHECK(A && v, "create");
+    for (size_t i = 0; i < A->num_elems; i++) tensor_write_at_offset(A, i, (double)(i % 13) - 6.0);
+    for (size_t i = 0; i < v->num_elems; i++) tensor_write_at_offset(v, i, 0.5 * (double)i);
+    Tensor *As = tensor_slice(A, (size_t[]){0, 2}, (size_t[]){50, 7});
+    Tensor *vs = tensor_slice(v, (size_t[]){0, 1}, (size_t[]){5, 2});   // stride 2
+    CHECK(As && vs && vs->strides[0] == 2, "slices");
+    Tensor *out = tensor_gemv(As, vs, -1.0);
+    CHECK(out && out->shape[0] == 50, "strided gemv");
+    for (size_t i = 0; i < 50; i++) {
+        CHECK(tensor_read_at_offset(out, i) == ref_gemv_row(As, vs, i, -1.0), "strided values");
+    }
+    CHECK(tensor_gemv(A, vs, 0.0) == NULL, "shape mismatch rejected");
+
+    // 3) Throughput: fused GEMV forward vs element-read loop, [n, 8]
+    size_t n = 1u << 18, d = 8;
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *ref = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    CHECK(X && W && ref, "create");
+    for (size_t i = 0; i < X->num_elems; i++) tensor_write_at_offset(X, i, (double)(i % 17));
+    for (size_t j = 0; j < d; j++) tensor_write_at_offset(W, j, 1.0 / (double)(j + 1));
+    struct timespec w0, w1, w2;
+    timespec_get(&w0, TIME_UTC);
+    for (size_t i = 0; i < n; i++) tensor_write_at_offset(ref, i, ref_gemv_row(X, W, i, 0.0));
+    timespec_get(&w1, TIME_UTC);
+    Tensor *fast = tensor_gemv(X, W, 0.0);
+    timespec_get(&w2, TIME_UTC);
+    CHECK(fast, "gemv");
+    for (size_t i = 0; i < n; i++) {
+        CHECK(tensor_read_at_offset(fast, i) == tensor_read_at_offset(ref, i), "gemv vs loop");
+    }
+    printf("GEMV [%zu x %zu]: element loop %.2f ms, gemv %.2f ms\n", n, d,
+           1e3 * (double)(w1.tv_sec - w0.tv_sec) + 1e-6 * (double)(w1.tv_nsec - w0.tv_nsec),
+           1e3 * (double)(w2.tv_sec - w1.tv_sec) + 1e-6 * (double)(w2.tv_nsec - w1.tv_nsec));
+
+    tensor_free(fast);
+    tensor_free(ref);
+    tensor_free(W);
+    tensor_free(X);
+    tensor_free(out);
+    tensor_free(vs);
+    tensor_free(As);
+    tensor_free(v);
+    tensor_free(A);
+    return 0;
+}
+
+int test_compressed_storage(void)
+{
+    // 1) Price-like columns: a quarter-tick random walk, a cents random
+    //    walk, and a flat stretch; 2500 rows leaves a partial last block
+    size_t n = 2500, d = 3;
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *y = tensor_create(2, (size_t[]){n, 1}, TENSOR_FLOAT64);
+    Tensor *W = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    CHECK(X && y && W && b, "create");
+    unsigned int state = 11u;
+    double quarter = 4000.0, cents = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1103515245u + 12345u;
+        quarter += 0.25 * (double)((int)((state >> 16) % 5) - 2);
+        state = state * 1103515245u + 12345u;
+        cents = round(100.0 * (cents + 0.01 * (double)((int)((state >> 16) % 21) - 10))) / 100.0;
+        double flat = (i / 100) % 2 ? 1.5 : -2.0;
+        tensor_write_at_offset(X, i * d + 0, quarter);
+        tensor_write_at_offset(X, i * d + 1, cents);
+        tensor_write_at_offset(X, i * d + 2, flat);
+        tensor_write_at_offset(y, i, 0.001 * quarter - 0.5 * cents + flat);
+    }
+    for (size_t j = 0; j < d; j++) tensor_write_at_offset(W, j, 0.5 - 0.25 * (double)j);
+    tensor_write_at_offset(b, 0, 0.75);
+
+    // 2) Lossless roundtrip, 2D and 1D
+    Tensor *C = tensor_compress(X);
+    CHECK(C && C->layout == TENSOR_LAYOUT_COMPRESSED && C->data == NULL, "compress");
+    const CompressedStorage *cs = tensor_compressed(C);
+    CHECK(cs && cs->rows == n && cs->cols == d && cs->num_blocks == 3, "storage");
+    Tensor *D = tensor_decompress(C);
+    CHECK(D && D->ndim == 2 && D->shape[0] == n && D->shape[1] == d, "decompress");
+    CHECK(memcmp(D->data, X->data, n * d * sizeof(double)) == 0, "2D roundtrip is exact");
+
+    Tensor *flat = tensor_create(1, (size_t[]){n}, TENSOR_FLOAT64);
+    CHECK(flat, "create");
+    for (size_t i = 0; i < n; i++) tensor_write_at_offset(flat, i, tensor_read_at_offset(X, i * d + 1));
+    Tensor *C1 = tensor_compress(flat);
+    Tensor *D1 = C1 ? tensor_decompress(C1) : NULL;
+    CHECK(D1 && D1->ndim == 1 && D1->shape[0] == n, "1D compress");
+    for (size_t i = 0; i < n; i++) {
+        CHECK(tensor_read_at_offset(D1, i) == tensor_read_at_offset(X, i * d + 1), "1D roundtrip");
+    }
+
+    // 3) Per-column ratio: the binary tick grid and the flat stretch compress
+    //    well; decimal cents are not exact in binary and compress little
+    size_t per_col[3];
+    for (size_t j = 0; j < d; j++) {
+        per_col[j] = cs->offsets[(j + 1) * cs->num_blocks] - cs->offsets[j * cs->num_blocks];
+    }
+    printf("Compressed [%zu x %zu]: %zu -> %zu bytes (quarter-tick %.2f, cents %.2f, flat %.2f B/value)\n",
+           n, d, n * d * sizeof(double), cs->num_bytes,
+           (double)per_col[0] / (double)n, (double)per_col[1] / (double)n,
+           (double)per_col[2] / (double)n);
+    CHECK(per_col[0] * 3 < n * sizeof(double), "quarter-tick column compresses 3x");
+    CHECK(per_col[2] < 2 * n, "flat column compresses to ~1 byte/value");
+    CHECK(cs->num_bytes < n * d * sizeof(double), "smaller than float64");
+
+    // 4) Fused kernels match the dense tensor
+    CHECK(fabs(tensor_sum(C) - tensor_sum(X)) <= 1e-9 * fabs(tensor_sum(X)), "sum");
+    Tensor *pd = linear_forward(X, W, b);
+    Tensor *pc = linear_forward(C, W, b);
+    Tensor *md = tensor_matmul(X, W);
+    Tensor *mc = tensor_matmul(C, W);
+    CHECK(pd && pc && md && mc && pc->shape[0] == n && pc->shape[1] == 1, "forward");
+    for (size_t i = 0; i < n; i++) {
+        CHECK(tensor_read_at_offset(pc, i) == tensor_read_at_offset(pd, i), "linear_forward bit-identical");
+        CHECK(tensor_read_at_offset(mc, i) == tensor_read_at_offset(md, i), "matmul bit-identical");
+    }
+    Tensor *W2 = tensor_create(2, (size_t[]){d, 2}, TENSOR_FLOAT64);
+    CHECK(W2, "create");
+    for (size_t i = 0; i < W2->num_elems; i++) tensor_write_at_offset(W2, i, (double)i - 2.5);
+    Tensor *m2d = tensor_matmul(X, W2);
+    Tensor *m2c = tensor_matmul(C, W2);
+    CHECK(m2d && m2c, "matmul N=2");
+    for (size_t i = 0; i < m2d->num_elems; i++) {
+        CHECK(tensor_read_at_offset(m2c, i) == tensor_read_at_offset(m2d, i), "matmul N=2 values");
+    }
+
+    // 5) Training on compressed X takes exactly the dense steps
+    TrainConfig cfg = train_default_config();
+    cfg.optim.type = OPTIM_ADAM;
+    cfg.optim.lr = 0.05;
+    cfg.max_epochs = 50;
+    Tensor *Wd = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *bd = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    Tensor *Wc = tensor_create(2, (size_t[]){d, 1}, TENSOR_FLOAT64);
+    Tensor *bc = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    CHECK(Wd && bd && Wc && bc, "create");
+    TrainResult rd, rc;
+    CHECK(train_linear_regression_ex(X, y, Wd, bd, &cfg, &rd) == 0, "train dense");
+    CHECK(train_linear_regression_ex(C, y, Wc, bc, &cfg, &rc) == 0, "train compressed");
+    CHECK(rd.final_loss == rc.final_loss && rd.epochs_run == rc.epochs_run, "same losses");
+    for (size_t j = 0; j < d; j++) {
+        CHECK(tensor_read_at_offset(Wc, j) == tensor_read_at_offset(Wd, j), "same weights");
+    }
+    CHECK(tensor_read_at_offset(bc, 0) == tensor_read_at_offset(bd, 0), "same bias");
+
+    // Only X may be compressed; element access and strided-only modules refuse it
+    Tensor *yc = tensor_compress(y);
+    Scaler *xs = scaler_create(SCALER_ZSCORE, d);
+    OnlineRLS *rls = rls_create(d, 1.0, 100.0);
+    RollingConfig roll = rolling_default_config(16);
+    CHECK(yc && xs && rls, "create");
+    CHECK(train_linear_regression_ex(X, yc, Wc, bc, &cfg, &rc) == -1, "trainer rejects compressed y");
+    CHECK(tensor_get(C, (size_t[]){1, 1}) == 0.0, "tensor_get rejects compressed");
+    tensor_set(C, (size_t[]){1, 1}, 1.0);
+    CHECK(scaler_fit(xs, C) == -1 && scaler_transform(xs, C) == -1, "scaler rejects compressed");
+    CHECK(rls_update_batch(rls, C, y) == -1 && rls_update_batch(rls, X, yc) == -1,
+          "rls rejects compressed");
+    CHECK(rolling_regression(C, y, &roll) == NULL && rolling_regression(X, yc, &roll) == NULL,
+          "rolling rejects compressed");
+    rls_free(rls);
+    scaler_free(xs);
+    tensor_free(yc);
+
+    // 6) Scan throughput on a long quarter-tick series, [n, 4]
+    size_t big = 1u << 19, bd4 = 4;
+    Tensor *P = tensor_create(2, (size_t[]){big, bd4}, TENSOR_FLOAT64);
+    Tensor *v = tensor_create(2, (size_t[]){bd4, 1}, TENSOR_FLOAT64);
+    CHECK(P && v, "create");
+    double px[4] = { 4000.0, 4000.0, 4000.0, 4000.0 };
+    for (size_t i = 0; i < big; i++) {
+        for (size_t j = 0; j < bd4; j++) {
+            state = state * 1103515245u + 12345u;
+            px[j] += 0.25 * (double)((int)((state >> 16) % 3) - 1);
+            tensor_write_at_offset(P, i * bd4 + j, px[j]);
+        }
+    }
+    for (size_t j = 0; j < bd4; j++) tensor_write_at_offset(v, j, 0.25);
+    Tensor *PC = tensor_compress(P);
+    CHECK(PC, "compress big");
+    struct timespec t0, t1, t2, t3, t4;
+    timespec_get(&t0, TIME_UTC);
+    Tensor *gd = tensor_gemv(P, v, 0.0);
+    timespec_get(&t1, TIME_UTC);
+    Tensor *gc = tensor_gemv(PC, v, 0.0);
+    timespec_get(&t2, TIME_UTC);
+    double sd = tensor_sum(P);
+    timespec_get(&t3, TIME_UTC);
+    double sc = tensor_sum(PC);
+    timespec_get(&t4, TIME_UTC);
+    CHECK(gd && gc, "gemv big");
+    CHECK(memcmp(gd->data, gc->data, big * sizeof(double)) == 0, "big gemv bit-identical");
+    CHECK(fabs(sd - sc) <= 1e-12 * fabs(sd), "big sum");
+#define MS(a, b) (1e3 * (double)((b).tv_sec - (a).tv_sec) + 1e-6 * (double)((b).tv_nsec - (a).tv_nsec))
+    printf("Compressed scan [%zu x %zu] (%.1fx smaller): gemv %.2f ms dense / %.2f ms compressed, "
+           "sum %.2f / %.2f ms\n", big, bd4,
+           (double)(big * bd4 * sizeof(double)) / (double)tensor_compressed(PC)->num_bytes,
+           MS(t0, t1), MS(t1, t2), MS(t2, t3), MS(t3, t4));
+#undef MS
+
+    tensor_free(gc);
+    tensor_free(gd);
+    tensor_free(PC);
+    tensor_free(v);
+    tensor_free(P);
+    tensor_free(bc);
+    tensor_free(Wc);
+    tensor_free(bd);
+    tensor_free(Wd);
+    tensor_free(m2c);
+    tensor_free(m2d);
+    tensor_free(W2);
+    tensor_free(mc);
+    tensor_free(md);
+    tensor_free(pc);
+    tensor_free(pd);
+    tensor_free(D1);
+    tensor_free(C1);
+    tensor_free(flat);
+    tensor_free(D);
+    tensor_free(C);
+    tensor_free(b);
+    tensor_free(W);
+    tensor_free(y);
+    tensor_free(X);
+    return 0;
+}
+
+int test_cpu_dispatch(void)
+{
+    // 1) Detection and the ML_CPU_LEVEL override
+    CpuLevel detected = cpu_detected_level();
+    CpuLevel start = cpu_active_level();
+    CHECK(start <= detected, "active level within detected");
+    const char *env = getenv("ML_CPU_LEVEL");
+    if (env && strcmp(env, "scalar") == 0) {
+        CHECK(start == CPU_LEVEL_SCALAR, "ML_CPU_LEVEL=scalar honored");
+    }
+    CHECK(strcmp(cpu_level_name(CPU_LEVEL_AVX2), "avx2") == 0, "level names");
+    if (detected + 1 < CPU_LEVEL_COUNT) {
+        CHECK(cpu_set_level((CpuLevel)(detected + 1)) == -1, "unsupported level rejected");
+        CHECK(cpu_active_level() == start, "rejected switch keeps the level");
+    }
+    printf("CPU dispatch: detected %s, active %s\n",
+           cpu_level_name(detected), cpu_level_name(start));
+
+    // 2) Inputs with odd sizes so every vector tail runs
+    size_t n = 1003, M = 37, K = 45, N = 29;
+    Tensor *a = tensor_create(1, (size_t[]){n}, TENSOR_FLOAT64);
+    Tensor *b = tensor_create(1, (size_t[]){n}, TENSOR_FLOAT64);
+    Tensor *s = tensor_create(1, (size_t[]){1}, TENSOR_FLOAT64);
+    Tensor *f = tensor_create(1, (size_t[]){n}, TENSOR_FLOAT32);
+    Tensor *A = tensor_create(2, (size_t[]){M, K}, TENSOR_FLOAT64);
+    Tensor *B = tensor_create(2, (size_t[]){K, N}, TENSOR_FLOAT64);
+    CHECK(a && b && s && f && A && B, "create");
+    unsigned int state = 5u;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1103515245u + 12345u;
+        tensor_write_at_offset(a, i, (double)(state >> 8) * 1e-5 - 50.0);
+        tensor_write_at_offset(b, i, 1.0 + (double)(i % 11) * 0.37);
+        tensor_write_at_offset(f, i, (double)(state >> 12) * 1e-4 - 10.0);
+    }
+    tensor_write_at_offset(s, 0, 3.25);
+    for (size_t i = 0; i < A->num_elems; i++) tensor_write_at_offset(A, i, (double)(i % 17) * 0.1 - 0.8);
+    for (size_t i = 0; i < B->num_elems; i++) tensor_write_at_offset(B, i, (double)(i % 13) * 0.3 - 1.7);
+
+    // 3) Every level the machine has gives the scalar level's exact bits
+    double ref_sum = 0.0, ref_dot = 0.0;
+    Tensor *ref_div = NULL, *ref_add = NULL, *ref_mm = NULL, *ref_ex = NULL;
+    for (int lv = 0; lv <= (int)detected; lv++) {
+        CHECK(cpu_set_level((CpuLevel)lv) == 0, "set level");
+        CHECK(cpu_active_level() == (CpuLevel)lv, "active level");
+        Tensor *dv = tensor_div(a, b);
+        Tensor *ad = tensor_add(a, s);
+        Tensor *mm = tensor_matmul(A, B);
+        Tensor *ex = tensor_unary(f, TENSOR_OP_TANH);
+        double sm = tensor_sum(a);
+        double dt = tensor_dot(a, b);
+        CHECK(dv && ad && mm && ex && ex->dtype == TENSOR_FLOAT32, "ops");
+        CHECK(cpu_kernel_ran(CPU_KERNEL_BINARY) == lv && cpu_kernel_ran(CPU_KERNEL_SUM) == lv &&
+              cpu_kernel_ran(CPU_KERNEL_DOT) == lv && cpu_kernel_ran(CPU_KERNEL_GEMM) == lv &&
+              cpu_kernel_ran(CPU_KERNEL_CONVERT) == lv, "variant that ran is reported");
+        if (lv == 0) {
+            ref_div = dv; ref_add = ad; ref_mm = mm; ref_ex = ex;
+            ref_sum = sm; ref_dot = dt;
+            // Scalar level against the element-wise definitions
+            double seq = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                double x = tensor_read_at_offset(a, i), y = tensor_read_at_offset(b, i);
+                CHECK(tensor_read_at_offset(dv, i) == x / y, "div");
+                CHECK(tensor_read_at_offset(ad, i) == x + 3.25, "add scalar");
+                CHECK(tensor_read_at_offset(ex, i) ==
+                      (double)(float)tanh(tensor_read_at_offset(f, i)) ||
+                      fabs(tensor_read_at_offset(ex, i) - tanh(tensor_read_at_offset(f, i))) < 1e-6,
+                      "float32 tanh");
+                seq += x;
+            }
+            CHECK(fabs(sm - seq) <= 1e-12 * fabs(seq) + 1e-9, "sum");
+            for (size_t i = 0; i < M; i++) {
+                for (size_t j = 0; j < N; j++) {
+                    double r = 0.0;
+                    for (size_t k = 0; k < K; k++) {
+                        r += tensor_read_at_offset(A, i * K + k) * tensor_read_at_offset(B, k * N + j);
+                    }
+                    CHECK(tensor_read_at_offset(mm, i * N + j) == r, "gemm matches the naive loop");
+                }
+            }
+            continue;
+        }
+        CHECK(sm == ref_sum && dt == ref_dot, "reductions bit-identical across levels");
+        CHECK(memcmp(dv->data, ref_div->data, n * sizeof(double)) == 0, "div bit-identical");
+        CHECK(memcmp(ad->data, ref_add->data, n * sizeof(double)) == 0, "add bit-identical");
+        CHECK(memcmp(mm->data, ref_mm->data, M * N * sizeof(double)) == 0, "gemm bit-identical");
+        CHECK(memcmp(ex->data, ref_ex->data, n * sizeof(float)) == 0, "convert bit-identical");
+        tensor_free(ex);
+        tensor_free(mm);
+        tensor_free(ad);
+        tensor_free(dv);
+    }
+
+    // 4) Throughput per level: sum over 4M doubles, [256 x 256] matmul
+    size_t big = 1u << 22, G = 256;
+    Tensor *v = tensor_create(1, (size_t[]){big}, TENSOR_FLOAT64);
+    Tensor *P = tensor_create(2, (size_t[]){G, G}, TENSOR_FLOAT64);
+    CHECK(v && P, "create");
+    for (size_t i = 0; i < big; i++) tensor_write_at_offset(v, i, (double)(i % 1000) * 1e-3);
+    for (size_t i = 0; i < P->num_elems; i++) tensor_write_at_offset(P, i, (double)(i % 7) - 3.0);
+    for (int lv = 0; lv <= (int)detected; lv++) {
+        cpu_set_level((CpuLevel)lv);
+        struct timespec t0, t1, t2;
+        timespec_get(&t0, TIME_UTC);
+        double sv = tensor_sum(v);
+        timespec_get(&t1, TIME_UTC);
+        Tensor *pp = tensor_matmul(P, P);
+        timespec_get(&t2, TIME_UTC);
+        CHECK(pp && sv > 0.0, "bench ops");
+        printf("  %-7s sum [%zu] %.2f ms, matmul [%zu x %zu] %.2f ms\n", cpu_level_name((CpuLevel)lv),
+               big, 1e3 * (double)(t1.tv_sec - t0.tv_sec) + 1e-6 * (double)(t1.tv_nsec - t0.tv_nsec),
+               G, G, 1e3 * (double)(t2.tv_sec - t1.tv_sec) + 1e-6 * (double)(t2.tv_nsec - t1.tv_nsec));
+        tensor_free(pp);
+    }
+    cpu_set_level(start);
+
+    tensor_free(P);
+    tensor_free(v);
+    tensor_free(ref_ex);
+    tensor_free(ref_mm);
+    tensor_free(ref_add);
+    tensor_free(ref_div);
+    tensor_free(B);
+    tensor_free(A);
+    tensor_free(f);
+    tensor_free(s);
+    tensor_free(b);
+    tensor_free(a);
+    return 0;
+}
+
+int test_random_tensors(void)
+{
+    // 1) Known-answer block (Random123 kat_vectors, philox4x32_10, zeros)
+    uint32_t blk[4];
+    tensor_rng_block(0, 0, blk);
+    CHECK(blk[0] == 0x6627e8d5u && blk[1] == 0xe169c58du &&
+          blk[2] == 0xbc57ac4cu && blk[3] == 0x9b00dbd8u, "philox4x32-10 known answer");
+
+    // 2) Same values for 1 or 4 threads, and for one fill or two halves
+    size_t n = 300000;
+    Tensor *u1 = tensor_empty(1, (size_t[]){n}, TENSOR_FLOAT64);
+    Tensor *u4 = tensor_empty(1, (size_t[]){n}, TENSOR_FLOAT64);
+    Tensor *uh = tensor_empty(1, (size_t[]){n}, TENSOR_FLOAT64);
+    CHECK(u1 && u4 && uh, "create");
+    TensorRng r1 = tensor_rng(42), r4 = tensor_rng(42), rh = tensor_rng(42);
+    parallel_set_num_threads(1);
+    CHECK(tensor_rand_uniform(u1, -2.0, 3.0, &r1) == 0, "uniform 1 thread");
+    parallel_set_num_threads(4);
+    CHECK(tensor_rand_uniform(u4, -2.0, 3.0, &r4) == 0, "uniform 4 threads");
+    parallel_set_num_threads(0);
+    CHECK(memcmp(u1->data, u4->data, n * sizeof(double)) == 0, "thread count does not matter");
+    CHECK(r1.counter == n / 2 && r4.counter == r1.counter, "counter advanced");
+    Tensor *lo = tensor_slice(uh, (size_t[]){0}, (size_t[]){n / 2});
+    Tensor *hi = tensor_slice(uh, (size_t[]){n / 2}, (size_t[]){n});
+    CHECK(lo && hi, "slices");
+    CHECK(tensor_rand_uniform(lo, -2.0, 3.0, &rh) == 0 && tensor_rand_uniform(hi, -2.0, 3.0, &rh) == 0,
+          "uniform halves");
+    CHECK(memcmp(u1->data, uh->data, n * sizeof(double)) == 0, "halves continue the stream");
+
+    double mn = 1e300, mx = -1e300, mean = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double x = tensor_read_at_offset(u1, i);
+        mn = fmin(mn, x);
+        mx = fmax(mx, x);
+        mean += x;
+    }
+    mean /= (double)n;
+    CHECK(mn >= -2.0 && mx < 3.0 && mn < -1.99 && mx > 2.99, "uniform range");
+    CHECK(fabs(mean - 0.5) < 0.02, "uniform mean");
+
+    // 3) Normal moments; a second fill continues with fresh values
+    Tensor *g = tensor_empty(1, (size_t[]){n}, TENSOR_FLOAT64);
+    CHECK(g, "create");
+    TensorRng rg = tensor_rng(7);
+    CHECK(tensor_randn(g, 1.5, 2.0, &rg) == 0, "randn");
+    double m1 = 0.0, m2 = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double x = tensor_read_at_offset(g, i);
+        CHECK(isfinite(x), "finite normals");
+        m1 += x;
+        m2 += x * x;
+    }
+    m1 /= (double)n;
+    double sd = sqrt(m2 / (double)n - m1 * m1);
+    CHECK(fabs(m1 - 1.5) < 0.02 && fabs(sd - 2.0) < 0.02, "normal mean and std");
+
+    // 4) Strided float32 views are filled in logical order
+    Tensor *base = tensor_create(2, (size_t[]){3, 5}, TENSOR_FLOAT32);
+    Tensor *ref = tensor_empty(2, (size_t[]){5, 3}, TENSOR_FLOAT64);
+    CHECK(base && ref, "create");
+    Tensor *view = tensor_transpose(base);   // [5, 3], not contiguous
+    TensorRng rv = tensor_rng(9), rr = tensor_rng(9);
+    CHECK(view && tensor_randn(view, 0.0, 1.0, &rv) == 0 && tensor_randn(ref, 0.0, 1.0, &rr) == 0,
+          "strided fill");
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            double want = (double)(float)tensor_read_at_offset(ref, i * 3 + j);
+            CHECK(tensor_get(view, (size_t[]){i, j}) == want, "logical order");
+        }
+    }
+
+    // 5) Permutations: every index once, reproducible, seed-dependent
+    size_t pn = 1001;
+    Tensor *p = tensor_empty(1, (size_t[]){pn}, TENSOR_INT32);
+    Tensor *q = tensor_empty(1, (size_t[]){pn}, TENSOR_INT32);
+    unsigned char *seen = (unsigned char*)calloc(pn, 1);
+    CHECK(p && q && seen, "create");
+    TensorRng rp = tensor_rng(3), rq = tensor_rng(3);
+    CHECK(tensor_randperm(p, &rp) == 0 && tensor_randperm(q, &rq) == 0, "randperm");
+    CHECK(memcmp(p->data, q->data, pn * sizeof(int)) == 0, "randperm reproducible");
+    size_t fixed = 0;
+    for (size_t i = 0; i < pn; i++) {
+        int v = ((int*)p->data)[i];
+        CHECK(v >= 0 && (size_t)v < pn && !seen[v], "each index once");
+        seen[v] = 1;
+        fixed += ((size_t)v == i);
+    }
+    CHECK(fixed < 10, "shuffled");
+    CHECK(tensor_randperm(q, &rq) == 0 && memcmp(p->data, q->data, pn * sizeof(int)) != 0,
+          "next permutation differs");
+
+    // 6) Throughput, 4M float64
+    size_t big = 1u << 22;
+    Tensor *b = tensor_create(1, (size_t[]){big}, TENSOR_FLOAT64);
+    CHECK(b, "create");
+    TensorRng rb = tensor_rng(1);
+    struct timespec t0, t1, t2, t3;
+    timespec_get(&t0, TIME_UTC);
+    tensor_rand_uniform(b, 0.0, 1.0, &rb);
+    timespec_get(&t1, TIME_UTC);
+    tensor_randn(b, 0.0, 1.0, &rb);
+    timespec_get(&t2, TIME_UTC);
+    Tensor *bp = tensor_empty(1, (size_t[]){big}, TENSOR_INT32);
+    CHECK(bp && tensor_randperm(bp, &rb) == 0, "big randperm");
+    timespec_get(&t3, TIME_UTC);
+#define NS_PER(a, b) ((1e9 * (double)((b).tv_sec - (a).tv_sec) + (double)((b).tv_nsec - (a).tv_nsec)) / (double)big)
+    printf("RNG [%zu]: uniform %.2f ns/elem, randn %.2f ns/elem, randperm %.2f ns/elem\n",
+           big, NS_PER(t0, t1), NS_PER(t1, t2), NS_PER(t2, t3));
+#undef NS_PER
+
+    tensor_free(bp);
+    tensor_free(b);
+    free(seen);
+    tensor_free(q);
+    tensor_free(p);
+    tensor_free(view);
+    tensor_free(ref);
+    tensor_free(base);
+    tensor_free(g);
+    tensor_free(hi);
+    tensor_free(lo);
+    tensor_free(uh);
+    tensor_free(u4);
+    tensor_free(u1);
+    return 0;
+}
+
+int test_gather_scatter(void)
+{
+    // 1) Shuffled gather with an int32 permutation
+    size_t n = 1000, d = 7;
+    Tensor *X = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    Tensor *perm = tensor_empty(1, (size_t[]){n}, TENSOR_INT32);
+    CHECK(X && perm, "create");
+    for (size_t i = 0; i < X->num_elems; i++) tensor_write_at_offset(X, i, (double)i);
+    TensorRng rng = tensor_rng(5);
+    CHECK(tensor_randperm(perm, &rng) == 0, "randperm");
+    Tensor *Xs = tensor_index_select(X, perm);
+    CHECK(Xs && Xs->shape[0] == n && Xs->shape[1] == d && Xs->data != X->data, "gather");
+    for (size_t k = 0; k < n; k++) {
+        size_t r = (size_t)((int*)perm->data)[k];
+        for (size_t j = 0; j < d; j++) {
+            CHECK(tensor_read_at_offset(Xs, k * d + j) == (double)(r * d + j), "gathered rows");
+        }
+    }
+
+    // 2) Mini-batches into one reusable buffer, indices from a strided view
+    Tensor *batch = tensor_empty(2, (size_t[]){64, d}, TENSOR_FLOAT64);
+    CHECK(batch, "create");
+    for (size_t b0 = 0; b0 + 64 <= n; b0 += 64) {
+        Tensor *ib = tensor_slice(perm, (size_t[]){b0}, (size_t[]){b0 + 64});
+        CHECK(ib && tensor_index_select_out(X, ib, batch) == 0, "batch gather");
+        for (size_t k = 0; k < 64; k++) {
+            CHECK(memcmp((double*)batch->data + k * d, (double*)Xs->data + (b0 + k) * d,
+                         d * sizeof(double)) == 0, "batch rows");
+        }
+        tensor_free(ib);
+    }
+
+    // 3) Contiguous range: a view, no copy; out of range is rejected
+    Tensor *rng_idx = tensor_empty(1, (size_t[]){5}, TENSOR_FLOAT64);
+    CHECK(rng_idx, "create");
+    for (size_t k = 0; k < 5; k++) tensor_write_at_offset(rng_idx, k, (double)(100 + k));
+    Tensor *view = tensor_index_select(X, rng_idx);
+    CHECK(view && view->data == (double*)X->data + 100 * d && view->shape[0] == 5, "zero-copy range");
+    tensor_write_at_offset(rng_idx, 4, (double)n);
+    CHECK(tensor_index_select(X, rng_idx) == NULL, "index out of range");
+    CHECK(tensor_index_select_out(X, rng_idx, batch) == -1, "out shape mismatch");
+
+    // 4) Strided source into float32: the element path
+    Tensor *Xt = tensor_transpose(X);                     // [d, n]
+    Tensor *cols = tensor_empty(1, (size_t[]){3}, TENSOR_INT32);
+    Tensor *o32 = tensor_empty(2, (size_t[]){3, n}, TENSOR_FLOAT32);
+    CHECK(Xt && cols && o32, "create");
+    int pick[3] = { 6, 0, 6 };
+    memcpy(cols->data, pick, sizeof(pick));
+    CHECK(tensor_index_select_out(Xt, cols, o32) == 0, "strided gather");
+    for (size_t k = 0; k < 3; k++) {
+        for (size_t i = 0; i < n; i += 97) {
+            CHECK(tensor_get(o32, (size_t[]){k, i}) == (double)(float)(i * d + (size_t)pick[k]),
+                  "strided values");
+        }
+    }
+
+    // 5) Scatter-add: duplicates accumulate; scattering Xs back rebuilds X
+    Tensor *acc = tensor_create(2, (size_t[]){n, d}, TENSOR_FLOAT64);
+    CHECK(acc && tensor_scatter_add(acc, perm, Xs) == 0, "scatter back");
+    CHECK(memcmp(acc->data, X->data, n * d * sizeof(double)) == 0, "scatter inverts gather");
+    Tensor *small = tensor_create(2, (size_t[]){4, 3}, TENSOR_FLOAT32);
+    Tensor *upd = tensor_create(2, (size_t[]){3, 3}, TENSOR_FLOAT64);
+    Tensor *dup = tensor_empty(1, (size_t[]){3}, TENSOR_INT32);
+    CHECK(small && upd && dup, "create");
+    int dix[3] = { 2, 0, 2 };
+    memcpy(dup->data, dix, sizeof(dix));
+    for (size_t i = 0; i < 9; i++) tensor_write_at_offset(upd, i, (double)(i + 1));
+    CHECK(tensor_scatter_add(small, dup, upd) == 0, "scatter duplicates");
+    CHECK(tensor_get(small, (size_t[]){2, 1}) == 2.0 + 8.0 && tensor_get(small, (size_t[]){0, 2}) == 6.0 &&
+          tensor_get(small, (size_t[]){1, 0}) == 0.0, "scatter values");
+
+    // 6) Concat and stack, including a non-contiguous input
+    Tensor *A = tensor_create(2, (size_t[]){2, 3}, TENSOR_FLOAT64);
+    Tensor *B = tensor_create(2, (size_t[]){3, 2}, TENSOR_FLOAT64);
+    CHECK(A && B, "create");
+    for (size_t i = 0; i < 6; i++) {
+        tensor_write_at_offset(A, i, (double)i);
+        tensor_write_at_offset(B, i, (double)(10 + i));
+    }
+    Tensor *Bt = tensor_transpose(B);                     // [2, 3], strided
+    const Tensor *pair[2] = { A, Bt };
+    Tensor *c0 = tensor_concat(pair, 2, 0);
+    Tensor *c1 = tensor_concat(pair, 2, 1);
+    Tensor *s0 = tensor_stack(pair, 2, 0);
+    Tensor *s2 = tensor_stack(pair, 2, 2);
+    CHECK(c0 && c0->shape[0] == 4 && c0->shape[1] == 3, "concat dim 0");
+    CHECK(c1 && c1->shape[0] == 2 && c1->shape[1] == 6, "concat dim 1");
+    CHECK(s0 && s0->ndim == 3 && s0->shape[0] == 2 && s0->shape[1] == 2 && s0->shape[2] == 3, "stack dim 0");
+    CHECK(s2 && s2->ndim == 3 && s2->shape[0] == 2 && s2->shape[1] == 3 && s2->shape[2] == 2, "stack dim 2");
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            double a = tensor_get(A, (size_t[]){i, j}), b = tensor_get(Bt, (size_t[]){i, j});
+            CHECK(tensor_get(c0, (size_t[]){i, j}) == a && tensor_get(c0, (size_t[]){2 + i, j}) == b, "c0");
+            CHECK(tensor_get(c1, (size_t[]){i, j}) == a && tensor_get(c1, (size_t[]){i, 3 + j}) == b, "c1");
+            CHECK(tensor_get(s0, (size_t[]){0, i, j}) == a && tensor_get(s0, (size_t[]){1, i, j}) == b, "s0");
+            CHECK(tensor_get(s2, (size_t[]){i, j, 0}) == a && tensor_get(s2, (size_t[]){i, j, 1}) == b, "s2");
+        }
+    }
+    const Tensor *bad[2] = { A, B };
+    CHECK(tensor_concat(bad, 2, 1) == NULL && tensor_stack(bad, 2, 0) == NULL, "mismatch rejected");
+
+    // 7) Throughput: shuffled epoch of [n, 16] rows vs a tensor_get/tensor_set loop
+    size_t big = 1u << 18, w = 16;
+    Tensor *P = tensor_create(2, (size_t[]){big, w}, TENSOR_FLOAT64);
+    Tensor *bp = tensor_empty(1, (size_t[]){big}, TENSOR_INT32);
+    Tensor *ref = tensor_create(2, (size_t[]){big, w}, TENSOR_FLOAT64);
+    CHECK(P && bp && ref, "create");
+    CHECK(tensor_rand_uniform(P, 0.0, 1.0, &rng) == 0 && tensor_randperm(bp, &rng) == 0, "fill");
+    struct timespec t0, t1, t2;
+    timespec_get(&t0, TIME_UTC);
+    for (size_t k = 0; k < big; k++) {
+        size_t r = (size_t)((int*)bp->data)[k];
+        for (size_t j = 0; j < w; j++) {
+            tensor_set(ref, (size_t[]){k, j}, tensor_get(P, (size_t[]){r, j}));
+        }
+    }
+    timespec_get(&t1, TIME_UTC);
+    Tensor *g = tensor_index_select(P, bp);
+    timespec_get(&t2, TIME_UTC);
+    CHECK(g && memcmp(g->data, ref->data, big * w * sizeof(double)) == 0, "big gather");
+    printf("Gather [%zu x %zu] shuffled: get/set loop %.2f ms, index_select %.2f ms\n", big, w,
+           1e3 * (double)(t1.tv_sec - t0.tv_sec) + 1e-6 * (double)(t1.tv_nsec - t0.tv_nsec),
+           1e3 * (double)(t2.tv_sec - t1.tv_sec) + 1e-6 * (double)(t2.tv_nsec - t1.tv_nsec));
+
+    tensor_free(g);
+    tensor_free(ref);
+    tensor_free(bp);
+    tensor_free(P);
+    tensor_free(s2);
+    tensor_free(s0);
+    tensor_free(c1);
+    tensor_free(c0);
+    tensor_free(Bt);
+    tensor_free(B);
+    tensor_free(A);
+    tensor_free(dup);
+    tensor_free(upd);
+    tensor_free(small);
+    tensor_free(acc);
+    tensor_free(o32);
+    tensor_free(cols);
+    tensor_free(Xt);
+    tensor_free(view);
+    tensor_free(rng_idx);
+    tensor_free(batch);
+    tensor_free(Xs);
+    tensor_free(perm);
+    tensor_free(X);
+    return 0;
+}